@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+// CRC32C (Castagnoli) 校验
+// 首次调用时按CPU能力选择实现：x86 SSE4.2 / ARMv8 CRC 指令，否则使用查表实现
+// 可分段计算：crc32c(crc32c(0, a, n), b, m) == crc32c(0, a+b, n+m)
+uint32_t crc32c(uint32_t crc, const void* data, size_t size);
+
+// 当前使用的实现名称："sse4.2" / "armv8" / "software"
+const char* crc32cImplementation();
+
+} // namespace hybrid_comm
+} // namespace edge_infra
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "pzmq_data.h"
 #include <zmq.h>
+#include <sys/uio.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -10,10 +13,19 @@
 #include <mutex>
 
 namespace edge_infra {
+namespace metrics {
+class Counter;
+class Histogram;
+} // namespace metrics
+
 namespace hybrid_comm {
 
 // ZeroMQ消息封装
 class ZmqMessage {
+public:
+    // 小于该大小时直接拷贝，避免零拷贝额外的堆分配开销
+    static const size_t kZeroCopyThreshold = 1024;
+    
 private:
     zmq_msg_t msg_;
     bool initialized_;
@@ -23,6 +35,19 @@ public:
     explicit ZmqMessage(size_t size);
     explicit ZmqMessage(const std::string& data);
     explicit ZmqMessage(const void* data, size_t size);
+    
+    // 零拷贝：直接引用调用方的缓冲区，消息释放时调用ffn(data, hint)归还
+    // 注意ffn可能在ZeroMQ的IO线程中被调用；ffn为nullptr时调用方需保证
+    // 缓冲区在消息发送完成前一直有效
+    ZmqMessage(void* data, size_t size, zmq_free_fn* ffn, void* hint = nullptr);
+    
+    // 零拷贝：接管容器的内存（小消息仍然拷贝）
+    explicit ZmqMessage(std::string&& data);
+    explicit ZmqMessage(std::vector<uint8_t>&& data);
+    explicit ZmqMessage(SerializedData&& data);
+    // 池化缓冲区由ZeroMQ持有，消息释放时归还BufferPool
+    explicit ZmqMessage(PooledBuffer&& buffer);
+    
     ~ZmqMessage();
     
     // 禁用拷贝，允许移动
@@ -36,6 +61,11 @@ public:
     const void* data() const { return zmq_msg_data(const_cast<zmq_msg_t*>(&msg_)); }
     size_t size() const { return zmq_msg_size(const_cast<zmq_msg_t*>(&msg_)); }
     
+    // 只读视图，在消息生命周期内有效，不产生拷贝
+    std::string_view view() const { 
+        return std::string_view(static_cast<const char*>(data()), size()); 
+    }
+    
     // 字符串转换
     std::string toString() const;
     void fromString(const std::string& str);
@@ -94,12 +124,19 @@ private:
     std::string endpoint_;
     bool connected_;
     
-    // 调试和统计
+    // 调试和统计：只由使用套接字的线程写入（ZeroMQ套接字本身不可并发使用），其他线程只读
     std::atomic<uint64_t> messages_sent_;
     std::atomic<uint64_t> messages_received_;
     std::atomic<uint64_t> bytes_sent_;
     std::atomic<uint64_t> bytes_received_;
     
+    // 按套接字类型汇总到全局MetricsRegistry
+    metrics::Counter* messages_sent_metric_;
+    metrics::Counter* messages_received_metric_;
+    metrics::Counter* bytes_sent_metric_;
+    metrics::Counter* bytes_received_metric_;
+    metrics::Histogram* latency_metric_;   // recvMessage时按MessageHeader::timestamp计算的发送到接收延迟
+    
 public:
     explicit ZmqSocket(SocketType type);
     ~ZmqSocket();
@@ -119,6 +156,11 @@ public:
     bool send(const std::string& data, int flags = 0);
     bool send(const void* data, size_t size, int flags = 0);
     
+    // 零拷贝发送：成功后msg被清空，失败时msg保持不变
+    bool send(ZmqMessage&& msg, int flags = 0);
+    bool send(std::string&& data, int flags = 0);
+    
+    // 接收后可通过msg.view()直接访问数据，无需toString()拷贝
     bool recv(ZmqMessage& msg, int flags = 0);
     bool recv(std::string& data, int flags = 0);
     
@@ -127,6 +169,25 @@ public:
     bool sendMore(const std::string& data);
     bool hasMore() const;
     
+    // 分散/聚集发送：每个iovec作为一帧，整体构成一条多部分消息
+    bool sendv(const struct iovec* iov, size_t iovcnt, int flags = 0);
+    // 零拷贝多帧发送，成功后frames中的消息被清空
+    bool sendMultipart(std::vector<ZmqMessage>& frames, int flags = 0);
+    // 接收一条完整的多部分消息
+    bool recvMultipart(std::vector<ZmqMessage>& frames, int flags = 0);
+    
+    // Message收发：头部与负载分两帧传输，负载无需与头部拼接
+    // 右值版本零拷贝移交负载缓冲区。被采样时发送记录zmq.send span并把上下文写入头部，
+    // 接收记录zmq.recv子span，头部改为携带该span的上下文（见MessageHeader::extractTrace）
+    bool sendMessage(const Message& msg, int flags = 0);
+    bool sendMessage(Message&& msg, int flags = 0);
+    // 负载拷贝进Message自己的池化缓冲区（SerializedData可写可扩容，不能引用ZeroMQ持有的内存）。
+    // 接收时校验CRC32C，只有本端是可信传输时才采信对端的kFlagNoChecksum
+    bool recvMessage(Message& msg, int flags = 0);
+    // 零拷贝接收：负载留在payload中由ZeroMQ持有，通过payload.view()读取，无负载时payload为空。
+    // 与recvMessage(Message&)一样检查头部、长度和校验和
+    bool recvMessage(MessageHeader& header, ZmqMessage& payload, int flags = 0);
+    
     // Socket选项
     bool setSockOpt(int option, const void* optval, size_t optvallen);
     bool getSockOpt(int option, void* optval, size_t* optvallen);
@@ -143,6 +204,9 @@ public:
     bool isConnected() const { return connected_; }
     SocketType getType() const { return type_; }
     const std::string& getEndpoint() const { return endpoint_; }
+    void* handle() const { return socket_; }
+    // ipc:// 与 inproc:// 为本机可信传输：sendMessage标记消息免校验，recvMessage据此决定是否采信该标记
+    bool isTrustedTransport() const;
     
     // 统计信息
     uint64_t getMessagesSent() const { return messages_sent_.load(); }
@@ -157,6 +221,10 @@ public:
 private:
     void updateSendStats(size_t bytes);
     void updateRecvStats(size_t bytes);
+    void recordLatency(const MessageHeader& header);
+    
+    bool sendHeaderFrame(const Message& msg, int flags);
+    void discardRemainingFrames();
     
     bool debug_enabled_;
     void debugLog(const std::string& message) const;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+// 消息负载缓冲区池：按2的幂分级（256B ~ 1MiB），每个线程缓存少量空闲块，
+// 线程缓存满/空时与全局仓库成批交换，因此在A线程分配、B线程（例如ZeroMQ IO线程）释放也能复用。
+// 超过kMaxClassSize的请求直接malloc/free。
+// 释放时必须传回allocate给出的capacity，用于定位所属级别
+class BufferPool {
+public:
+    static const size_t kMinClassSize = 256;
+    static const size_t kMaxClassSize = 1 << 20;
+    static const int kNumClasses = 13;
+
+    // 返回至少size字节的缓冲区，实际容量写入*capacity；size为0时返回nullptr
+    static uint8_t* allocate(size_t size, size_t* capacity);
+    static void deallocate(uint8_t* data, size_t capacity);
+
+    // 把当前线程缓存的空闲块归还全局仓库（线程退出时自动执行）
+    static void flushThreadCache();
+
+    // 走到malloc的次数，池命中率高时应基本不增长
+    static uint64_t getHeapAllocations() { return heap_allocations_.load(std::memory_order_relaxed); }
+
+private:
+    static std::atomic<uint64_t> heap_allocations_;
+};
+
+// 可移动的池化缓冲区，析构时归还池
+class PooledBuffer {
+private:
+    uint8_t* data_;
+    size_t size_;
+    size_t capacity_;
+
+public:
+    PooledBuffer() : data_(nullptr), size_(0), capacity_(0) {}
+    PooledBuffer(uint8_t* data, size_t size, size_t capacity) : data_(data), size_(size), capacity_(capacity) {}
+    ~PooledBuffer() { BufferPool::deallocate(data_, capacity_); }
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+        other.data_ = nullptr;
+        other.size_ = other.capacity_ = 0;
+    }
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            BufferPool::deallocate(data_, capacity_);
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = nullptr;
+            other.size_ = other.capacity_ = 0;
+        }
+        return *this;
+    }
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+    // 放弃所有权，调用方之后需以capacity()调用BufferPool::deallocate
+    uint8_t* release() {
+        uint8_t* data = data_;
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+        return data;
+    }
+};
+
+} // namespace hybrid_comm
+} // namespace edge_infra
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pzmq_data.h"
+#include "network/Codec.h"
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+// TCP上的Message分帧，线格式与ZMQ通道一致：MessageHeader后紧跟payload_size字节负载，
+// 头部即长度前缀。解码时直接从输入缓冲区构造Message（负载只拷贝一次），
+// 默认校验CRC32C；TCP不是可信传输，编码总是计算校验和，解码忽略对端的kFlagNoChecksum。追踪上下文的传播与ZmqSocket相同，
+// 分别记录tcp.send/tcp.recv span
+class MessageCodec : public network::Codec<Message> {
+private:
+    bool verify_checksum_;
+
+public:
+    explicit MessageCodec(const FrameCallback& cb = FrameCallback())
+        : network::Codec<Message>(cb), verify_checksum_(true) {}
+
+    void setVerifyChecksum(bool enable) { verify_checksum_ = enable; }
+
+    DecodeResult decodeFrame(const char* data, size_t len, Message* frame,
+                             size_t* consumed, std::string* error) override;
+    // 重新计算头部的payload_size和校验和
+    void encodeFrame(const Message& frame, network::OutputQueue* out) override;
+};
+
+} // namespace hybrid_comm
+} // namespace edge_infra
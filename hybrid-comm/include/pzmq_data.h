@@ -1,6 +1,9 @@
 #pragma once
 
+#include "pzmq_buffer_pool.h"
+#include "trace.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -43,18 +46,58 @@ struct MessageHeader {
     char sender_id[32];       // 发送者ID
     char receiver_id[32];     // 接收者ID
     uint32_t flags;           // 标志位
-    uint32_t reserved[3];     // 保留字段
+    uint32_t reserved[3];     // 保留字段；带kFlagTraced时存放追踪上下文：[0..1]=trace_id，[2]=span_id
+    
+    static const uint32_t kMagic = 0x45444745;    // "EDGE"
+    static const uint32_t kVersion = 1;
+    
+    // flags位定义
+    // 负载未计算校验和；由发送端设置，接收端只在自己的传输可信（ipc://、inproc://）时采信
+    static const uint32_t kFlagNoChecksum = 1u << 0;
+    // reserved中携带追踪上下文
+    static const uint32_t kFlagTraced = 1u << 1;
     
     MessageHeader();
     void setTimestamp();
     bool isValid() const;
+    // 对payload_size字节的负载计算CRC32C
     uint32_t calculateChecksum(const void* payload) const;
+    // 校验负载。trusted_transport指接收端自己的传输是否可信，不可信时忽略对端的kFlagNoChecksum，
+    // 否则对端置一个标志位即可关闭完整性校验
+    bool verifyChecksum(const void* payload, bool trusted_transport) const;
+    
+    bool hasFlag(uint32_t flag) const { return (flags & flag) != 0; }
+    void setFlag(uint32_t flag, bool on = true) { flags = on ? (flags | flag) : (flags & ~flag); }
+    
+    // 追踪上下文，未采样的上下文不写入
+    void setTraceContext(const trace::TraceContext& ctx);
+    trace::TraceContext getTraceContext() const;
+    // 发送路径调用：当前线程有活动span时总是写入其上下文（转发的头部也改为以本跳为父）
+    void injectCurrentTrace();
+    // 发送span的父上下文：优先当前线程的活动span，其次头部已携带的上游上下文，
+    // 都没有时把本消息视为新请求，按采样率开始新追踪
+    trace::TraceContext outgoingTraceParent() const;
+    // 接收路径调用：以头部携带的上下文为父记录一个接收span，并把头部改写为该span的上下文，
+    // 处理方用getTraceContext()继续追踪时即接在接收span之下。name需为静态字符串
+    void extractTrace(const char* name);
+};
+
+// 指向SerializedData内部的只读字节区间，有效期到该对象下一次写入/扩容/析构为止
+struct ByteSpan {
+    const uint8_t* data;
+    size_t size;
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    bool empty() const { return size == 0; }
 };
 
-// 序列化数据包
+// 序列化数据包，缓冲区取自BufferPool（线程本地按大小分级缓存），析构时归还
 class SerializedData {
 private:
-    std::vector<uint8_t> buffer_;
+    uint8_t* buffer_;
+    size_t size_;
+    size_t capacity_;
     size_t read_pos_;
     
 public:
@@ -62,6 +105,14 @@ public:
     explicit SerializedData(size_t reserve_size);
     explicit SerializedData(const std::vector<uint8_t>& data);
     explicit SerializedData(const void* data, size_t size);
+    // 接管池化缓冲区（如ZmqMessage或上一条消息交出的缓冲区）
+    explicit SerializedData(PooledBuffer&& buffer);
+    ~SerializedData();
+    
+    SerializedData(const SerializedData& other);
+    SerializedData& operator=(const SerializedData& other);
+    SerializedData(SerializedData&& other) noexcept;
+    SerializedData& operator=(SerializedData&& other) noexcept;
     
     // 写入操作
     void writeUInt8(uint8_t value);
@@ -93,25 +144,32 @@ public:
     std::vector<uint8_t> readBytes(size_t size);
     bool readBool();
     
+    // 不拷贝的读取：返回指向内部缓冲区的视图，同样推进读位置
+    std::string_view readStringView();
+    ByteSpan readBytesSpan(size_t size);
+    
     // 数据访问
-    const uint8_t* data() const { return buffer_.data(); }
-    uint8_t* data() { return buffer_.data(); }
-    size_t size() const { return buffer_.size(); }
-    size_t capacity() const { return buffer_.capacity(); }
+    const uint8_t* data() const { return buffer_; }
+    uint8_t* data() { return buffer_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
     
     // 位置控制
     size_t getReadPos() const { return read_pos_; }
     void setReadPos(size_t pos) { read_pos_ = pos; }
     void resetReadPos() { read_pos_ = 0; }
-    bool hasMoreData() const { return read_pos_ < buffer_.size(); }
-    size_t remainingBytes() const { return buffer_.size() - read_pos_; }
+    bool hasMoreData() const { return read_pos_ < size_; }
+    size_t remainingBytes() const { return size_ - read_pos_; }
     
     // 缓冲区操作
     void clear();
     void reserve(size_t size);
     void resize(size_t size);
     
-    // 序列化辅助
+    // 交出底层缓冲区（用于零拷贝发送），之后本对象为空
+    PooledBuffer release();
+    
+    // 序列化辅助：按T的PZMQ_FIELDS声明生成读写，定义见pzmq_serialize.h
     template<typename T>
     void serialize(const T& obj);
     
@@ -157,18 +215,25 @@ public:
     SerializedData& getPayload() { return payload_; }
     const SerializedData& getPayload() const { return payload_; }
     
-    void setPayload(const SerializedData& data) { payload_ = data; }
+    // 只接受右值，直接接管缓冲区；需要保留原数据时由调用方显式拷贝
+    void setPayload(SerializedData&& data) { payload_ = std::move(data); header_.payload_size = static_cast<uint32_t>(payload_.size()); }
+    void setPayload(PooledBuffer&& buffer) { setPayload(SerializedData(std::move(buffer))); }
     void setPayload(const std::string& data);
     void setPayload(const void* data, size_t size);
+    // 取走负载（例如交给ZmqMessage零拷贝发送），之后负载为空
+    SerializedData takePayload();
     
     // 序列化/反序列化
     std::vector<uint8_t> serialize() const;
     bool deserialize(const std::vector<uint8_t>& data);
     bool deserialize(const void* data, size_t size);
     
-    // 验证
-    bool validate() const;
+    // 验证；trusted_transport含义同MessageHeader::verifyChecksum，默认总是校验负载
+    bool validate(bool trusted_transport = false) const;
     void updateChecksum();
+    // 关闭后updateChecksum不再计算。只在可信的本机传输上生效：不可信传输的发送端仍会计算，接收端仍会校验
+    void setChecksumEnabled(bool enable) { header_.setFlag(MessageHeader::kFlagNoChecksum, !enable); }
+    bool isChecksumEnabled() const { return !header_.hasFlag(MessageHeader::kFlagNoChecksum); }
     
     // 工具函数
     size_t getTotalSize() const;
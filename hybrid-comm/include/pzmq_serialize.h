@@ -0,0 +1,359 @@
+#pragma once
+
+#include "pzmq_data.h"
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 在结构体内按顺序声明参与序列化的字段，SerializedData::serialize/deserialize据此生成读写代码：
+//
+//   struct ConfigUpdate {
+//       uint32_t version;
+//       MessagePriority priority;
+//       std::string key;
+//       std::vector<int32_t> values;
+//       PZMQ_FIELDS(version, priority, key, values)
+//   };
+//
+//   data.serialize(update);
+//   ConfigUpdate u = data.deserialize<ConfigUpdate>();
+//
+// 支持的字段类型：算术类型、枚举、bool、std::string、std::vector、std::array以及同样声明了PZMQ_FIELDS的结构体。
+// 线上格式与逐字段调用writeUInt32/writeString等一致：数值小端，bool占1字节，string/vector前缀uint32长度
+#define PZMQ_FIELDS(...) \
+    auto pzmqFields() { return std::tie(__VA_ARGS__); } \
+    auto pzmqFields() const { return std::tie(__VA_ARGS__); }
+
+namespace edge_infra {
+namespace hybrid_comm {
+namespace serialization {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool kHostLittleEndian = false;
+#else
+constexpr bool kHostLittleEndian = true;
+#endif
+
+template<size_t N> struct UIntOfSize;
+template<> struct UIntOfSize<1> { using type = uint8_t; };
+template<> struct UIntOfSize<2> { using type = uint16_t; };
+template<> struct UIntOfSize<4> { using type = uint32_t; };
+template<> struct UIntOfSize<8> { using type = uint64_t; };
+
+inline uint8_t byteSwap(uint8_t v) { return v; }
+inline uint16_t byteSwap(uint16_t v) { return __builtin_bswap16(v); }
+inline uint32_t byteSwap(uint32_t v) { return __builtin_bswap32(v); }
+inline uint64_t byteSwap(uint64_t v) { return __builtin_bswap64(v); }
+
+// 可按内存原样拷贝的标量（小端主机上数组可整段memcpy）
+template<typename T>
+struct IsRawScalar : std::integral_constant<bool,
+    (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value> {};
+
+template<typename T>
+struct IsRawArrayElement : std::integral_constant<bool,
+    IsRawScalar<T>::value && (kHostLittleEndian || sizeof(T) == 1)> {};
+
+template<typename T>
+inline void storeScalar(uint8_t* out, T value) {
+    if constexpr (kHostLittleEndian || sizeof(T) == 1) {
+        std::memcpy(out, &value, sizeof(T));
+    } else {
+        typename UIntOfSize<sizeof(T)>::type bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        bits = byteSwap(bits);
+        std::memcpy(out, &bits, sizeof(T));
+    }
+}
+
+template<typename T>
+inline T loadScalar(const uint8_t* in) {
+    T value;
+    if constexpr (kHostLittleEndian || sizeof(T) == 1) {
+        std::memcpy(&value, in, sizeof(T));
+    } else {
+        typename UIntOfSize<sizeof(T)>::type bits;
+        std::memcpy(&bits, in, sizeof(T));
+        bits = byteSwap(bits);
+        std::memcpy(&value, &bits, sizeof(T));
+    }
+    return value;
+}
+
+inline uint32_t checkedLength(size_t length) {
+    if (length > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("SerializedData: field length " + std::to_string(length) + " exceeds uint32");
+    }
+    return static_cast<uint32_t>(length);
+}
+
+struct Reader {
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    void require(size_t needed) const {
+        const size_t left = static_cast<size_t>(end - pos);
+        if (needed > left) {
+            throw std::out_of_range("SerializedData: deserialize needs " + std::to_string(needed) +
+                                    " bytes, " + std::to_string(left) + " left");
+        }
+    }
+};
+
+template<typename T, typename = void>
+struct HasFields : std::false_type {};
+
+template<typename T>
+struct HasFields<T, std::void_t<decltype(std::declval<const T&>().pzmqFields())>> : std::true_type {};
+
+// 每种字段类型的编解码：
+//   kFixedSize  定长类型的编码字节数，变长为0
+//   kMinSize    编码的最少字节数，用于在resize前检查对端给出的元素个数
+//   size()      编码字节数，serialize据此一次性预留空间，write不再检查边界
+//   write()     写入并推进out
+//   read()      读取并推进in；定长类型的边界由调用方一次性检查，变长类型自行检查
+template<typename T, typename = void>
+struct FieldCodec {
+    static_assert(sizeof(T) == 0, "type is not serializable; declare its fields with PZMQ_FIELDS");
+};
+
+template<typename T>
+void readField(Reader& in, T& value);
+
+template<typename T>
+struct FieldCodec<T, std::enable_if_t<IsRawScalar<T>::value>> {
+    static constexpr size_t kFixedSize = sizeof(T);
+    static constexpr size_t kMinSize = sizeof(T);
+    static size_t size(const T&) { return sizeof(T); }
+    static void write(uint8_t*& out, const T& value) {
+        storeScalar(out, value);
+        out += sizeof(T);
+    }
+    static void read(Reader& in, T& value) {
+        value = loadScalar<T>(in.pos);
+        in.pos += sizeof(T);
+    }
+};
+
+template<>
+struct FieldCodec<bool> {
+    static constexpr size_t kFixedSize = 1;
+    static constexpr size_t kMinSize = 1;
+    static size_t size(const bool&) { return 1; }
+    static void write(uint8_t*& out, const bool& value) { *out++ = value ? 1 : 0; }
+    static void read(Reader& in, bool& value) { value = *in.pos++ != 0; }
+};
+
+template<>
+struct FieldCodec<std::string> {
+    static constexpr size_t kFixedSize = 0;
+    static constexpr size_t kMinSize = sizeof(uint32_t);
+    static size_t size(const std::string& value) { return sizeof(uint32_t) + checkedLength(value.size()); }
+    static void write(uint8_t*& out, const std::string& value) {
+        storeScalar(out, static_cast<uint32_t>(value.size()));
+        out += sizeof(uint32_t);
+        std::memcpy(out, value.data(), value.size());
+        out += value.size();
+    }
+    static void read(Reader& in, std::string& value) {
+        in.require(sizeof(uint32_t));
+        const uint32_t length = loadScalar<uint32_t>(in.pos);
+        in.pos += sizeof(uint32_t);
+        in.require(length);
+        value.assign(reinterpret_cast<const char*>(in.pos), length);
+        in.pos += length;
+    }
+};
+
+template<typename E, typename Alloc>
+struct FieldCodec<std::vector<E, Alloc>> {
+    static_assert(!std::is_same<E, bool>::value, "std::vector<bool> is not serializable; use std::vector<uint8_t>");
+    using Elem = FieldCodec<E>;
+
+    static constexpr size_t kFixedSize = 0;
+    static constexpr size_t kMinSize = sizeof(uint32_t);
+    // 元素可能编码为0字节时允许的最大元素个数
+    static constexpr uint32_t kMaxZeroSizeCount = 1u << 16;
+    static size_t size(const std::vector<E, Alloc>& value) {
+        checkedLength(value.size());
+        if constexpr (Elem::kFixedSize > 0) {
+            return sizeof(uint32_t) + value.size() * Elem::kFixedSize;
+        } else {
+            size_t total = sizeof(uint32_t);
+            for (const E& e : value) total += Elem::size(e);
+            return total;
+        }
+    }
+    static void write(uint8_t*& out, const std::vector<E, Alloc>& value) {
+        storeScalar(out, static_cast<uint32_t>(value.size()));
+        out += sizeof(uint32_t);
+        if constexpr (IsRawArrayElement<E>::value) {
+            if (!value.empty()) {
+                std::memcpy(out, value.data(), value.size() * sizeof(E));
+                out += value.size() * sizeof(E);
+            }
+        } else {
+            for (const E& e : value) Elem::write(out, e);
+        }
+    }
+    static void read(Reader& in, std::vector<E, Alloc>& value) {
+        in.require(sizeof(uint32_t));
+        const uint32_t count = loadScalar<uint32_t>(in.pos);
+        in.pos += sizeof(uint32_t);
+        // 每个元素至少占kMinSize字节，先按剩余字节数检查count，避免恶意count导致超大resize
+        if constexpr (Elem::kMinSize > 0) {
+            if (count > static_cast<size_t>(in.end - in.pos) / Elem::kMinSize) {
+                in.require(static_cast<size_t>(count) * Elem::kMinSize);
+            }
+        }
+        if constexpr (Elem::kFixedSize > 0) {
+            value.resize(count);
+            if constexpr (IsRawArrayElement<E>::value) {
+                if (count > 0) {
+                    std::memcpy(value.data(), in.pos, count * sizeof(E));
+                    in.pos += count * sizeof(E);
+                }
+            } else {
+                for (E& e : value) Elem::read(in, e);
+            }
+        } else if constexpr (Elem::kMinSize > 0) {
+            value.clear();
+            value.resize(count);
+            for (E& e : value) Elem::read(in, e);
+        } else {
+            // 元素可能编码为0字节（如空的std::array），无法按剩余长度约束count，改用固定上限
+            if (count > kMaxZeroSizeCount) {
+                throw std::out_of_range("SerializedData: element count " + std::to_string(count) +
+                                        " exceeds " + std::to_string(kMaxZeroSizeCount) +
+                                        " for possibly empty elements");
+            }
+            value.clear();
+            value.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                value.emplace_back();
+                Elem::read(in, value.back());
+            }
+        }
+    }
+};
+
+template<typename E, size_t N>
+struct FieldCodec<std::array<E, N>> {
+    using Elem = FieldCodec<E>;
+
+    static constexpr size_t kFixedSize = Elem::kFixedSize * N;
+    static constexpr size_t kMinSize = Elem::kMinSize * N;
+    static size_t size(const std::array<E, N>& value) {
+        if constexpr (kFixedSize > 0) {
+            (void)value;
+            return kFixedSize;
+        } else {
+            size_t total = 0;
+            for (const E& e : value) total += Elem::size(e);
+            return total;
+        }
+    }
+    static void write(uint8_t*& out, const std::array<E, N>& value) {
+        if constexpr (IsRawArrayElement<E>::value) {
+            std::memcpy(out, value.data(), sizeof(E) * N);
+            out += sizeof(E) * N;
+        } else {
+            for (const E& e : value) Elem::write(out, e);
+        }
+    }
+    static void read(Reader& in, std::array<E, N>& value) {
+        if constexpr (IsRawArrayElement<E>::value) {
+            std::memcpy(value.data(), in.pos, sizeof(E) * N);
+            in.pos += sizeof(E) * N;
+        } else if constexpr (kFixedSize > 0) {
+            for (E& e : value) Elem::read(in, e);
+        } else {
+            for (E& e : value) readField(in, e);
+        }
+    }
+};
+
+template<typename Tuple>
+struct FieldsLayout;
+
+template<typename... Refs>
+struct FieldsLayout<std::tuple<Refs...>> {
+    static constexpr bool kAllFixed = (true && ... && (FieldCodec<std::decay_t<Refs>>::kFixedSize > 0));
+    static constexpr size_t kFixedSize =
+        (sizeof...(Refs) > 0 && kAllFixed) ? (size_t(0) + ... + FieldCodec<std::decay_t<Refs>>::kFixedSize) : 0;
+    static constexpr size_t kMinSize = (size_t(0) + ... + FieldCodec<std::decay_t<Refs>>::kMinSize);
+};
+
+// 声明了PZMQ_FIELDS的结构体：全部字段定长时整体定长，读取只检查一次边界
+template<typename T>
+struct FieldCodec<T, std::enable_if_t<HasFields<T>::value>> {
+    using Layout = FieldsLayout<decltype(std::declval<const T&>().pzmqFields())>;
+
+    static constexpr size_t kFixedSize = Layout::kFixedSize;
+    static constexpr size_t kMinSize = Layout::kMinSize;
+    static size_t size(const T& obj) {
+        if constexpr (kFixedSize > 0) {
+            (void)obj;
+            return kFixedSize;
+        } else {
+            return std::apply([](const auto&... fields) {
+                return (size_t(0) + ... + FieldCodec<std::decay_t<decltype(fields)>>::size(fields));
+            }, obj.pzmqFields());
+        }
+    }
+    static void write(uint8_t*& out, const T& obj) {
+        std::apply([&out](const auto&... fields) {
+            (FieldCodec<std::decay_t<decltype(fields)>>::write(out, fields), ...);
+        }, obj.pzmqFields());
+    }
+    static void read(Reader& in, T& obj) {
+        std::apply([&in](auto&... fields) {
+            if constexpr (kFixedSize > 0) {
+                (FieldCodec<std::decay_t<decltype(fields)>>::read(in, fields), ...);
+            } else {
+                (readField(in, fields), ...);
+            }
+        }, obj.pzmqFields());
+    }
+};
+
+template<typename T>
+void readField(Reader& in, T& value) {
+    if constexpr (FieldCodec<T>::kFixedSize > 0) {
+        in.require(FieldCodec<T>::kFixedSize);
+    }
+    FieldCodec<T>::read(in, value);
+}
+
+} // namespace serialization
+
+// 先计算总长度，只扩容一次，之后直接写入缓冲区
+template<typename T>
+void SerializedData::serialize(const T& obj) {
+    using Codec = serialization::FieldCodec<T>;
+    const size_t total = Codec::size(obj);
+    if (total == 0) return;
+    ensureSpace(total);
+    uint8_t* out = buffer_ + size_;
+    Codec::write(out, obj);
+    size_ += total;
+}
+
+// 数据不足时抛出std::out_of_range，读位置保持不变
+template<typename T>
+T SerializedData::deserialize() {
+    T obj{};
+    serialization::Reader in{buffer_ + read_pos_, buffer_ + size_};
+    serialization::readField(in, obj);
+    read_pos_ = static_cast<size_t>(in.pos - buffer_);
+    return obj;
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
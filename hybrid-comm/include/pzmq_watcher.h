@@ -0,0 +1,78 @@
+#pragma once
+
+#include <zmq.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace edge_infra {
+namespace network {
+class Channel;
+class EventLoop;
+} // namespace network
+
+namespace hybrid_comm {
+
+class ZmqSocket;
+
+// 把ZeroMQ套接字挂到network::EventLoop上，由一个reactor线程同时服务TCP连接和ZMQ后端。
+// ZMQ_FD只是边沿通知：fd可读仅表示"ZMQ_EVENTS可能变了"，而且其他操作（包括send）会
+// 在内部消耗这个通知。因此每次唤醒都循环查询ZMQ_EVENTS直到没有POLLIN/POLLOUT，
+// 单次唤醒消息数超过kMaxEventsPerWakeup时把剩余部分排到下一轮，避免饿死其他fd；
+// 在loop线程之外对套接字做了操作后应调用recheck()。
+// 回调在loop线程中执行，每次调用应非阻塞地处理一条消息（使用ZMQ_DONTWAIT）。
+// 套接字同时被其他线程使用时传入socket_mutex，查询ZMQ_EVENTS时会持有它，回调需要自行加锁
+class ZmqWatcher : public std::enable_shared_from_this<ZmqWatcher> {
+public:
+    using EventCallback = std::function<void()>;
+
+    static const int kMaxEventsPerWakeup = 64;
+
+private:
+    network::EventLoop* loop_;
+    void* socket_;
+    std::mutex* socket_mutex_;
+    std::string name_;
+    std::unique_ptr<network::Channel> channel_;
+
+    EventCallback readable_callback_;
+    EventCallback writable_callback_;
+    bool want_write_;
+    bool recheck_queued_;   // 只在loop线程访问
+
+public:
+    ZmqWatcher(network::EventLoop* loop, void* socket, std::mutex* socket_mutex = nullptr,
+               const std::string& name = "zmq");
+    ZmqWatcher(network::EventLoop* loop, ZmqSocket& socket, std::mutex* socket_mutex = nullptr);
+    ~ZmqWatcher();
+
+    ZmqWatcher(const ZmqWatcher&) = delete;
+    ZmqWatcher& operator=(const ZmqWatcher&) = delete;
+
+    void setReadableCallback(EventCallback cb) { readable_callback_ = std::move(cb); }
+    void setWritableCallback(EventCallback cb) { writable_callback_ = std::move(cb); }
+
+    // 线程安全。start()注册ZMQ_FD并立即处理注册前已到达的消息；
+    // stop()在loop线程之外调用时会等待注销完成，要求loop正在运行
+    void start();
+    void stop();
+
+    // 套接字可写时回调writable_callback_，在loop线程调用
+    void enableWriting();
+    void disableWriting();
+
+    // 线程安全：重新检查ZMQ_EVENTS，在loop线程外send/recv之后调用
+    void recheck();
+
+    network::EventLoop* getLoop() const { return loop_; }
+
+private:
+    void startInLoop();
+    void stopInLoop();
+    void handleEvents();
+    int queryEvents() const;
+};
+
+} // namespace hybrid_comm
+} // namespace edge_infra
@@ -0,0 +1,160 @@
+#include "../include/crc32c.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define HYBRID_COMM_CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define HYBRID_COMM_CRC32C_ARM 1
+#endif
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+namespace {
+
+const uint32_t kCrc32cPoly = 0x82F63B78;  // 反射多项式
+
+using Crc32cFunc = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+// slicing-by-8 查表，每轮处理8字节
+struct Crc32cTable {
+    uint32_t table[8][256];
+
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc & 1) ? (crc >> 1) ^ kCrc32cPoly : crc >> 1;
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int t = 1; t < 8; ++t) {
+                table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+uint32_t crc32cSoftware(uint32_t crc, const uint8_t* p, size_t size) {
+    static const Crc32cTable tables;
+    const auto& t = tables.table;
+
+    while (size >= 8) {
+        uint32_t lo;
+        uint32_t hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(HYBRID_COMM_CRC32C_X86)
+
+__attribute__((target("sse4.2")))
+uint32_t crc32cHardware(uint32_t crc, const uint8_t* p, size_t size) {
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc64 = _mm_crc32_u64(crc64, v);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (size >= 4) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        size -= 4;
+    }
+    while (size--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+bool hasHardwareCrc32c() {
+    return __builtin_cpu_supports("sse4.2");
+}
+
+const char* const kHardwareName = "sse4.2";
+
+#elif defined(HYBRID_COMM_CRC32C_ARM)
+
+__attribute__((target("+crc")))
+uint32_t crc32cHardware(uint32_t crc, const uint8_t* p, size_t size) {
+    while (size >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+
+bool hasHardwareCrc32c() {
+    return (::getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+}
+
+const char* const kHardwareName = "armv8";
+
+#endif
+
+struct Crc32cDispatch {
+    Crc32cFunc func;
+    const char* name;
+
+    Crc32cDispatch() : func(crc32cSoftware), name("software") {
+#if defined(HYBRID_COMM_CRC32C_X86) || defined(HYBRID_COMM_CRC32C_ARM)
+        if (hasHardwareCrc32c()) {
+            func = crc32cHardware;
+            name = kHardwareName;
+        }
+#endif
+    }
+};
+
+const Crc32cDispatch& dispatch() {
+    static const Crc32cDispatch instance;
+    return instance;
+}
+
+} // namespace
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t size) {
+    if (size == 0) return crc;
+    return ~dispatch().func(~crc, static_cast<const uint8_t*>(data), size);
+}
+
+const char* crc32cImplementation() {
+    return dispatch().name;
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
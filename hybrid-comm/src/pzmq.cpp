@@ -0,0 +1,706 @@
+#include "../include/pzmq.hpp"
+#include "metrics.h"
+#include <chrono>
+#include <iostream>
+#include <cstring>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+namespace {
+
+// 零拷贝消息的释放函数，可能在ZeroMQ IO线程中调用
+void freeStringBuffer(void* /*data*/, void* hint) {
+    delete static_cast<std::string*>(hint);
+}
+
+void freeVectorBuffer(void* /*data*/, void* hint) {
+    delete static_cast<std::vector<uint8_t>*>(hint);
+}
+
+// hint为缓冲区容量；在IO线程归还的块进入该线程缓存，满了再成批回到全局仓库
+void freePooledBuffer(void* data, void* hint) {
+    BufferPool::deallocate(static_cast<uint8_t*>(data), reinterpret_cast<size_t>(hint));
+}
+
+const char* socketTypeName(int type) {
+    switch (type) {
+        case ZMQ_REQ: return "REQ";
+        case ZMQ_REP: return "REP";
+        case ZMQ_DEALER: return "DEALER";
+        case ZMQ_ROUTER: return "ROUTER";
+        case ZMQ_PUB: return "PUB";
+        case ZMQ_SUB: return "SUB";
+        case ZMQ_PUSH: return "PUSH";
+        case ZMQ_PULL: return "PULL";
+        case ZMQ_PAIR: return "PAIR";
+        default: return "OTHER";
+    }
+}
+
+// 单写者计数：不需要原子读-改-写
+void addRelaxed(std::atomic<uint64_t>& counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// ==================== ZmqMessage ====================
+
+const size_t ZmqMessage::kZeroCopyThreshold;
+
+ZmqMessage::ZmqMessage() : initialized_(false) {
+    zmq_msg_init(&msg_);
+    initialized_ = true;
+}
+
+ZmqMessage::ZmqMessage(size_t size) : initialized_(false) {
+    zmq_msg_init_size(&msg_, size);
+    initialized_ = true;
+}
+
+ZmqMessage::ZmqMessage(const std::string& data) : ZmqMessage(data.data(), data.size()) {
+}
+
+ZmqMessage::ZmqMessage(const void* data, size_t size) : initialized_(false) {
+    zmq_msg_init_size(&msg_, size);
+    initialized_ = true;
+    if (size > 0) {
+        std::memcpy(zmq_msg_data(&msg_), data, size);
+    }
+}
+
+ZmqMessage::ZmqMessage(void* data, size_t size, zmq_free_fn* ffn, void* hint) : initialized_(false) {
+    if (zmq_msg_init_data(&msg_, data, size, ffn, hint) != 0) {
+        // 初始化失败时ZeroMQ不会调用ffn，由这里负责归还缓冲区
+        if (ffn != nullptr) {
+            ffn(data, hint);
+        }
+        zmq_msg_init(&msg_);
+    }
+    initialized_ = true;
+}
+
+ZmqMessage::ZmqMessage(std::string&& data) : initialized_(false) {
+    if (data.size() < kZeroCopyThreshold) {
+        zmq_msg_init_size(&msg_, data.size());
+        std::memcpy(zmq_msg_data(&msg_), data.data(), data.size());
+        initialized_ = true;
+        return;
+    }
+
+    std::string* holder = new std::string(std::move(data));
+    if (zmq_msg_init_data(&msg_, &(*holder)[0], holder->size(), freeStringBuffer, holder) != 0) {
+        delete holder;
+        zmq_msg_init(&msg_);
+    }
+    initialized_ = true;
+}
+
+ZmqMessage::ZmqMessage(std::vector<uint8_t>&& data) : initialized_(false) {
+    if (data.size() < kZeroCopyThreshold) {
+        zmq_msg_init_size(&msg_, data.size());
+        if (!data.empty()) {
+            std::memcpy(zmq_msg_data(&msg_), data.data(), data.size());
+        }
+        initialized_ = true;
+        return;
+    }
+
+    auto* holder = new std::vector<uint8_t>(std::move(data));
+    if (zmq_msg_init_data(&msg_, holder->data(), holder->size(), freeVectorBuffer, holder) != 0) {
+        delete holder;
+        zmq_msg_init(&msg_);
+    }
+    initialized_ = true;
+}
+
+ZmqMessage::ZmqMessage(SerializedData&& data) : ZmqMessage(data.release()) {
+}
+
+ZmqMessage::ZmqMessage(PooledBuffer&& buffer) : initialized_(false) {
+    if (buffer.size() < kZeroCopyThreshold) {
+        // 小消息拷贝到ZeroMQ自己的存储，缓冲区随buffer析构立即回池
+        zmq_msg_init_size(&msg_, buffer.size());
+        if (buffer.size() > 0) {
+            std::memcpy(zmq_msg_data(&msg_), buffer.data(), buffer.size());
+        }
+        initialized_ = true;
+        return;
+    }
+
+    if (zmq_msg_init_data(&msg_, buffer.data(), buffer.size(), freePooledBuffer,
+                          reinterpret_cast<void*>(buffer.capacity())) == 0) {
+        buffer.release();
+    } else {
+        zmq_msg_init(&msg_);
+    }
+    initialized_ = true;
+}
+
+ZmqMessage::~ZmqMessage() {
+    cleanup();
+}
+
+ZmqMessage::ZmqMessage(ZmqMessage&& other) noexcept : initialized_(false) {
+    zmq_msg_init(&msg_);
+    zmq_msg_move(&msg_, &other.msg_);
+    initialized_ = true;
+}
+
+ZmqMessage& ZmqMessage::operator=(ZmqMessage&& other) noexcept {
+    if (this != &other) {
+        if (!initialized_) {
+            zmq_msg_init(&msg_);
+            initialized_ = true;
+        }
+        // zmq_msg_move会先释放msg_原有内容
+        zmq_msg_move(&msg_, &other.msg_);
+    }
+    return *this;
+}
+
+std::string ZmqMessage::toString() const {
+    return std::string(static_cast<const char*>(data()), size());
+}
+
+void ZmqMessage::fromString(const std::string& str) {
+    cleanup();
+    zmq_msg_init_size(&msg_, str.size());
+    initialized_ = true;
+    if (!str.empty()) {
+        std::memcpy(zmq_msg_data(&msg_), str.data(), str.size());
+    }
+}
+
+void ZmqMessage::clear() {
+    cleanup();
+    zmq_msg_init(&msg_);
+    initialized_ = true;
+}
+
+void ZmqMessage::cleanup() {
+    if (initialized_) {
+        zmq_msg_close(&msg_);
+        initialized_ = false;
+    }
+}
+
+// ==================== ZmqContext ====================
+
+std::mutex ZmqContext::instance_mutex_;
+std::shared_ptr<ZmqContext> ZmqContext::instance_;
+
+ZmqContext::ZmqContext() : context_(zmq_ctx_new()), ref_count_(0) {
+    if (context_ == nullptr) {
+        std::cerr << "[ZmqContext] zmq_ctx_new failed: " << zmq_strerror(zmq_errno()) << std::endl;
+    }
+}
+
+ZmqContext::~ZmqContext() {
+    if (context_ != nullptr) {
+        zmq_ctx_term(context_);
+        context_ = nullptr;
+    }
+}
+
+std::shared_ptr<ZmqContext> ZmqContext::getInstance() {
+    std::lock_guard<std::mutex> lock(instance_mutex_);
+    if (!instance_) {
+        instance_.reset(new ZmqContext());
+    }
+    return instance_;
+}
+
+// ==================== ZmqSocket ====================
+
+ZmqSocket::ZmqSocket(SocketType type)
+    : context_(ZmqContext::getInstance()),
+      socket_(zmq_socket(context_->getContext(), type)),
+      type_(type),
+      connected_(false),
+      messages_sent_(0),
+      messages_received_(0),
+      bytes_sent_(0),
+      bytes_received_(0),
+      debug_enabled_(false) {
+    metrics::MetricsRegistry& registry = metrics::MetricsRegistry::instance();
+    const std::string labels = metrics::label("type", socketTypeName(type));
+    messages_sent_metric_ = registry.counter("edge_zmq_messages_sent_total", "ZeroMQ messages sent", labels);
+    messages_received_metric_ = registry.counter("edge_zmq_messages_received_total", "ZeroMQ messages received", labels);
+    bytes_sent_metric_ = registry.counter("edge_zmq_bytes_sent_total", "ZeroMQ payload bytes sent", labels);
+    bytes_received_metric_ = registry.counter("edge_zmq_bytes_received_total", "ZeroMQ payload bytes received", labels);
+    latency_metric_ = registry.histogram("edge_zmq_message_latency_us",
+                                         "Send-to-receive latency of framed messages in microseconds", labels);
+    if (socket_ == nullptr) {
+        std::cerr << "[ZmqSocket] zmq_socket failed: " << zmq_strerror(zmq_errno()) << std::endl;
+    }
+}
+
+ZmqSocket::~ZmqSocket() {
+    close();
+}
+
+bool ZmqSocket::bind(const std::string& endpoint) {
+    if (zmq_bind(socket_, endpoint.c_str()) != 0) {
+        debugLog("bind " + endpoint + " failed: " + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    endpoint_ = endpoint;
+    connected_ = true;
+    debugLog("bound to " + endpoint);
+    return true;
+}
+
+bool ZmqSocket::connect(const std::string& endpoint) {
+    if (zmq_connect(socket_, endpoint.c_str()) != 0) {
+        debugLog("connect " + endpoint + " failed: " + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    endpoint_ = endpoint;
+    connected_ = true;
+    debugLog("connected to " + endpoint);
+    return true;
+}
+
+void ZmqSocket::disconnect() {
+    if (socket_ == nullptr || !connected_ || endpoint_.empty()) return;
+
+    // 不区分bind/connect，依次尝试
+    if (zmq_disconnect(socket_, endpoint_.c_str()) != 0) {
+        zmq_unbind(socket_, endpoint_.c_str());
+    }
+    connected_ = false;
+    debugLog("disconnected from " + endpoint_);
+}
+
+void ZmqSocket::close() {
+    if (socket_ != nullptr) {
+        zmq_close(socket_);
+        socket_ = nullptr;
+        connected_ = false;
+    }
+}
+
+bool ZmqSocket::send(const ZmqMessage& msg, int flags) {
+    // zmq_msg_copy对大消息只增加引用计数，不拷贝数据
+    zmq_msg_t copy;
+    zmq_msg_init(&copy);
+    zmq_msg_copy(&copy, const_cast<zmq_msg_t*>(msg.raw()));
+
+    int rc = zmq_msg_send(&copy, socket_, flags);
+    if (rc < 0) {
+        zmq_msg_close(&copy);
+        debugLog(std::string("send failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    updateSendStats(rc);
+    return true;
+}
+
+bool ZmqSocket::send(const std::string& data, int flags) {
+    return send(data.data(), data.size(), flags);
+}
+
+bool ZmqSocket::send(const void* data, size_t size, int flags) {
+    int rc = zmq_send(socket_, data, size, flags);
+    if (rc < 0) {
+        debugLog(std::string("send failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    updateSendStats(size);
+    return true;
+}
+
+bool ZmqSocket::send(ZmqMessage&& msg, int flags) {
+    size_t size = msg.size();
+    // 发送成功后ZeroMQ接管消息内容，msg变为空消息
+    if (zmq_msg_send(msg.raw(), socket_, flags) < 0) {
+        debugLog(std::string("send failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    updateSendStats(size);
+    return true;
+}
+
+bool ZmqSocket::send(std::string&& data, int flags) {
+    return send(ZmqMessage(std::move(data)), flags);
+}
+
+bool ZmqSocket::recv(ZmqMessage& msg, int flags) {
+    int rc = zmq_msg_recv(msg.raw(), socket_, flags);
+    if (rc < 0) {
+        if (zmq_errno() != EAGAIN) {
+            debugLog(std::string("recv failed: ") + zmq_strerror(zmq_errno()));
+        }
+        return false;
+    }
+    updateRecvStats(rc);
+    return true;
+}
+
+bool ZmqSocket::recv(std::string& data, int flags) {
+    ZmqMessage msg;
+    if (!recv(msg, flags)) {
+        return false;
+    }
+    data.assign(static_cast<const char*>(msg.data()), msg.size());
+    return true;
+}
+
+bool ZmqSocket::sendMore(const ZmqMessage& msg) {
+    return send(msg, ZMQ_SNDMORE);
+}
+
+bool ZmqSocket::sendMore(const std::string& data) {
+    return send(data, ZMQ_SNDMORE);
+}
+
+bool ZmqSocket::isTrustedTransport() const {
+    return endpoint_.compare(0, 6, "ipc://") == 0 ||
+           endpoint_.compare(0, 9, "inproc://") == 0;
+}
+
+bool ZmqSocket::hasMore() const {
+    int more = 0;
+    size_t more_size = sizeof(more);
+    if (zmq_getsockopt(socket_, ZMQ_RCVMORE, &more, &more_size) != 0) {
+        return false;
+    }
+    return more != 0;
+}
+
+bool ZmqSocket::sendv(const struct iovec* iov, size_t iovcnt, int flags) {
+    if (iovcnt == 0) return false;
+
+    // 多部分消息是原子投递的：首帧被接受后，后续帧不会因HWM而失败
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; ++i) {
+        int frame_flags = (i + 1 < iovcnt) ? (flags | ZMQ_SNDMORE) : flags;
+        if (zmq_send(socket_, iov[i].iov_base, iov[i].iov_len, frame_flags) < 0) {
+            debugLog("sendv frame " + std::to_string(i) + " failed: " + zmq_strerror(zmq_errno()));
+            return false;
+        }
+        total += iov[i].iov_len;
+    }
+    updateSendStats(total);
+    return true;
+}
+
+bool ZmqSocket::sendMultipart(std::vector<ZmqMessage>& frames, int flags) {
+    if (frames.empty()) return false;
+
+    size_t total = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        int frame_flags = (i + 1 < frames.size()) ? (flags | ZMQ_SNDMORE) : flags;
+        size_t size = frames[i].size();
+        if (zmq_msg_send(frames[i].raw(), socket_, frame_flags) < 0) {
+            debugLog("sendMultipart frame " + std::to_string(i) + " failed: " + zmq_strerror(zmq_errno()));
+            return false;
+        }
+        total += size;
+    }
+    updateSendStats(total);
+    return true;
+}
+
+bool ZmqSocket::recvMultipart(std::vector<ZmqMessage>& frames, int flags) {
+    frames.clear();
+
+    size_t total = 0;
+    int frame_flags = flags;
+    do {
+        frames.emplace_back();
+        if (zmq_msg_recv(frames.back().raw(), socket_, frame_flags) < 0) {
+            if (zmq_errno() != EAGAIN) {
+                debugLog(std::string("recvMultipart failed: ") + zmq_strerror(zmq_errno()));
+            }
+            frames.clear();
+            return false;
+        }
+        total += frames.back().size();
+        // 后续帧与首帧同时到达，无需再非阻塞
+        frame_flags = 0;
+    } while (zmq_msg_more(frames.back().raw()));
+
+    updateRecvStats(total);
+    return true;
+}
+
+bool ZmqSocket::sendHeaderFrame(const Message& msg, int flags) {
+    MessageHeader header = msg.getHeader();
+    header.payload_size = static_cast<uint32_t>(msg.getPayload().size());
+    // 可信传输上免校验；否则接收端总会校验，这里必须按实际负载计算
+    if (isTrustedTransport()) {
+        header.setFlag(MessageHeader::kFlagNoChecksum);
+        header.checksum = 0;
+    } else {
+        header.setFlag(MessageHeader::kFlagNoChecksum, false);
+        header.checksum = header.calculateChecksum(msg.getPayload().data());
+    }
+    trace::Span span("zmq.send", header.outgoingTraceParent(), "zmq.send");
+    header.injectCurrentTrace();
+    if (zmq_send(socket_, &header, sizeof(header), flags | ZMQ_SNDMORE) < 0) {
+        debugLog(std::string("send header failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    return true;
+}
+
+bool ZmqSocket::sendMessage(const Message& msg, int flags) {
+    if (!sendHeaderFrame(msg, flags)) return false;
+
+    const SerializedData& payload = msg.getPayload();
+    if (zmq_send(socket_, payload.data(), payload.size(), flags) < 0) {
+        debugLog(std::string("send payload failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    updateSendStats(sizeof(MessageHeader) + payload.size());
+    return true;
+}
+
+bool ZmqSocket::sendMessage(Message&& msg, int flags) {
+    if (!sendHeaderFrame(msg, flags)) return false;
+
+    ZmqMessage payload(std::move(msg.getPayload()));
+    size_t payload_size = payload.size();
+    if (zmq_msg_send(payload.raw(), socket_, flags) < 0) {
+        debugLog(std::string("send payload failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    updateSendStats(sizeof(MessageHeader) + payload_size);
+    return true;
+}
+
+bool ZmqSocket::recvMessage(Message& msg, int flags) {
+    ZmqMessage payload;
+    if (!recvMessage(msg.getHeader(), payload, flags)) {
+        return false;
+    }
+    if (payload.size() == 0) {
+        msg.getPayload().clear();
+    } else {
+        msg.setPayload(payload.data(), payload.size());
+    }
+    return true;
+}
+
+bool ZmqSocket::recvMessage(MessageHeader& header, ZmqMessage& payload, int flags) {
+    ZmqMessage header_frame;
+    if (zmq_msg_recv(header_frame.raw(), socket_, flags) < 0) {
+        if (zmq_errno() != EAGAIN) {
+            debugLog(std::string("recv header failed: ") + zmq_strerror(zmq_errno()));
+        }
+        return false;
+    }
+
+    if (header_frame.size() != sizeof(MessageHeader)) {
+        debugLog("invalid header frame size " + std::to_string(header_frame.size()));
+        discardRemainingFrames();
+        return false;
+    }
+
+    std::memcpy(&header, header_frame.data(), sizeof(header));
+    if (!header.isValid()) {
+        debugLog("invalid message header");
+        discardRemainingFrames();
+        return false;
+    }
+
+    if (!zmq_msg_more(header_frame.raw())) {
+        payload = ZmqMessage();
+        if (header.payload_size != 0) {
+            debugLog("missing payload frame");
+            return false;
+        }
+        if (!header.verifyChecksum(nullptr, isTrustedTransport())) {
+            debugLog("checksum mismatch, seq=" + std::to_string(header.sequence_id));
+            return false;
+        }
+        updateRecvStats(sizeof(MessageHeader));
+        recordLatency(header);
+        header.extractTrace("zmq.recv");
+        return true;
+    }
+
+    ZmqMessage payload_frame;
+    if (zmq_msg_recv(payload_frame.raw(), socket_, 0) < 0) {
+        debugLog(std::string("recv payload failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    if (zmq_msg_more(payload_frame.raw())) {
+        discardRemainingFrames();
+    }
+
+    if (payload_frame.size() != header.payload_size) {
+        debugLog("payload size mismatch: header=" + std::to_string(header.payload_size) +
+                 " frame=" + std::to_string(payload_frame.size()));
+        return false;
+    }
+    // 是否免校验取决于本端的传输，而不是对端设置的标志位
+    if (!header.verifyChecksum(payload_frame.data(), isTrustedTransport())) {
+        debugLog("checksum mismatch, seq=" + std::to_string(header.sequence_id));
+        return false;
+    }
+
+    const size_t payload_size = payload_frame.size();
+    payload = std::move(payload_frame);
+    updateRecvStats(sizeof(MessageHeader) + payload_size);
+    recordLatency(header);
+    header.extractTrace("zmq.recv");
+    return true;
+}
+
+void ZmqSocket::discardRemainingFrames() {
+    while (hasMore()) {
+        ZmqMessage frame;
+        if (zmq_msg_recv(frame.raw(), socket_, 0) < 0) {
+            break;
+        }
+    }
+}
+
+bool ZmqSocket::setSockOpt(int option, const void* optval, size_t optvallen) {
+    if (zmq_setsockopt(socket_, option, optval, optvallen) != 0) {
+        debugLog("setsockopt " + std::to_string(option) + " failed: " + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    return true;
+}
+
+bool ZmqSocket::getSockOpt(int option, void* optval, size_t* optvallen) {
+    return zmq_getsockopt(socket_, option, optval, optvallen) == 0;
+}
+
+bool ZmqSocket::setIdentity(const std::string& identity) {
+    return setSockOpt(ZMQ_IDENTITY, identity.data(), identity.size());
+}
+
+bool ZmqSocket::setSubscribe(const std::string& filter) {
+    return setSockOpt(ZMQ_SUBSCRIBE, filter.data(), filter.size());
+}
+
+bool ZmqSocket::setUnsubscribe(const std::string& filter) {
+    return setSockOpt(ZMQ_UNSUBSCRIBE, filter.data(), filter.size());
+}
+
+bool ZmqSocket::setLinger(int linger_ms) {
+    return setSockOpt(ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+}
+
+bool ZmqSocket::setReceiveTimeout(int timeout_ms) {
+    return setSockOpt(ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+}
+
+bool ZmqSocket::setSendTimeout(int timeout_ms) {
+    return setSockOpt(ZMQ_SNDTIMEO, &timeout_ms, sizeof(timeout_ms));
+}
+
+void ZmqSocket::enableDebug(bool enable) {
+    debug_enabled_ = enable;
+}
+
+void ZmqSocket::printStatistics() const {
+    std::cout << "=== ZmqSocket Statistics ===" << std::endl;
+    std::cout << "Type: " << type_ << " Endpoint: " << endpoint_ << std::endl;
+    std::cout << "Messages Sent: " << messages_sent_.load() << std::endl;
+    std::cout << "Messages Received: " << messages_received_.load() << std::endl;
+    std::cout << "Bytes Sent: " << bytes_sent_.load() << std::endl;
+    std::cout << "Bytes Received: " << bytes_received_.load() << std::endl;
+}
+
+void ZmqSocket::updateSendStats(size_t bytes) {
+    addRelaxed(messages_sent_, 1);
+    addRelaxed(bytes_sent_, bytes);
+    messages_sent_metric_->increment();
+    bytes_sent_metric_->add(bytes);
+}
+
+void ZmqSocket::updateRecvStats(size_t bytes) {
+    addRelaxed(messages_received_, 1);
+    addRelaxed(bytes_received_, bytes);
+    messages_received_metric_->increment();
+    bytes_received_metric_->add(bytes);
+}
+
+// timestamp为发送端的system_clock微秒，跨主机时依赖时钟同步；时钟回拨导致的负值直接丢弃
+void ZmqSocket::recordLatency(const MessageHeader& header) {
+    if (header.timestamp == 0) return;
+    const uint64_t now_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    if (now_us >= header.timestamp) {
+        latency_metric_->record(now_us - header.timestamp);
+    }
+}
+
+void ZmqSocket::debugLog(const std::string& message) const {
+    if (!debug_enabled_) return;
+    std::cout << "[ZmqSocket " << endpoint_ << "] " << message << std::endl;
+}
+
+// ==================== ZmqPoller ====================
+
+void ZmqPoller::addSocket(ZmqSocket& socket, short events) {
+    void* handle = socket.handle();
+    auto it = socket_index_map_.find(handle);
+    if (it != socket_index_map_.end()) {
+        poll_items_[it->second].events = events;
+        return;
+    }
+
+    zmq_pollitem_t item;
+    item.socket = handle;
+    item.fd = 0;
+    item.events = events;
+    item.revents = 0;
+    socket_index_map_[handle] = poll_items_.size();
+    poll_items_.push_back(item);
+}
+
+void ZmqPoller::removeSocket(ZmqSocket& socket) {
+    auto it = socket_index_map_.find(socket.handle());
+    if (it == socket_index_map_.end()) return;
+
+    // 与最后一项交换后删除，保持O(1)
+    size_t index = it->second;
+    size_t last = poll_items_.size() - 1;
+    if (index != last) {
+        poll_items_[index] = poll_items_[last];
+        socket_index_map_[poll_items_[index].socket] = index;
+    }
+    poll_items_.pop_back();
+    socket_index_map_.erase(it);
+}
+
+void ZmqPoller::clear() {
+    poll_items_.clear();
+    socket_index_map_.clear();
+}
+
+int ZmqPoller::poll(long timeout_ms) {
+    if (poll_items_.empty()) return 0;
+    return zmq_poll(poll_items_.data(), static_cast<int>(poll_items_.size()), timeout_ms);
+}
+
+bool ZmqPoller::hasInput(const ZmqSocket& socket) const {
+    size_t index = findSocketIndex(socket.handle());
+    return index < poll_items_.size() && (poll_items_[index].revents & ZMQ_POLLIN);
+}
+
+bool ZmqPoller::hasOutput(const ZmqSocket& socket) const {
+    size_t index = findSocketIndex(socket.handle());
+    return index < poll_items_.size() && (poll_items_[index].revents & ZMQ_POLLOUT);
+}
+
+bool ZmqPoller::hasError(const ZmqSocket& socket) const {
+    size_t index = findSocketIndex(socket.handle());
+    return index < poll_items_.size() && (poll_items_[index].revents & ZMQ_POLLERR);
+}
+
+size_t ZmqPoller::findSocketIndex(void* socket) const {
+    auto it = socket_index_map_.find(socket);
+    return it != socket_index_map_.end() ? it->second : poll_items_.size();
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
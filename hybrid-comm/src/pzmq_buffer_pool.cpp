@@ -0,0 +1,162 @@
+#include "../include/pzmq_buffer_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+const size_t BufferPool::kMinClassSize;
+const size_t BufferPool::kMaxClassSize;
+const int BufferPool::kNumClasses;
+std::atomic<uint64_t> BufferPool::heap_allocations_(0);
+
+namespace {
+
+const size_t kThreadCacheBytesPerClass = 256 * 1024;
+const int kMaxThreadSlots = 32;
+const int kMinThreadSlots = 2;
+const int kDepotSlotsFactor = 8;   // 全局仓库每级最多缓存线程上限的倍数
+
+size_t classSize(int index) {
+    return BufferPool::kMinClassSize << index;
+}
+
+int classIndex(size_t size) {
+    int index = 0;
+    size_t cls = BufferPool::kMinClassSize;
+    while (cls < size) {
+        cls <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+int threadSlots(int index) {
+    const size_t slots = kThreadCacheBytesPerClass / classSize(index);
+    return static_cast<int>(std::min<size_t>(kMaxThreadSlots, std::max<size_t>(kMinThreadSlots, slots)));
+}
+
+// 全局仓库；故意不析构，线程在静态对象销毁后退出时仍可归还
+struct Depot {
+    std::mutex mutex[BufferPool::kNumClasses];
+    std::vector<uint8_t*> blocks[BufferPool::kNumClasses];
+};
+
+Depot& depot() {
+    static Depot* instance = new Depot();
+    return *instance;
+}
+
+struct ThreadCache {
+    uint8_t* slots[BufferPool::kNumClasses][kMaxThreadSlots];
+    int counts[BufferPool::kNumClasses];
+
+    ThreadCache() {
+        std::fill(counts, counts + BufferPool::kNumClasses, 0);
+    }
+
+    ~ThreadCache() {
+        flush();
+    }
+
+    void flush() {
+        for (int i = 0; i < BufferPool::kNumClasses; ++i) {
+            if (counts[i] > 0) {
+                spill(i, counts[i]);
+            }
+        }
+    }
+
+    // 把最旧的n块交给全局仓库，仓库满时直接释放
+    void spill(int index, int n) {
+        Depot& d = depot();
+        const size_t depot_limit = static_cast<size_t>(threadSlots(index)) * kDepotSlotsFactor;
+        {
+            std::lock_guard<std::mutex> lock(d.mutex[index]);
+            std::vector<uint8_t*>& blocks = d.blocks[index];
+            int i = 0;
+            for (; i < n && blocks.size() < depot_limit; ++i) {
+                blocks.push_back(slots[index][i]);
+            }
+            for (; i < n; ++i) {
+                std::free(slots[index][i]);
+            }
+        }
+        std::copy(slots[index] + n, slots[index] + counts[index], slots[index]);
+        counts[index] -= n;
+    }
+
+    // 从全局仓库取一批，返回取到的数量
+    int refill(int index) {
+        Depot& d = depot();
+        const int want = std::max(1, threadSlots(index) / 2);
+        std::lock_guard<std::mutex> lock(d.mutex[index]);
+        std::vector<uint8_t*>& blocks = d.blocks[index];
+        int got = 0;
+        while (got < want && !blocks.empty()) {
+            slots[index][counts[index]++] = blocks.back();
+            blocks.pop_back();
+            ++got;
+        }
+        return got;
+    }
+};
+
+ThreadCache& threadCache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+} // namespace
+
+uint8_t* BufferPool::allocate(size_t size, size_t* capacity) {
+    if (size == 0) {
+        *capacity = 0;
+        return nullptr;
+    }
+    if (size > kMaxClassSize) {
+        heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+        uint8_t* data = static_cast<uint8_t*>(std::malloc(size));
+        if (data == nullptr) throw std::bad_alloc();
+        *capacity = size;
+        return data;
+    }
+
+    const int index = classIndex(size);
+    *capacity = classSize(index);
+    ThreadCache& cache = threadCache();
+    if (cache.counts[index] > 0 || cache.refill(index) > 0) {
+        return cache.slots[index][--cache.counts[index]];
+    }
+
+    heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+    uint8_t* data = static_cast<uint8_t*>(std::malloc(*capacity));
+    if (data == nullptr) throw std::bad_alloc();
+    return data;
+}
+
+void BufferPool::deallocate(uint8_t* data, size_t capacity) {
+    if (data == nullptr) return;
+    if (capacity > kMaxClassSize) {
+        std::free(data);
+        return;
+    }
+
+    const int index = classIndex(capacity);
+    ThreadCache& cache = threadCache();
+    const int limit = threadSlots(index);
+    if (cache.counts[index] >= limit) {
+        cache.spill(index, limit / 2);
+    }
+    cache.slots[index][cache.counts[index]++] = data;
+}
+
+void BufferPool::flushThreadCache() {
+    threadCache().flush();
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
@@ -0,0 +1,59 @@
+#include "../include/pzmq_codec.h"
+#include <cstring>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+MessageCodec::DecodeResult MessageCodec::decodeFrame(const char* data, size_t len, Message* frame,
+                                                     size_t* consumed, std::string* error) {
+    if (len < sizeof(MessageHeader)) {
+        return kNeedMore;
+    }
+
+    MessageHeader header;
+    std::memcpy(&header, data, sizeof(MessageHeader));
+    if (!header.isValid()) {
+        *error = "invalid message header";
+        return kError;
+    }
+    if (header.payload_size > max_frame_size_) {
+        *error = "payload size " + std::to_string(header.payload_size) + " exceeds " +
+                 std::to_string(max_frame_size_);
+        return kError;
+    }
+
+    const size_t total = sizeof(MessageHeader) + header.payload_size;
+    if (len < total) {
+        return kNeedMore;
+    }
+    if (!frame->deserialize(data, total)) {
+        *error = "malformed message";
+        return kError;
+    }
+    if (verify_checksum_ && !frame->validate()) {
+        *error = "checksum mismatch, seq=" + std::to_string(header.sequence_id);
+        return kError;
+    }
+    frame->getHeader().extractTrace("tcp.recv");
+
+    *consumed = total;
+    return kFrame;
+}
+
+void MessageCodec::encodeFrame(const Message& frame, network::OutputQueue* out) {
+    const SerializedData& payload = frame.getPayload();
+    MessageHeader header = frame.getHeader();
+    header.payload_size = static_cast<uint32_t>(payload.size());
+    header.setFlag(MessageHeader::kFlagNoChecksum, false);
+    header.checksum = header.calculateChecksum(payload.data());
+    trace::Span span("tcp.send", header.outgoingTraceParent(), "tcp.send");
+    header.injectCurrentTrace();
+
+    out->append(&header, sizeof(MessageHeader));
+    if (payload.size() > 0) {
+        out->append(payload.data(), payload.size());
+    }
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
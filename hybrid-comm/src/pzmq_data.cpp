@@ -0,0 +1,424 @@
+#include "../include/pzmq_data.h"
+#include "../include/crc32c.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+// ==================== MessageHeader ====================
+
+const uint32_t MessageHeader::kMagic;
+const uint32_t MessageHeader::kVersion;
+const uint32_t MessageHeader::kFlagNoChecksum;
+const uint32_t MessageHeader::kFlagTraced;
+
+MessageHeader::MessageHeader() {
+    // 连同填充字节一起清零，保证序列化结果确定
+    std::memset(this, 0, sizeof(*this));
+    magic = kMagic;
+    version = kVersion;
+    type = MessageType::UNKNOWN;
+    priority = MessagePriority::NORMAL;
+    setTimestamp();
+}
+
+void MessageHeader::setTimestamp() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+bool MessageHeader::isValid() const {
+    return magic == kMagic && version == kVersion;
+}
+
+uint32_t MessageHeader::calculateChecksum(const void* payload) const {
+    if (payload == nullptr || payload_size == 0) {
+        return 0;
+    }
+    return crc32c(0, payload, payload_size);
+}
+
+bool MessageHeader::verifyChecksum(const void* payload, bool trusted_transport) const {
+    if (trusted_transport && hasFlag(kFlagNoChecksum)) {
+        return true;
+    }
+    return checksum == calculateChecksum(payload);
+}
+
+void MessageHeader::setTraceContext(const trace::TraceContext& ctx) {
+    if (!ctx.sampled()) {
+        setFlag(kFlagTraced, false);
+        std::memset(reserved, 0, sizeof(reserved));
+        return;
+    }
+    reserved[0] = static_cast<uint32_t>(ctx.trace_id);
+    reserved[1] = static_cast<uint32_t>(ctx.trace_id >> 32);
+    reserved[2] = ctx.span_id;
+    setFlag(kFlagTraced);
+}
+
+trace::TraceContext MessageHeader::getTraceContext() const {
+    trace::TraceContext ctx;
+    if (hasFlag(kFlagTraced)) {
+        ctx.trace_id = (static_cast<uint64_t>(reserved[1]) << 32) | reserved[0];
+        ctx.span_id = reserved[2];
+    }
+    return ctx;
+}
+
+void MessageHeader::injectCurrentTrace() {
+    const trace::TraceContext ctx = trace::Tracer::current();
+    if (ctx.sampled()) setTraceContext(ctx);
+}
+
+trace::TraceContext MessageHeader::outgoingTraceParent() const {
+    const trace::TraceContext current = trace::Tracer::current();
+    if (current.sampled()) return current;
+    return trace::Tracer::continueOrStart(getTraceContext());
+}
+
+void MessageHeader::extractTrace(const char* name) {
+    const trace::TraceContext parent = getTraceContext();
+    if (!parent.sampled()) return;
+    trace::Span span(name, parent, name);
+    setTraceContext(span.context());
+}
+
+// ==================== SerializedData ====================
+// 多字节数值按主机字节序写入（目标平台x86/ARM均为小端）
+
+SerializedData::SerializedData() : buffer_(nullptr), size_(0), capacity_(0), read_pos_(0) {
+}
+
+SerializedData::SerializedData(size_t reserve_size) : SerializedData() {
+    reserve(reserve_size);
+}
+
+SerializedData::SerializedData(const std::vector<uint8_t>& data) : SerializedData(data.data(), data.size()) {
+}
+
+SerializedData::SerializedData(const void* data, size_t size) : SerializedData() {
+    if (data != nullptr && size > 0) {
+        writeBytes(data, size);
+    }
+}
+
+SerializedData::SerializedData(PooledBuffer&& buffer)
+    : buffer_(buffer.data()), size_(buffer.size()), capacity_(buffer.capacity()), read_pos_(0) {
+    buffer.release();
+}
+
+SerializedData::~SerializedData() {
+    BufferPool::deallocate(buffer_, capacity_);
+}
+
+SerializedData::SerializedData(const SerializedData& other) : SerializedData(other.buffer_, other.size_) {
+    read_pos_ = other.read_pos_;
+}
+
+SerializedData& SerializedData::operator=(const SerializedData& other) {
+    if (this != &other) {
+        size_ = 0;
+        if (other.size_ > 0) {
+            writeBytes(other.buffer_, other.size_);
+        }
+        read_pos_ = other.read_pos_;
+    }
+    return *this;
+}
+
+SerializedData::SerializedData(SerializedData&& other) noexcept
+    : buffer_(other.buffer_), size_(other.size_), capacity_(other.capacity_), read_pos_(other.read_pos_) {
+    other.buffer_ = nullptr;
+    other.size_ = other.capacity_ = other.read_pos_ = 0;
+}
+
+SerializedData& SerializedData::operator=(SerializedData&& other) noexcept {
+    if (this != &other) {
+        BufferPool::deallocate(buffer_, capacity_);
+        buffer_ = other.buffer_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        read_pos_ = other.read_pos_;
+        other.buffer_ = nullptr;
+        other.size_ = other.capacity_ = other.read_pos_ = 0;
+    }
+    return *this;
+}
+
+PooledBuffer SerializedData::release() {
+    PooledBuffer out(buffer_, size_, capacity_);
+    buffer_ = nullptr;
+    size_ = capacity_ = read_pos_ = 0;
+    return out;
+}
+
+void SerializedData::writeUInt8(uint8_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeUInt16(uint16_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeUInt32(uint32_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeUInt64(uint64_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeInt8(int8_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeInt16(int16_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeInt32(int32_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeInt64(int64_t value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeFloat(float value) { writeBytes(&value, sizeof(value)); }
+void SerializedData::writeDouble(double value) { writeBytes(&value, sizeof(value)); }
+
+void SerializedData::writeString(const std::string& value) {
+    writeUInt32(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size());
+}
+
+void SerializedData::writeBytes(const void* data, size_t size) {
+    if (size == 0) return;
+    ensureSpace(size);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::memcpy(buffer_ + size_, bytes, size);
+    size_ += size;
+}
+
+void SerializedData::writeBool(bool value) {
+    writeUInt8(value ? 1 : 0);
+}
+
+namespace {
+
+template<typename T>
+T readValue(const uint8_t* buffer, size_t& pos) {
+    T value;
+    std::memcpy(&value, buffer + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+} // namespace
+
+uint8_t SerializedData::readUInt8() { checkReadBounds(1); return readValue<uint8_t>(buffer_, read_pos_); }
+uint16_t SerializedData::readUInt16() { checkReadBounds(2); return readValue<uint16_t>(buffer_, read_pos_); }
+uint32_t SerializedData::readUInt32() { checkReadBounds(4); return readValue<uint32_t>(buffer_, read_pos_); }
+uint64_t SerializedData::readUInt64() { checkReadBounds(8); return readValue<uint64_t>(buffer_, read_pos_); }
+int8_t SerializedData::readInt8() { checkReadBounds(1); return readValue<int8_t>(buffer_, read_pos_); }
+int16_t SerializedData::readInt16() { checkReadBounds(2); return readValue<int16_t>(buffer_, read_pos_); }
+int32_t SerializedData::readInt32() { checkReadBounds(4); return readValue<int32_t>(buffer_, read_pos_); }
+int64_t SerializedData::readInt64() { checkReadBounds(8); return readValue<int64_t>(buffer_, read_pos_); }
+float SerializedData::readFloat() { checkReadBounds(4); return readValue<float>(buffer_, read_pos_); }
+double SerializedData::readDouble() { checkReadBounds(8); return readValue<double>(buffer_, read_pos_); }
+
+std::string SerializedData::readString() {
+    uint32_t length = readUInt32();
+    checkReadBounds(length);
+    std::string value(reinterpret_cast<const char*>(buffer_ + read_pos_), length);
+    read_pos_ += length;
+    return value;
+}
+
+std::string_view SerializedData::readStringView() {
+    uint32_t length = readUInt32();
+    checkReadBounds(length);
+    std::string_view value(reinterpret_cast<const char*>(buffer_ + read_pos_), length);
+    read_pos_ += length;
+    return value;
+}
+
+std::vector<uint8_t> SerializedData::readBytes(size_t size) {
+    checkReadBounds(size);
+    std::vector<uint8_t> value(buffer_ + read_pos_, buffer_ + read_pos_ + size);
+    read_pos_ += size;
+    return value;
+}
+
+ByteSpan SerializedData::readBytesSpan(size_t size) {
+    checkReadBounds(size);
+    ByteSpan value{buffer_ + read_pos_, size};
+    read_pos_ += size;
+    return value;
+}
+
+bool SerializedData::readBool() {
+    return readUInt8() != 0;
+}
+
+// 保留缓冲区，下一条消息复用
+void SerializedData::clear() {
+    size_ = 0;
+    read_pos_ = 0;
+}
+
+void SerializedData::reserve(size_t size) {
+    if (size <= capacity_) {
+        return;
+    }
+    size_t new_capacity = 0;
+    uint8_t* new_buffer = BufferPool::allocate(size, &new_capacity);
+    if (size_ > 0) {
+        std::memcpy(new_buffer, buffer_, size_);
+    }
+    BufferPool::deallocate(buffer_, capacity_);
+    buffer_ = new_buffer;
+    capacity_ = new_capacity;
+}
+
+void SerializedData::resize(size_t size) {
+    if (size > size_) {
+        ensureSpace(size - size_);
+        std::memset(buffer_ + size_, 0, size - size_);
+    }
+    size_ = size;
+    if (read_pos_ > size) {
+        read_pos_ = size;
+    }
+}
+
+void SerializedData::ensureSpace(size_t needed) {
+    size_t required = size_ + needed;
+    if (required > capacity_) {
+        // 按倍数扩容，避免逐字段写入时频繁重新分配；池内容量本身是2的幂
+        reserve(std::max(required, capacity_ * 2));
+    }
+}
+
+void SerializedData::checkReadBounds(size_t needed) const {
+    if (needed > size_ - read_pos_) {
+        throw std::out_of_range("SerializedData: read " + std::to_string(needed) +
+                                " bytes at " + std::to_string(read_pos_) +
+                                ", size " + std::to_string(size_));
+    }
+}
+
+// ==================== Message ====================
+
+Message::Message() {
+}
+
+Message::Message(MessageType type) {
+    header_.type = type;
+}
+
+Message::Message(MessageType type, const std::string& data) {
+    header_.type = type;
+    setPayload(data);
+}
+
+void Message::setSenderId(const std::string& id) {
+    std::memset(header_.sender_id, 0, sizeof(header_.sender_id));
+    std::memcpy(header_.sender_id, id.data(), std::min(id.size(), sizeof(header_.sender_id) - 1));
+}
+
+std::string Message::getSenderId() const {
+    return std::string(header_.sender_id, strnlen(header_.sender_id, sizeof(header_.sender_id)));
+}
+
+void Message::setReceiverId(const std::string& id) {
+    std::memset(header_.receiver_id, 0, sizeof(header_.receiver_id));
+    std::memcpy(header_.receiver_id, id.data(), std::min(id.size(), sizeof(header_.receiver_id) - 1));
+}
+
+std::string Message::getReceiverId() const {
+    return std::string(header_.receiver_id, strnlen(header_.receiver_id, sizeof(header_.receiver_id)));
+}
+
+void Message::setPayload(const std::string& data) {
+    setPayload(data.data(), data.size());
+}
+
+void Message::setPayload(const void* data, size_t size) {
+    payload_ = SerializedData(data, size);
+    header_.payload_size = static_cast<uint32_t>(size);
+}
+
+SerializedData Message::takePayload() {
+    SerializedData out(std::move(payload_));
+    header_.payload_size = 0;
+    return out;
+}
+
+std::vector<uint8_t> Message::serialize() const {
+    MessageHeader header = header_;
+    header.payload_size = static_cast<uint32_t>(payload_.size());
+
+    std::vector<uint8_t> out(sizeof(MessageHeader) + payload_.size());
+    std::memcpy(out.data(), &header, sizeof(MessageHeader));
+    if (payload_.size() > 0) {
+        std::memcpy(out.data() + sizeof(MessageHeader), payload_.data(), payload_.size());
+    }
+    return out;
+}
+
+bool Message::deserialize(const std::vector<uint8_t>& data) {
+    return deserialize(data.data(), data.size());
+}
+
+bool Message::deserialize(const void* data, size_t size) {
+    if (data == nullptr || size < sizeof(MessageHeader)) {
+        return false;
+    }
+
+    MessageHeader header;
+    std::memcpy(&header, data, sizeof(MessageHeader));
+    if (!header.isValid() || size - sizeof(MessageHeader) != header.payload_size) {
+        return false;
+    }
+
+    header_ = header;
+    payload_ = SerializedData(static_cast<const uint8_t*>(data) + sizeof(MessageHeader),
+                              header.payload_size);
+    return true;
+}
+
+bool Message::validate(bool trusted_transport) const {
+    if (!header_.isValid() || header_.payload_size != payload_.size()) {
+        return false;
+    }
+    return header_.verifyChecksum(payload_.data(), trusted_transport);
+}
+
+void Message::updateChecksum() {
+    header_.payload_size = static_cast<uint32_t>(payload_.size());
+    header_.checksum = isChecksumEnabled() ? header_.calculateChecksum(payload_.data()) : 0;
+}
+
+size_t Message::getTotalSize() const {
+    return sizeof(MessageHeader) + payload_.size();
+}
+
+std::string Message::toString() const {
+    std::ostringstream oss;
+    oss << "Message{type=" << MessageDebugger::messageTypeToString(header_.type)
+        << ", priority=" << MessageDebugger::priorityToString(header_.priority)
+        << ", seq=" << header_.sequence_id
+        << ", sender=" << getSenderId()
+        << ", receiver=" << getReceiverId()
+        << ", payload=" << payload_.size() << " bytes}";
+    return oss.str();
+}
+
+Message Message::createRequest(const std::string& data) {
+    return Message(MessageType::REQUEST, data);
+}
+
+Message Message::createResponse(const std::string& data) {
+    return Message(MessageType::RESPONSE, data);
+}
+
+Message Message::createNotification(const std::string& data) {
+    return Message(MessageType::NOTIFICATION, data);
+}
+
+Message Message::createHeartbeat() {
+    Message msg(MessageType::HEARTBEAT);
+    msg.setPriority(MessagePriority::LOW);
+    return msg;
+}
+
+Message Message::createError(const std::string& error_msg) {
+    Message msg(MessageType::ERROR, error_msg);
+    msg.setPriority(MessagePriority::HIGH);
+    return msg;
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
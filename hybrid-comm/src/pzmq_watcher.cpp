@@ -0,0 +1,160 @@
+#include "../include/pzmq_watcher.h"
+#include "../include/pzmq.hpp"
+#include "network/Channel.h"
+#include "network/EventLoop.h"
+#include <future>
+#include <iostream>
+
+namespace edge_infra {
+namespace hybrid_comm {
+
+const int ZmqWatcher::kMaxEventsPerWakeup;
+
+ZmqWatcher::ZmqWatcher(network::EventLoop* loop, void* socket, std::mutex* socket_mutex, const std::string& name)
+    : loop_(loop),
+      socket_(socket),
+      socket_mutex_(socket_mutex),
+      name_(name),
+      want_write_(false),
+      recheck_queued_(false) {
+}
+
+ZmqWatcher::ZmqWatcher(network::EventLoop* loop, ZmqSocket& socket, std::mutex* socket_mutex)
+    : ZmqWatcher(loop, socket.handle(), socket_mutex, socket.getEndpoint()) {
+}
+
+ZmqWatcher::~ZmqWatcher() {
+    // 只能在loop线程或loop已停止时析构，否则应先调用stop()
+    if (channel_) {
+        channel_->disableAll();
+        channel_->remove();
+    }
+}
+
+void ZmqWatcher::start() {
+    auto self = shared_from_this();
+    loop_->runInLoop([self]() { self->startInLoop(); });
+}
+
+void ZmqWatcher::stop() {
+    if (loop_->isInLoopThread()) {
+        stopInLoop();
+        return;
+    }
+    auto self = shared_from_this();
+    std::promise<void> done;
+    std::future<void> finished = done.get_future();
+    loop_->queueInLoop([self, &done]() {
+        self->stopInLoop();
+        done.set_value();
+    });
+    finished.wait();
+}
+
+void ZmqWatcher::startInLoop() {
+    loop_->assertInLoopThread();
+    if (channel_) return;
+
+    int fd = -1;
+    size_t fd_size = sizeof(fd);
+    {
+        std::unique_lock<std::mutex> lock;
+        if (socket_mutex_ != nullptr) {
+            lock = std::unique_lock<std::mutex>(*socket_mutex_);
+        }
+        if (zmq_getsockopt(socket_, ZMQ_FD, &fd, &fd_size) != 0) {
+            std::cerr << "[ZmqWatcher " << name_ << "] ZMQ_FD failed: " << zmq_strerror(zmq_errno()) << std::endl;
+            return;
+        }
+    }
+
+    channel_.reset(new network::Channel(loop_, fd));
+    channel_->setDebugName("zmq " + name_);
+    // ZMQ_FD只会变为可读，可写性也要通过ZMQ_EVENTS判断
+    std::weak_ptr<ZmqWatcher> weak = shared_from_this();
+    channel_->setReadCallback([weak]() {
+        if (auto self = weak.lock()) self->handleEvents();
+    });
+    channel_->enableReading();
+
+    // 注册前已到达的消息不会再产生通知
+    handleEvents();
+}
+
+void ZmqWatcher::stopInLoop() {
+    loop_->assertInLoopThread();
+    if (!channel_) return;
+    channel_->disableAll();
+    channel_->remove();
+    channel_.reset();
+}
+
+void ZmqWatcher::enableWriting() {
+    loop_->assertInLoopThread();
+    want_write_ = true;
+    recheck();
+}
+
+void ZmqWatcher::disableWriting() {
+    loop_->assertInLoopThread();
+    want_write_ = false;
+}
+
+void ZmqWatcher::recheck() {
+    std::weak_ptr<ZmqWatcher> weak = shared_from_this();
+    if (loop_->isInLoopThread()) {
+        // 回调中调用时合并成一次排队，避免在handleEvents里递归
+        if (recheck_queued_) return;
+        recheck_queued_ = true;
+    }
+    loop_->queueInLoop([weak]() {
+        if (auto self = weak.lock()) {
+            self->recheck_queued_ = false;
+            self->handleEvents();
+        }
+    });
+}
+
+int ZmqWatcher::queryEvents() const {
+    int events = 0;
+    size_t size = sizeof(events);
+    std::unique_lock<std::mutex> lock;
+    if (socket_mutex_ != nullptr) {
+        lock = std::unique_lock<std::mutex>(*socket_mutex_);
+    }
+    if (zmq_getsockopt(socket_, ZMQ_EVENTS, &events, &size) != 0) {
+        return 0;
+    }
+    return events;
+}
+
+void ZmqWatcher::handleEvents() {
+    if (!channel_) return;
+
+    int budget = kMaxEventsPerWakeup;
+    int events = queryEvents();
+    while (budget > 0 && channel_) {
+        const bool readable = (events & ZMQ_POLLIN) && readable_callback_;
+        const bool writable = (events & ZMQ_POLLOUT) && want_write_ && writable_callback_;
+        if (!readable && !writable) {
+            return;
+        }
+        if (readable) {
+            readable_callback_();
+        }
+        if (writable && want_write_) {
+            writable_callback_();
+        }
+        --budget;
+        events = queryEvents();
+    }
+
+    // 预算用完时fd不会再次通知，主动排到下一轮
+    if (channel_ && (((events & ZMQ_POLLIN) && readable_callback_) ||
+                     ((events & ZMQ_POLLOUT) && want_write_ && writable_callback_))) {
+        recheck();
+    }
+}
+
+} // namespace hybrid_comm
+} // namespace edge_infra
@@ -0,0 +1,61 @@
+#include "pzmq_codec.h"
+#include "test_check.h"
+#include <cstring>
+#include <string>
+
+using namespace edge_infra::hybrid_comm;
+
+namespace {
+
+std::string frameBytes(const MessageHeader& header, const std::string& payload) {
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes += payload;
+    return bytes;
+}
+
+MessageCodec::DecodeResult decode(const std::string& bytes) {
+    MessageCodec codec;
+    Message frame;
+    size_t consumed = 0;
+    std::string error;
+    return codec.decodeFrame(bytes.data(), bytes.size(), &frame, &consumed, &error);
+}
+
+// 对端在TCP上置kFlagNoChecksum不能关闭校验
+void testPeerCannotDisableChecksum() {
+    const std::string payload = "payload";
+    MessageHeader header;
+    header.payload_size = static_cast<uint32_t>(payload.size());
+    header.checksum = header.calculateChecksum(payload.data());
+    EDGE_CHECK(decode(frameBytes(header, payload)) == MessageCodec::kFrame);
+
+    std::string corrupted = payload;
+    corrupted[0] ^= 0x01;
+    EDGE_CHECK(decode(frameBytes(header, corrupted)) == MessageCodec::kError);
+
+    header.setFlag(MessageHeader::kFlagNoChecksum);
+    header.checksum = 0;
+    EDGE_CHECK(decode(frameBytes(header, corrupted)) == MessageCodec::kError);
+}
+
+// 只有接收端自己的传输可信时才采信免校验标志
+void testTrustDependsOnReceiver() {
+    Message msg(MessageType::REQUEST, "payload");
+    msg.setChecksumEnabled(false);
+    msg.updateChecksum();
+    EDGE_CHECK(msg.validate(true));
+    EDGE_CHECK(!msg.validate(false));
+
+    msg.setChecksumEnabled(true);
+    msg.updateChecksum();
+    EDGE_CHECK(msg.validate(false));
+    EDGE_CHECK(msg.validate(true));
+}
+
+} // namespace
+
+int main() {
+    testPeerCannotDisableChecksum();
+    testTrustDependsOnReceiver();
+    return edge_infra::testing::report("checksum_test");
+}
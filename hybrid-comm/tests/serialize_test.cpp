@@ -0,0 +1,120 @@
+#include "pzmq_serialize.h"
+#include "test_check.h"
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace edge_infra::hybrid_comm;
+
+namespace {
+
+struct Item {
+    uint32_t id = 0;
+    std::string name;
+    PZMQ_FIELDS(id, name)
+};
+
+using Empties = std::vector<std::array<uint8_t, 0>>;
+
+template<typename T>
+bool throwsOutOfRange(SerializedData& data) {
+    try {
+        data.deserialize<T>();
+    } catch (const std::out_of_range&) {
+        return true;
+    } catch (...) {
+        return false;
+    }
+    return false;
+}
+
+// 对端给出超大count时应在resize前抛出out_of_range，而不是bad_alloc
+void testOversizedCountIsRejected() {
+    SerializedData strings;
+    strings.writeUInt32(0xFFFFFFF0u);
+    strings.writeString("a");
+    EDGE_CHECK(throwsOutOfRange<std::vector<std::string>>(strings));
+
+    SerializedData items;
+    items.writeUInt32(0xFFFFFFF0u);
+    items.writeUInt32(1);
+    items.writeString("a");
+    EDGE_CHECK(throwsOutOfRange<std::vector<Item>>(items));
+
+    SerializedData nested;
+    nested.writeUInt32(0x7FFFFFFFu);
+    nested.writeUInt32(0);
+    EDGE_CHECK(throwsOutOfRange<std::vector<std::vector<uint8_t>>>(nested));
+
+    SerializedData raw;
+    raw.writeUInt32(0xFFFFFFF0u);
+    raw.writeUInt64(1);
+    EDGE_CHECK(throwsOutOfRange<std::vector<uint64_t>>(raw));
+}
+
+// count > 剩余字节 / kMinSize 的边界：恰好容得下时照常解码，多一个即拒绝
+void testCountBoundary() {
+    SerializedData fits;
+    fits.writeUInt32(2);
+    fits.writeString("");
+    fits.writeString("");
+    const std::vector<std::string> decoded = fits.deserialize<std::vector<std::string>>();
+    EDGE_CHECK(decoded.size() == 2);
+
+    SerializedData one_over;
+    one_over.writeUInt32(3);
+    one_over.writeString("");
+    one_over.writeString("");
+    EDGE_CHECK(throwsOutOfRange<std::vector<std::string>>(one_over));
+}
+
+// count与实际元素数不符时抛出，读位置保持不变
+void testTruncatedVectorKeepsReadPosition() {
+    SerializedData data;
+    data.writeUInt32(3);
+    data.writeString("first");
+    data.writeString("second");
+    EDGE_CHECK(throwsOutOfRange<std::vector<std::string>>(data));
+    EDGE_CHECK(data.readUInt32() == 3);
+}
+
+// 元素编码可能为0字节时不按剩余长度限制count，由固定上限拒绝伪造的count
+void testZeroSizeElements() {
+    using Codec = edge_infra::hybrid_comm::serialization::FieldCodec<Empties>;
+
+    SerializedData data;
+    data.serialize(Empties(5));
+    EDGE_CHECK(data.deserialize<Empties>().size() == 5);
+
+    SerializedData at_limit;
+    at_limit.writeUInt32(Codec::kMaxZeroSizeCount);
+    EDGE_CHECK(at_limit.deserialize<Empties>().size() == Codec::kMaxZeroSizeCount);
+
+    SerializedData forged;
+    forged.writeUInt32(0xFFFFFFF0u);
+    EDGE_CHECK(throwsOutOfRange<Empties>(forged));
+    EDGE_CHECK(forged.readUInt32() == 0xFFFFFFF0u);
+}
+
+void testRoundTrip() {
+    std::vector<Item> items{{1, "alpha"}, {2, ""}, {3, "gamma"}};
+    SerializedData data;
+    data.serialize(items);
+    const auto decoded = data.deserialize<std::vector<Item>>();
+    EDGE_REQUIRE(decoded.size() == 3);
+    EDGE_CHECK(decoded[0].id == 1 && decoded[0].name == "alpha");
+    EDGE_CHECK(decoded[1].id == 2 && decoded[1].name.empty());
+    EDGE_CHECK(decoded[2].id == 3 && decoded[2].name == "gamma");
+}
+
+} // namespace
+
+int main() {
+    testOversizedCountIsRejected();
+    testCountBoundary();
+    testTruncatedVectorKeepsReadPosition();
+    testZeroSizeElements();
+    testRoundTrip();
+    return edge_infra::testing::report("serialize_test");
+}
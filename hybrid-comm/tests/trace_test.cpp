@@ -0,0 +1,138 @@
+#include "pzmq_codec.h"
+#include "network/OutputQueue.h"
+#include "test_check.h"
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace edge_infra;
+using namespace edge_infra::hybrid_comm;
+
+namespace {
+
+// 经管道取出编码结果，得到对端收到的字节流
+std::string drain(network::OutputQueue& out) {
+    int fds[2];
+    std::string bytes;
+    if (::pipe(fds) != 0) {
+        EDGE_CHECK(!"pipe failed");
+        return bytes;
+    }
+    int saved_errno = 0;
+    const ssize_t written = out.writeTo(fds[1], &saved_errno);
+    EDGE_CHECK(written > 0 && out.empty());
+    if (written > 0) {
+        bytes.resize(static_cast<size_t>(written));
+        const ssize_t got = ::read(fds[0], &bytes[0], bytes.size());
+        EDGE_CHECK(got == written);
+    }
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return bytes;
+}
+
+Message roundTrip(MessageCodec& codec, const Message& msg) {
+    network::OutputQueue out;
+    codec.encodeFrame(msg, &out);
+    const std::string bytes = drain(out);
+    Message received;
+    size_t consumed = 0;
+    std::string error;
+    const MessageCodec::DecodeResult result =
+        codec.decodeFrame(bytes.data(), bytes.size(), &received, &consumed, &error);
+    EDGE_CHECK(result == MessageCodec::kFrame);
+    EDGE_CHECK(consumed == bytes.size());
+    return received;
+}
+
+const trace::SpanRecord* findSpan(const std::vector<trace::SpanRecord>& spans, const std::string& name) {
+    for (const trace::SpanRecord& span : spans) {
+        if (name == span.name) return &span;
+    }
+    return nullptr;
+}
+
+// request -> tcp.send -> tcp.recv -> handle 逐级成为父子
+void testRoundTripLinksSpans() {
+    MessageCodec codec;
+    Message msg(MessageType::REQUEST, "payload");
+    uint32_t request_span_id = 0;
+    uint64_t trace_id = 0;
+    Message received;
+    {
+        trace::Span request("request", trace::Tracer::startTrace());
+        EDGE_CHECK(request.active());
+        request_span_id = request.context().span_id;
+        trace_id = request.context().trace_id;
+        received = roundTrip(codec, msg);
+    }
+    {
+        trace::Span handle("handle", received.getHeader().getTraceContext());
+        EDGE_CHECK(handle.active());
+    }
+
+    const std::vector<trace::SpanRecord> spans = trace::Tracer::collect();
+    const trace::SpanRecord* send = findSpan(spans, "tcp.send");
+    const trace::SpanRecord* recv = findSpan(spans, "tcp.recv");
+    const trace::SpanRecord* handle = findSpan(spans, "handle");
+    EDGE_REQUIRE(send && recv && handle);
+    EDGE_CHECK(send->trace_id == trace_id && recv->trace_id == trace_id && handle->trace_id == trace_id);
+    EDGE_CHECK(send->parent_span_id == request_span_id);
+    EDGE_CHECK(recv->parent_span_id == send->span_id);
+    EDGE_CHECK(handle->parent_span_id == recv->span_id);
+}
+
+// 转发已带上下文的头部时，新的发送span接在本跳当前span之下，而不是沿用上游
+void testForwardOverwritesUpstreamContext() {
+    MessageCodec codec;
+    Message upstream;
+    {
+        trace::Span request("request", trace::Tracer::startTrace());
+        upstream = roundTrip(codec, Message(MessageType::REQUEST, "payload"));
+    }
+    trace::Tracer::collect();
+
+    uint32_t forward_span_id = 0;
+    Message forwarded;
+    {
+        trace::Span forward("forward", upstream.getHeader().getTraceContext());
+        forward_span_id = forward.context().span_id;
+        forwarded = roundTrip(codec, upstream);
+    }
+    const std::vector<trace::SpanRecord> spans = trace::Tracer::collect();
+    const trace::SpanRecord* send = findSpan(spans, "tcp.send");
+    const trace::SpanRecord* recv = findSpan(spans, "tcp.recv");
+    EDGE_REQUIRE(send && recv);
+    EDGE_CHECK(send->parent_span_id == forward_span_id);
+    EDGE_CHECK(recv->parent_span_id == send->span_id);
+    EDGE_CHECK(forwarded.getHeader().getTraceContext().span_id == recv->span_id);
+}
+
+// 不在请求中发送时按采样率开始新追踪，发送span为根
+void testSendStartsTraceWhenSampled() {
+    MessageCodec codec;
+    const Message received = roundTrip(codec, Message(MessageType::REQUEST, "payload"));
+    const std::vector<trace::SpanRecord> spans = trace::Tracer::collect();
+    const trace::SpanRecord* send = findSpan(spans, "tcp.send");
+    const trace::SpanRecord* recv = findSpan(spans, "tcp.recv");
+    EDGE_REQUIRE(send && recv);
+    EDGE_CHECK(send->parent_span_id == 0);
+    EDGE_CHECK(recv->trace_id == send->trace_id && recv->parent_span_id == send->span_id);
+    EDGE_CHECK(received.getHeader().getTraceContext().sampled());
+
+    trace::Tracer::setSampleEvery(0);
+    const Message untraced = roundTrip(codec, Message(MessageType::REQUEST, "payload"));
+    EDGE_CHECK(!untraced.getHeader().getTraceContext().sampled());
+    EDGE_CHECK(trace::Tracer::collect().empty());
+    trace::Tracer::setSampleEvery(1);
+}
+
+} // namespace
+
+int main() {
+    trace::Tracer::setSampleEvery(1);
+    testRoundTripLinksSpans();
+    testForwardOverwritesUpstreamContext();
+    testSendStartsTraceWhenSampled();
+    return edge_infra::testing::report("trace_test");
+}
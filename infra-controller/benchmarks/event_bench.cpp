@@ -0,0 +1,109 @@
+#include "StackFlow.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace edge_infra::infra_controller;
+
+// 事件发布吞吐与主题构造开销的基准。
+// 用法：event_bench [producers] [events_per_producer]
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 多个生产者各发布events个带两条元数据的事件，计时到全部被处理
+template<typename Publish>
+double publishRate(int producers, int events, Publish publish) {
+    StackFlow flow("bench");
+    std::atomic<long> handled{0};
+    flow.registerHandler(EventType::MESSAGE_RECEIVED, std::make_shared<SimpleEventHandler>(
+        "count", std::vector<EventType>{EventType::MESSAGE_RECEIVED}, [&handled](const Event& event) {
+            if (!event.getData("session").empty()) handled.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }));
+    flow.start();
+
+    const long total = static_cast<long>(producers) * events;
+    const Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&flow, &publish, p, events] {
+            const InternedString source("unit.llm." + std::to_string(p));
+            const InternedString target("inference");
+            for (int i = 0; i < events; ++i) {
+                publish(flow, source, target);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    while (handled.load(std::memory_order_relaxed) < total) {
+        std::this_thread::yield();
+    }
+    const double seconds = secondsSince(start);
+    flow.stop();
+    return total / seconds;
+}
+
+// 发送路径上的主题构造（同ZmqChannel::send(content, topic)）：已注册主题命中驻留表，会话级主题走lookupOrCopy且不进入驻留表
+double topicRate(int count, bool registered) {
+    std::vector<std::string> topics;
+    topics.reserve(1024);
+    for (int i = 0; i < 1024; ++i) {
+        topics.push_back(registered ? "model.output" : "session." + std::to_string(i) + ".output");
+    }
+    const InternedString route("model.output");
+    size_t matched = 0;
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        const InternedString topic = InternedString::lookupOrCopy(topics[static_cast<size_t>(i) & 1023]);
+        if (topic == route) ++matched;
+    }
+    const double seconds = secondsSince(start);
+    // 同时检查结果，避免循环被优化掉
+    if (matched != (registered ? static_cast<size_t>(count) : 0)) {
+        std::fprintf(stderr, "topic: unexpected match count %zu\n", matched);
+    }
+    return count / seconds;
+}
+
+void report(const char* name, double rate, const char* unit) {
+    std::printf("%-24s %8.3f M %s/s\n", name, rate / 1e6, unit);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int producers = argc > 1 ? std::atoi(argv[1]) : 4;
+    const int events = argc > 2 ? std::atoi(argv[2]) : 250000;
+    if (producers <= 0 || events <= 0) {
+        std::fprintf(stderr, "usage: %s [producers] [events_per_producer]\n", argv[0]);
+        return 1;
+    }
+    std::printf("producers=%d events_per_producer=%d\n", producers, events);
+
+    report("publish(Event&&)", publishRate(producers, events,
+        [](StackFlow& flow, const InternedString& source, const InternedString& target) {
+            Event event(EventType::MESSAGE_RECEIVED, source, target);
+            event.setData("session", "sess-12");
+            event.setData("model", "qwen");
+            flow.publishEvent(std::move(event));
+        }), "events");
+    report("publish(const Event&)", publishRate(producers, events,
+        [](StackFlow& flow, const InternedString& source, const InternedString& target) {
+            Event event(EventType::MESSAGE_RECEIVED, source, target);
+            event.setData("session", "sess-12");
+            event.setData("model", "qwen");
+            flow.publishEvent(static_cast<const Event&>(event));
+        }), "events");
+    report("topic(registered)", topicRate(producers * events, true), "messages");
+    report("topic(session)", topicRate(producers * events, false), "messages");
+    return 0;
+}
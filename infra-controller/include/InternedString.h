@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 进程内驻留的不可变字符串。
+// 相同内容只保存一份，对象本身只是一个指针：拷贝不分配内存，比较是指针比较，哈希值预先算好。
+// 驻留的字符串永不释放，只适合本地注册的有限取值（单元名、订阅的主题、元数据键），不要用于消息ID等唯一值。
+// 来自网络或共享内存的名字用lookupOrCopy()：未驻留时得到一份引用计数的独立副本，不进入驻留表
+class InternedString {
+public:
+    struct Entry {
+        std::string str;
+        size_t hash;
+        bool interned;                            // false表示独立副本，由refs管理生命周期
+        mutable std::atomic<size_t> refs;
+
+        Entry(std::string s, size_t h, bool in) : str(std::move(s)), hash(h), interned(in), refs(1) {}
+    };
+
+private:
+    const Entry* entry_;
+
+public:
+    InternedString();
+    explicit InternedString(std::string_view str);
+    InternedString(const std::string& str) : InternedString(std::string_view(str)) {}
+    InternedString(const char* str) : InternedString(std::string_view(str != nullptr ? str : "")) {}
+    ~InternedString() { release(); }
+
+    InternedString(const InternedString& other) : entry_(other.entry_) { retain(); }
+    InternedString& operator=(const InternedString& other) {
+        if (entry_ != other.entry_) {
+            other.retain();
+            release();
+            entry_ = other.entry_;
+        }
+        return *this;
+    }
+
+    // 只查找不驻留：已驻留时写入out并返回true
+    static bool find(std::string_view str, InternedString* out);
+    // 已驻留时返回驻留项，否则返回不进入驻留表的独立副本，用于处理接收到的主题和元数据键
+    static InternedString lookupOrCopy(std::string_view str);
+
+    const std::string& str() const { return entry_->str; }
+    operator const std::string&() const { return entry_->str; }
+    const char* c_str() const { return entry_->str.c_str(); }
+    size_t size() const { return entry_->str.size(); }
+    bool empty() const { return entry_->str.empty(); }
+    size_t hash() const { return entry_->hash; }
+    bool isInterned() const { return entry_->interned; }
+
+    // 两个驻留项之间是指针比较；有独立副本参与时比较内容
+    bool operator==(const InternedString& other) const {
+        return entry_ == other.entry_ ||
+               (!(entry_->interned && other.entry_->interned) && entry_->str == other.entry_->str);
+    }
+    bool operator!=(const InternedString& other) const { return !(*this == other); }
+    bool operator==(std::string_view other) const { return entry_->str == other; }
+    bool operator!=(std::string_view other) const { return entry_->str != other; }
+    bool operator==(const std::string& other) const { return entry_->str == other; }
+    bool operator!=(const std::string& other) const { return entry_->str != other; }
+    bool operator==(const char* other) const { return entry_->str == other; }
+    bool operator!=(const char* other) const { return entry_->str != other; }
+    bool operator<(const InternedString& other) const { return entry_->str < other.entry_->str; }
+
+    // 已驻留的字符串数，用于监控驻留表是否异常增长
+    static size_t internedCount();
+
+private:
+    explicit InternedString(const Entry* entry) : entry_(entry) {}
+
+    void retain() const {
+        if (!entry_->interned) entry_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release() {
+        if (!entry_->interned && entry_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete entry_;
+        }
+    }
+};
+
+inline bool operator==(const std::string& lhs, const InternedString& rhs) { return rhs == lhs; }
+inline bool operator!=(const std::string& lhs, const InternedString& rhs) { return rhs != lhs; }
+inline bool operator==(const char* lhs, const InternedString& rhs) { return rhs == lhs; }
+inline bool operator!=(const char* lhs, const InternedString& rhs) { return rhs != lhs; }
+
+inline std::string operator+(const std::string& lhs, const InternedString& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const InternedString& lhs, const std::string& rhs) { return lhs.str() + rhs; }
+inline std::string operator+(const char* lhs, const InternedString& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const InternedString& lhs, const char* rhs) { return lhs.str() + rhs; }
+
+inline std::ostream& operator<<(std::ostream& os, const InternedString& s) {
+    return os << s.str();
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
+
+namespace std {
+template<>
+struct hash<edge_infra::infra_controller::InternedString> {
+    size_t operator()(const edge_infra::infra_controller::InternedString& s) const { return s.hash(); }
+};
+} // namespace std
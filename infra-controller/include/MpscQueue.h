@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ObjectPool.h"
+#include <atomic>
+#include <utility>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 多生产者单消费者无锁队列（Vyukov算法）
+// push可在任意线程调用，只需一次原子exchange；tryPop只能由唯一的消费者线程调用。
+// 节点从ObjectPool取用并回收，稳定运行时入队出队不再分配内存
+template<typename T>
+class MpscQueue {
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    using NodePool = ObjectPool<Node>;
+
+    alignas(64) std::atomic<Node*> head_;  // 生产者端
+    alignas(64) Node* tail_;               // 消费者端，tail_本身是哑节点
+
+public:
+    MpscQueue() {
+        Node* stub = NodePool::acquire();
+        stub->next.store(nullptr, std::memory_order_relaxed);
+        head_.store(stub, std::memory_order_relaxed);
+        tail_ = stub;
+    }
+
+    ~MpscQueue() {
+        Node* node = tail_;
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            NodePool::release(node);
+            node = next;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = NodePool::acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->value = std::move(value);
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // 生产者处于exchange与链接之间时可能短暂返回false，调用方应结合计数重试
+    bool tryPop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        out = std::move(next->value);
+        tail_ = next;
+        NodePool::release(tail);
+        return true;
+    }
+
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 按类型全局共享的对象池。
+// 每个线程持有一个本地缓存，acquire/release通常不加锁；本地缓存空了或满了时
+// 与全局空闲列表成批交换kBatch个对象，跨线程的生产者/消费者模式下每kBatch次操作才加一次锁。
+// 对象归还时不析构，下次取出时保留上次的状态（例如string的容量），由使用方负责重新赋值
+template<typename T>
+class ObjectPool {
+public:
+    static const size_t kBatch = 32;
+    static const size_t kLocalLimit = kBatch * 2;
+    static const size_t kGlobalLimit = 4096;
+
+    static T* acquire() {
+        LocalCache& local = localCache();
+        if (local.items.empty()) {
+            global().refill(local.items);
+            if (local.items.empty()) {
+                return new T();
+            }
+        }
+        T* obj = local.items.back();
+        local.items.pop_back();
+        return obj;
+    }
+
+    static void release(T* obj) {
+        if (obj == nullptr) return;
+        LocalCache& local = localCache();
+        local.items.push_back(obj);
+        if (local.items.size() >= kLocalLimit) {
+            global().drain(local.items, kBatch);
+        }
+    }
+
+private:
+    class GlobalList {
+    public:
+        void refill(std::vector<T*>& out) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const size_t n = items_.size() < kBatch ? items_.size() : kBatch;
+            out.insert(out.end(), items_.end() - static_cast<std::ptrdiff_t>(n), items_.end());
+            items_.resize(items_.size() - n);
+        }
+
+        // 从in的尾部移出count个对象，全局列表已满的部分直接释放
+        void drain(std::vector<T*>& in, size_t count) {
+            if (count > in.size()) count = in.size();
+            std::vector<T*> overflow;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (size_t i = 0; i < count; ++i) {
+                    T* obj = in.back();
+                    in.pop_back();
+                    if (items_.size() < kGlobalLimit) {
+                        items_.push_back(obj);
+                    } else {
+                        overflow.push_back(obj);
+                    }
+                }
+            }
+            for (T* obj : overflow) {
+                delete obj;
+            }
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<T*> items_;
+    };
+
+    struct LocalCache {
+        std::vector<T*> items;
+
+        ~LocalCache() {
+            // 线程退出时把缓存交还全局列表
+            global().drain(items, items.size());
+        }
+    };
+
+    static GlobalList& global() {
+        // 有意不析构，线程本地缓存可能在静态对象析构之后才归还
+        static GlobalList* list = new GlobalList();
+        return *list;
+    }
+
+    static LocalCache& localCache() {
+        thread_local LocalCache cache;
+        return cache;
+    }
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
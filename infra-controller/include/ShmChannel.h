@@ -0,0 +1,98 @@
+#pragma once
+
+#include "channel.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 基于POSIX共享内存环形缓冲区的同机通道，单向、多生产者单消费者。
+// endpoint为共享内存名：以'@'开头表示创建并接收（相当于bind），以'>'开头表示打开并发送
+// （相当于connect），都没有时默认打开并发送。双向通信使用两个通道。
+// 段内是定长的记录描述符环加一个字节环：生产者用一次CAS同时预留描述符和数据区，
+// 直接把消息写进共享内存后发布；消费者按顺序读取并释放，空闲时在futex上等待。
+// 大负载可以用sendInPlace直接写入环，接收端用PayloadHandler按偏移原地读取，全程不经过内核拷贝。
+// 生产者在预留之后、发布之前崩溃会使消费者停在该记录上，需要重建通道
+class ShmChannel : public Channel {
+public:
+    // msg.content为空，payload指向共享内存，仅在回调期间有效；offset为payload在段内的偏移，
+    // 映射了同一个段的其他进程可以直接使用
+    using PayloadHandler = std::function<void(const ChannelMessage& msg, std::string_view payload, size_t offset)>;
+    using PayloadWriter = std::function<void(char* dst)>;
+
+    static const size_t kDefaultCapacity = 4 * 1024 * 1024;
+    static const size_t kDefaultSlotCount = 1024;
+
+private:
+    struct RingHeader;
+    struct Slot;
+
+    std::string endpoint_;
+    std::string shm_name_;
+    bool owner_;                 // 创建方负责接收和unlink
+    size_t requested_capacity_;
+    size_t requested_slots_;
+    uint32_t send_timeout_ms_;
+
+    void* mapping_;
+    size_t mapping_size_;
+    RingHeader* header_;
+    Slot* slots_;
+    char* data_;
+
+    PayloadHandler payload_handler_;
+    std::thread receive_thread_;
+    std::atomic<bool> stop_requested_;
+
+public:
+    // capacity和slot_count向上取整到2的幂，仅创建方使用，打开方以段内记录的值为准
+    ShmChannel(const std::string& name, ChannelType type, const std::string& endpoint,
+               size_t capacity = kDefaultCapacity, size_t slot_count = kDefaultSlotCount);
+    ~ShmChannel() override;
+
+    bool start() override;
+    void stop() override;
+
+    bool send(const ChannelMessage& msg) override;
+    bool send(const std::string& content, const std::string& topic = "") override;
+    // 每条消息单独预留，整批只唤醒一次消费者、更新一次统计
+    using Channel::sendBatch;
+    size_t sendBatch(const ChannelMessage* messages, size_t count) override;
+
+    // msg.content被忽略，由writer直接向共享内存写入payload_size字节
+    bool sendInPlace(const ChannelMessage& msg, size_t payload_size, const PayloadWriter& writer);
+
+    // 设置后消息以原地视图交给handler，不再构造ChannelMessage内容；需在start()之前设置
+    void setPayloadHandler(PayloadHandler handler) { payload_handler_ = std::move(handler); }
+    // 环满时发送方最多等待的时间，0表示立即失败
+    void setSendTimeout(uint32_t timeout_ms) { send_timeout_ms_ = timeout_ms; }
+
+    size_t getCapacity() const;
+    size_t getPendingRecords() const;
+
+    void printStatistics() const override;
+
+private:
+    bool createSegment();
+    bool openSegment();
+    void unmapSegment();
+
+    // 预留一条记录并写入，成功后发布但不唤醒消费者
+    bool writeRecord(const ChannelMessage& msg, std::string_view content, size_t content_size,
+                     const PayloadWriter& writer);
+    bool reserve(uint32_t size, uint32_t& index, uint32_t& start);
+    // 环满时在futex上等待消费者释放空间，超过send_timeout_ms_返回false
+    bool reserveBlocking(uint32_t size, uint32_t& index, uint32_t& start);
+    void wakeConsumer();
+
+    void receiveLoop();
+    bool hasRecord() const;
+    bool consumeOne();
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "InternedString.h"
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 键为驻留字符串的小型有序映射，用于事件和消息的元数据。
+// 元素个数不超过N时存放在对象内部，不分配内存；超过后整体搬到堆上。
+// 查找是线性比较，适合十个以内的条目。元素保持插入顺序，遍历方式与std::map相同（.first/.second）
+template<size_t N>
+class SmallFlatMap {
+public:
+    struct value_type {
+        InternedString first;
+        std::string second;
+    };
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+private:
+    value_type inline_[N];
+    std::vector<value_type> heap_;
+    size_t size_;
+    bool on_heap_;   // 一旦搬到堆上直到clear()都留在堆上
+
+public:
+    SmallFlatMap() : size_(0), on_heap_(false) {}
+
+    SmallFlatMap(const SmallFlatMap& other) : size_(0), on_heap_(false) { assignFrom(other); }
+
+    SmallFlatMap(SmallFlatMap&& other) noexcept : size_(0), on_heap_(false) { moveFrom(std::move(other)); }
+
+    SmallFlatMap& operator=(const SmallFlatMap& other) {
+        if (this != &other) {
+            clear();
+            assignFrom(other);
+        }
+        return *this;
+    }
+
+    SmallFlatMap& operator=(SmallFlatMap&& other) noexcept {
+        if (this != &other) {
+            clear();
+            moveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    iterator begin() { return onHeap() ? heap_.data() : inline_; }
+    iterator end() { return begin() + size_; }
+    const_iterator begin() const { return onHeap() ? heap_.data() : inline_; }
+    const_iterator end() const { return begin() + size_; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr size_t inlineCapacity() { return N; }
+
+    void clear() {
+        if (!on_heap_) {
+            for (size_t i = 0; i < size_; ++i) {
+                inline_[i].second.clear();
+            }
+        }
+        heap_.clear();
+        size_ = 0;
+        on_heap_ = false;
+    }
+
+    iterator find(std::string_view key) {
+        iterator it = begin();
+        for (iterator e = end(); it != e; ++it) {
+            if (it->first == key) break;
+        }
+        return it;
+    }
+
+    const_iterator find(std::string_view key) const {
+        return const_cast<SmallFlatMap*>(this)->find(key);
+    }
+
+    size_t count(std::string_view key) const { return find(key) != end() ? 1 : 0; }
+
+    std::string& operator[](std::string_view key) {
+        iterator it = find(key);
+        if (it != end()) return it->second;
+        return append(InternedString(key), std::string());
+    }
+
+    void set(const InternedString& key, std::string value) {
+        iterator it = find(key.str());
+        if (it != end()) {
+            it->second = std::move(value);
+        } else {
+            append(key, std::move(value));
+        }
+    }
+
+    bool erase(std::string_view key) {
+        iterator it = find(key);
+        if (it == end()) return false;
+        // 保持插入顺序
+        for (iterator next = it + 1; next != end(); ++it, ++next) {
+            *it = std::move(*next);
+        }
+        if (onHeap()) {
+            heap_.pop_back();
+        } else {
+            inline_[size_ - 1].second.clear();
+        }
+        --size_;
+        return true;
+    }
+
+private:
+    bool onHeap() const { return on_heap_; }
+
+    std::string& append(const InternedString& key, std::string value) {
+        if (!on_heap_ && size_ < N) {
+            inline_[size_].first = key;
+            inline_[size_].second = std::move(value);
+            return inline_[size_++].second;
+        }
+        if (!on_heap_) {
+            heap_.reserve(N * 2);
+            for (size_t i = 0; i < N; ++i) {
+                heap_.push_back(std::move(inline_[i]));
+            }
+            on_heap_ = true;
+        }
+        heap_.push_back(value_type{key, std::move(value)});
+        ++size_;
+        return heap_.back().second;
+    }
+
+    void assignFrom(const SmallFlatMap& other) {
+        for (const value_type& e : other) {
+            append(e.first, e.second);
+        }
+    }
+
+    void moveFrom(SmallFlatMap&& other) {
+        if (other.on_heap_) {
+            heap_ = std::move(other.heap_);
+            size_ = other.size_;
+            on_heap_ = true;
+        } else {
+            for (size_t i = 0; i < other.size_; ++i) {
+                inline_[i].first = other.inline_[i].first;
+                inline_[i].second = std::move(other.inline_[i].second);
+            }
+            size_ = other.size_;
+        }
+        other.heap_.clear();
+        other.size_ = 0;
+        other.on_heap_ = false;
+    }
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
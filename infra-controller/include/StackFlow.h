@@ -8,8 +8,15 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
 #include <thread>
+#include <array>
+#include <chrono>
+#include "MpscQueue.h"
+#include "InternedString.h"
+#include "SmallFlatMap.h"
+#include "StrandExecutor.h"
+#include "WorkflowExecutor.h"
+#include "metrics.h"
 
 namespace edge_infra {
 namespace infra_controller {
@@ -27,21 +34,29 @@ enum class EventType {
     CUSTOM
 };
 
+// EventType是从0开始的连续枚举，可直接作为数组下标；新增类型时需放在CUSTOM之前
+static const size_t kEventTypeCount = static_cast<size_t>(EventType::CUSTOM) + 1;
+
+// 事件和消息的元数据，4个以内的条目不分配内存
+using MetadataMap = SmallFlatMap<4>;
+
 // 事件数据结构
+// source/target是驻留字符串，拷贝事件时不分配内存；发布时优先使用publishEvent(Event&&)
 struct Event {
     EventType type;
-    std::string source;
-    std::string target;
-    std::unordered_map<std::string, std::string> data;
+    InternedString source;
+    InternedString target;
+    MetadataMap data;
     uint64_t timestamp;
-    uint32_t priority;
+    uint32_t priority;        // 0=LOW 1=NORMAL 2=HIGH 3=CRITICAL，超出按CRITICAL处理
     
-    Event(EventType t = EventType::CUSTOM, const std::string& src = "", 
-          const std::string& tgt = "");
+    Event(EventType t = EventType::CUSTOM, const InternedString& src = InternedString(), 
+          const InternedString& tgt = InternedString());
     
-    void setData(const std::string& key, const std::string& value);
-    std::string getData(const std::string& key) const;
-    bool hasData(const std::string& key) const;
+    void setData(const InternedString& key, std::string value);
+    // 不存在时返回空字符串
+    const std::string& getData(std::string_view key) const;
+    bool hasData(std::string_view key) const;
 };
 
 // 事件处理器接口
@@ -51,8 +66,12 @@ public:
     virtual bool handleEvent(const Event& event) = 0;
     virtual std::string getHandlerName() const = 0;
     virtual std::vector<EventType> getSupportedEvents() const = 0;
+    // 可能长时间阻塞的处理器（如模型加载）返回true，在独立的阻塞线程池中执行
+    virtual bool isBlocking() const { return false; }
 };
 
+class CompiledWorkflow;
+
 // 工作流步骤
 class WorkflowStep {
 public:
@@ -78,6 +97,8 @@ private:
     std::function<bool(const Event&)> condition_;
     std::function<bool(const Event&)> action_;
     std::vector<std::shared_ptr<WorkflowStep>> children_;
+    std::chrono::milliseconds timeout_;
+    std::shared_ptr<WorkflowExecutor> executor_;
     
 public:
     WorkflowStep(const std::string& name, StepType type);
@@ -87,6 +108,15 @@ public:
     void setCondition(std::function<bool(const Event&)> cond);
     void setAction(std::function<bool(const Event&)> act);
     void addChild(std::shared_ptr<WorkflowStep> child);
+    // 超时为0表示不限制。PARALLEL步骤超时后立即返回失败并取消未开始的子步骤，
+    // 其余类型在动作结束后检查耗时
+    void setTimeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
+    std::chrono::milliseconds getTimeout() const { return timeout_; }
+    // PARALLEL子步骤使用的线程池，未设置时使用WorkflowExecutor::shared()
+    void setExecutor(std::shared_ptr<WorkflowExecutor> executor) { executor_ = std::move(executor); }
+    
+    // 当前线程所在的并行分支是否已被取消（兄弟步骤失败或超时），耗时的action可以轮询它提前退出
+    static bool cancelRequested();
     
     // 执行控制
     virtual bool execute(const Event& event);
@@ -102,34 +132,182 @@ public:
     void printStepTree(int indent = 0) const;
     
 protected:
+    enum class SelfResult {
+        PROCEED,    // 继续执行子步骤
+        SKIPPED,    // 条件不满足，跳过整个分支
+        FAILED
+    };
+    
     void setStatus(StepStatus status) { status_.store(status); }
+    // status为本次执行记录状态的位置：直接执行步骤树时是status_，编译后的工作流使用每次执行独立的状态
+    SelfResult runSelf(const Event& event, std::atomic<StepStatus>& status) const;
     bool executeChildren(const Event& event);
     bool executeChildrenParallel(const Event& event);
     bool executeChildrenSequential(const Event& event);
+    // PARALLEL的fan-out/fan-in，如何执行/跳过第i个子步骤由调用方提供
+    bool runParallel(size_t count, std::function<bool(size_t, const Event&)> run_child,
+                     std::function<void(size_t)> skip_child, const Event& event) const;
+    
+private:
+    struct ParallelGroup;
+    static void drainParallelGroup(const std::shared_ptr<ParallelGroup>& group);
+    
+    friend class CompiledWorkflow;
+};
+
+// 注册时由步骤树编译得到的只读工作流。
+// 步骤按广度优先展开到连续数组中，父步骤总在子步骤之前，每个步骤的子步骤下标连续；
+// 触发它的EventType记录在位掩码中。编译时复制每个步骤的条件、动作、超时和线程池，
+// 之后修改或销毁原步骤树都不影响已编译的工作流，修改需要重新注册才会生效。
+// 每次执行的步骤状态保存在独立分配的RunContext中，同一工作流可以在多个线程上同时执行，
+// 也不会修改原步骤树的状态
+class CompiledWorkflow : public std::enable_shared_from_this<CompiledWorkflow> {
+public:
+    struct Step {
+        std::shared_ptr<const WorkflowStep> step;   // 编译时的快照，不含子步骤
+        uint32_t first_child;
+        uint32_t child_count;
+    };
+    
+private:
+    std::string name_;
+    std::shared_ptr<WorkflowStep> root_;   // 原步骤树，仅用于调试输出
+    std::vector<Step> steps_;
+    uint32_t trigger_mask_;
+    
+public:
+    // 步骤树中存在环时返回nullptr
+    static std::shared_ptr<const CompiledWorkflow> compile(const std::string& name,
+                                                           std::shared_ptr<WorkflowStep> root,
+                                                           const std::vector<EventType>& triggers);
+    
+    // statuses非空时输出本次执行各步骤的状态，顺序与编译后的步骤数组一致
+    bool execute(const Event& event, std::vector<WorkflowStep::StepStatus>* statuses = nullptr) const;
+    
+    bool isTriggeredBy(EventType type) const { return (trigger_mask_ >> static_cast<uint32_t>(type)) & 1u; }
+    const std::string& getName() const { return name_; }
+    const std::shared_ptr<WorkflowStep>& getRoot() const { return root_; }
+    size_t getStepCount() const { return steps_.size(); }
+    
+private:
+    struct RunContext;
+    
+    CompiledWorkflow() : trigger_mask_(0) {}
+    bool runStep(uint32_t index, const Event& event, const std::shared_ptr<RunContext>& run) const;
+    static bool hasCycle(const WorkflowStep* step, std::vector<const WorkflowStep*>& path);
+    static std::shared_ptr<const WorkflowStep> snapshot(const WorkflowStep& step);
 };
 
 // StackFlow主控制器
 class StackFlow {
+public:
+    // 事件按priority分到不同的队列，lane越大优先级越高
+    static const size_t kEventLaneCount = 4;
+    
+    enum class DequeuePolicy {
+        STRICT,     // 总是先取最高优先级的非空队列
+        WEIGHTED    // 每轮按权重从各队列取事件，低优先级不会被饿死
+    };
+    
+    struct LaneStats {
+        uint64_t depth;
+        uint64_t enqueued;
+        uint64_t dequeued;
+        uint64_t avg_wait_us;
+        uint64_t max_wait_us;
+    };
+    
 private:
+    struct QueuedEvent {
+        Event event;
+        uint64_t enqueue_us = 0;
+    };
+    
+    struct EventLane {
+        MpscQueue<QueuedEvent> queue;
+        std::atomic<uint64_t> depth{0};
+        std::atomic<uint64_t> enqueued{0};
+        std::atomic<uint64_t> dequeued{0};
+        std::atomic<uint64_t> total_wait_us{0};
+        std::atomic<uint64_t> max_wait_us{0};
+    };
+    
     std::string name_;
     bool running_;
     std::atomic<bool> stop_requested_;
     
-    // 事件处理
-    std::unordered_map<EventType, std::vector<std::shared_ptr<EventHandler>>> handlers_;
-    std::queue<Event> event_queue_;
+    // 某一事件类型的处理器列表，发布后不再修改
+    struct HandlerList {
+        std::vector<std::shared_ptr<EventHandler>> owners;   // 持有处理器的生命周期，按注册顺序
+        std::vector<EventHandler*> inline_handlers;
+        // 注册时isBlocking()为true的处理器。排进阻塞线程池的任务持有这份列表，
+        // 不再占用读者计数，旧表可以在任务排队期间释放
+        std::shared_ptr<const std::vector<std::shared_ptr<EventHandler>>> blocking_handlers;
+    };
+    
+    // 事件处理：按EventType下标访问，注册/注销时整表复制后原子替换（copy-on-write）。
+    // 分发路径不加锁也不增减处理器表的引用计数，只在当前宽限期的读者计数上登记（按线程分片）。
+    // 被替换的旧表记下替换时的宽限期编号，宽限期前进两次后（两个计数槽都在替换之后归零过）释放；
+    // 事件线程每分发完一批尝试推进，注册/注销时也会推进
+    struct alignas(metrics::kCacheLineSize) ReaderSlot {
+        std::atomic<uint64_t> count{0};
+    };
+    struct RetiredHandlerList {
+        std::unique_ptr<const HandlerList> list;
+        uint64_t epoch;
+    };
+    // 登记一次读者，析构时注销
+    class HandlerReadScope {
+    private:
+        StackFlow* flow_;
+        size_t bucket_;
+    public:
+        explicit HandlerReadScope(StackFlow* flow);
+        ~HandlerReadScope();
+        HandlerReadScope(const HandlerReadScope&) = delete;
+        HandlerReadScope& operator=(const HandlerReadScope&) = delete;
+    };
+    std::array<std::atomic<const HandlerList*>, kEventTypeCount> handler_lists_;
+    std::array<std::array<ReaderSlot, metrics::kMetricShards>, 2> handler_readers_;
+    std::atomic<uint64_t> handler_epoch_;
+    std::vector<RetiredHandlerList> retired_handler_lists_;
+    std::atomic<bool> has_retired_lists_;
+    mutable std::mutex handlers_mutex_;   // 串行化写者与宽限期推进
+    
+    // 事件队列：发布端无锁入队，只有消费者休眠时才加锁唤醒
+    std::array<EventLane, kEventLaneCount> lanes_;
+    std::atomic<uint64_t> pending_events_;
+    std::atomic<bool> consumer_waiting_;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
     std::thread event_thread_;
+    std::atomic<DequeuePolicy> dequeue_policy_;
+    std::array<uint32_t, kEventLaneCount> lane_weights_;
+    size_t batch_size_;
     
-    // 工作流管理
-    std::unordered_map<std::string, std::shared_ptr<WorkflowStep>> workflows_;
+    // 并行分发：同一source的事件哈希到同一strand，保证按发布顺序处理
+    size_t worker_threads_;
+    size_t blocking_threads_;
+    std::unique_ptr<StrandExecutor> worker_pool_;
+    std::unique_ptr<StrandExecutor> blocking_pool_;
+    
+    // 工作流管理：分发路径只读取不可变的WorkflowTable快照（atomic_load），
+    // 注册/注销时复制一份修改后整体替换，workflow_mutex_只用于串行化写者
+    struct WorkflowTable {
+        std::unordered_map<std::string, std::shared_ptr<const CompiledWorkflow>> by_name;
+        std::array<std::vector<std::shared_ptr<const CompiledWorkflow>>, kEventTypeCount> by_event;
+    };
+    std::shared_ptr<const WorkflowTable> workflow_table_;
     std::mutex workflow_mutex_;
     
-    // 统计信息
-    std::atomic<uint64_t> events_processed_;
-    std::atomic<uint64_t> workflows_executed_;
-    std::atomic<uint64_t> errors_count_;
+    // 统计信息：worker线程并发累加，用分片计数器避免争用同一缓存行；
+    // 以flow标签导出到MetricsRegistry，析构时注销
+    metrics::Counter events_processed_;
+    metrics::Counter workflows_executed_;
+    metrics::Counter errors_count_;
+    metrics::Histogram* queue_wait_metric_;         // 入队到出队的等待时间
+    metrics::Histogram* handler_duration_metric_;   // 单个处理器的执行时间
+    std::vector<uint64_t> metric_handles_;
     
 public:
     explicit StackFlow(const std::string& name);
@@ -150,20 +328,36 @@ public:
     void unregisterAllHandlers(EventType type);
     
     // 事件发布
+    void publishEvent(Event&& event);
     void publishEvent(const Event& event);
-    void publishEvent(EventType type, const std::string& source = "", 
-                     const std::string& target = "");
+    void publishEvent(EventType type, const InternedString& source = InternedString(), 
+                     const InternedString& target = InternedString());
     
     // 工作流管理
-    void registerWorkflow(const std::string& name, std::shared_ptr<WorkflowStep> workflow);
+    // triggers中的事件类型发布时自动执行该工作流；也可通过事件的target或data["workflow"]按名称触发
+    bool registerWorkflow(const std::string& name, std::shared_ptr<WorkflowStep> workflow,
+                          const std::vector<EventType>& triggers = {});
     void unregisterWorkflow(const std::string& name);
     bool executeWorkflow(const std::string& name, const Event& trigger_event);
     
     // 统计信息
-    uint64_t getEventsProcessed() const { return events_processed_.load(); }
-    uint64_t getWorkflowsExecuted() const { return workflows_executed_.load(); }
-    uint64_t getErrorsCount() const { return errors_count_.load(); }
+    uint64_t getEventsProcessed() const { return events_processed_.value(); }
+    uint64_t getWorkflowsExecuted() const { return workflows_executed_.value(); }
+    uint64_t getErrorsCount() const { return errors_count_.value(); }
     size_t getQueueSize() const;
+    LaneStats getLaneStats(size_t lane) const;
+    
+    // 队列调度配置，需在start()之前设置
+    void setDequeuePolicy(DequeuePolicy policy) { dequeue_policy_.store(policy); }
+    DequeuePolicy getDequeuePolicy() const { return dequeue_policy_.load(); }
+    void setLaneWeights(const std::array<uint32_t, kEventLaneCount>& weights);
+    void setBatchSize(size_t batch_size) { batch_size_ = batch_size > 0 ? batch_size : 1; }
+    
+    // 处理器线程配置，需在start()之前设置。
+    // worker_threads为0时所有处理器在事件线程上串行执行；blocking_threads为0时阻塞处理器与普通处理器同线程执行
+    void setWorkerThreads(size_t worker_threads, size_t blocking_threads = 1);
+    size_t getWorkerThreads() const { return worker_threads_; }
+    size_t getBlockingThreads() const { return blocking_threads_; }
     
     // 调试功能
     void enableDebug(bool enable = true);
@@ -175,8 +369,27 @@ public:
     
 private:
     void eventProcessingLoop();
+    size_t dequeueBatch(std::vector<QueuedEvent>& batch);
+    bool popFromLane(size_t lane, std::vector<QueuedEvent>& batch);
+    void dispatchEvent(Event&& event);
     void processEvent(const Event& event);
+    // 调用方已登记为读者
+    void runHandlers(const Event& event, const HandlerList& list);
+    void runHandler(const Event& event, EventHandler* handler);
+    void replaceHandlerList(EventType type, std::unique_ptr<HandlerList> list);
+    // 持有handlers_mutex_时调用：读者已离开将要复用的计数槽时推进宽限期，释放已过宽限期的旧表
+    void advanceHandlerEpoch();
+    // 事件线程在分发批次之间调用，取不到锁时留到下一批
+    void tryReclaimHandlerLists();
+    // 只在确认没有分发线程后调用（stop/析构）
+    void reclaimHandlerLists();
+    static size_t eventTypeIndex(EventType type);
+    static size_t sourceKey(const Event& event);
+    static size_t laneForPriority(uint32_t priority);
     void triggerWorkflows(const Event& event);
+    bool runCompiledWorkflow(const CompiledWorkflow& workflow, const Event& event);
+    std::shared_ptr<const WorkflowTable> loadWorkflowTable() const;
+    void publishWorkflowTable(std::shared_ptr<const WorkflowTable> table);
     
     bool debug_enabled_;
     void debugLog(const std::string& message) const;
@@ -188,6 +401,7 @@ private:
     std::string name_;
     std::vector<EventType> supported_events_;
     std::function<bool(const Event&)> handler_func_;
+    bool blocking_;
     
 public:
     SimpleEventHandler(const std::string& name, 
@@ -197,6 +411,8 @@ public:
     bool handleEvent(const Event& event) override;
     std::string getHandlerName() const override { return name_; }
     std::vector<EventType> getSupportedEvents() const override { return supported_events_; }
+    bool isBlocking() const override { return blocking_; }
+    void setBlocking(bool blocking) { blocking_ = blocking; }
 };
 
 // 工具函数
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 按key分片的工作窃取线程池。
+// 相同key的任务落在同一个strand上，严格按提交顺序串行执行；不同strand之间并行。
+// 调度单位是strand而不是单个任务：就绪的strand进入某个worker的本地队列，
+// 空闲worker从其他队列尾部窃取整个strand，因此窃取不会破坏同key任务的顺序。
+class StrandExecutor {
+public:
+    using Task = std::function<void()>;
+
+    // 单个strand连续执行的任务数上限，超过后重新排队，避免热点key长期占用worker
+    static const size_t kStrandBudget = 32;
+
+private:
+    struct Strand {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        bool scheduled = false;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<size_t> ready;   // 就绪strand的下标
+        std::thread thread;
+    };
+
+    std::string name_;
+    std::vector<std::unique_ptr<Strand>> strands_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    std::atomic<size_t> ready_count_;
+    std::atomic<size_t> idle_workers_;
+    std::atomic<bool> running_;
+    std::atomic<bool> stopping_;
+
+    std::atomic<uint64_t> tasks_executed_;
+    std::atomic<uint64_t> tasks_stolen_;
+    std::atomic<uint64_t> pending_tasks_;
+
+public:
+    // strand_count为0时取线程数的16倍
+    StrandExecutor(const std::string& name, size_t thread_count, size_t strand_count = 0);
+    ~StrandExecutor();
+
+    StrandExecutor(const StrandExecutor&) = delete;
+    StrandExecutor& operator=(const StrandExecutor&) = delete;
+
+    void start();
+    // 等待已提交的任务全部执行完再返回
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    // 停止后提交返回false，任务被丢弃
+    bool post(size_t key, Task task);
+
+    size_t getThreadCount() const { return workers_.size(); }
+    size_t getStrandCount() const { return strands_.size(); }
+    uint64_t getTasksExecuted() const { return tasks_executed_.load(); }
+    uint64_t getTasksStolen() const { return tasks_stolen_.load(); }
+    uint64_t getPendingTasks() const { return pending_tasks_.load(); }
+    const std::string& getName() const { return name_; }
+
+private:
+    void workerLoop(size_t index);
+    void schedule(size_t strand, size_t worker);
+    bool popLocal(size_t worker, size_t& strand);
+    bool steal(size_t worker, size_t& strand);
+    void runStrand(size_t worker, size_t strand);
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InternedString.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace edge_infra {
+namespace infra_controller {
+
+class Channel;
+
+// 基于分段字典树的主题路由。
+// 主题按'.'分段，模式中'*'匹配一段，'#'匹配零段或多段。
+// 路由表整体编译成不可变快照，路由变更时重建并原子替换；查询只读取快照，
+// 匹配结果按主题缓存在快照内，路由变更后旧缓存随旧快照一起失效
+class TopicRouter {
+public:
+    using ChannelList = std::vector<std::shared_ptr<Channel>>;
+    using Route = std::pair<std::string, std::shared_ptr<Channel>>;   // 模式 -> 通道
+
+    // 每个缓存分片最多保存的主题数，超过后清空该分片，避免会话级主题撑爆缓存
+    static const size_t kCacheEntriesPerShard = 512;
+
+private:
+    struct Node;
+    struct Snapshot;
+
+    std::shared_ptr<const Snapshot> snapshot_;
+    mutable std::atomic<uint64_t> cache_hits_;
+    mutable std::atomic<uint64_t> cache_misses_;
+
+public:
+    TopicRouter();
+    ~TopicRouter();
+
+    TopicRouter(const TopicRouter&) = delete;
+    TopicRouter& operator=(const TopicRouter&) = delete;
+
+    // 用完整的路由列表重建快照，调用方负责串行化
+    void rebuild(const std::vector<Route>& routes);
+
+    // 返回匹配topic的通道（去重，按首次匹配顺序），没有匹配时返回空列表
+    std::shared_ptr<const ChannelList> match(const InternedString& topic) const;
+
+    size_t getRouteCount() const;
+    uint64_t getCacheHits() const { return cache_hits_.load(); }
+    uint64_t getCacheMisses() const { return cache_misses_.load(); }
+
+private:
+    std::shared_ptr<const Snapshot> load() const;
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 工作流并行步骤共用的有界线程池。
+// 队列满时trySubmit返回false，由调用方自己执行（caller-runs），线程数和排队任务数都不会无限增长
+class WorkflowExecutor {
+public:
+    using Task = std::function<void()>;
+
+private:
+    std::vector<std::thread> threads_;
+    std::deque<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t max_queue_;
+    bool stopping_;
+
+public:
+    // thread_count为0时取硬件线程数
+    explicit WorkflowExecutor(size_t thread_count = 0, size_t max_queue = 1024);
+    ~WorkflowExecutor();
+
+    WorkflowExecutor(const WorkflowExecutor&) = delete;
+    WorkflowExecutor& operator=(const WorkflowExecutor&) = delete;
+
+    bool trySubmit(Task task);
+    size_t getThreadCount() const { return threads_.size(); }
+
+    // 进程内共享的默认实例
+    static std::shared_ptr<WorkflowExecutor> shared();
+
+private:
+    void workerLoop();
+};
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -1,16 +1,29 @@
 #pragma once
 
 #include "StackFlow.h"
+#include "TopicRouter.h"
+#include "network/Timer.h"
+#include "metrics.h"
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <queue>
 #include <functional>
+#include <chrono>
+#include <vector>
 
 namespace edge_infra {
+namespace network {
+class EventLoop;
+} // namespace network
+namespace hybrid_comm {
+class ZmqWatcher;
+} // namespace hybrid_comm
+
 namespace infra_controller {
 
 // 通道类型定义
@@ -31,22 +44,24 @@ enum class MessagePriority {
 };
 
 // 通道消息
+// topic为驻留字符串，元数据使用MetadataMap，少量元数据时不额外分配内存
 struct ChannelMessage {
     std::string id;
     std::string sender;
     std::string receiver;
-    std::string topic;
+    InternedString topic;
     std::string content;
     MessagePriority priority;
     uint64_t timestamp;
-    std::unordered_map<std::string, std::string> metadata;
+    MetadataMap metadata;
     
     ChannelMessage();
-    ChannelMessage(const std::string& content, MessagePriority prio = MessagePriority::NORMAL);
+    ChannelMessage(std::string content, MessagePriority prio = MessagePriority::NORMAL);
     
-    void setMetadata(const std::string& key, const std::string& value);
-    std::string getMetadata(const std::string& key) const;
-    bool hasMetadata(const std::string& key) const;
+    void setMetadata(const InternedString& key, std::string value);
+    // 不存在时返回空字符串
+    const std::string& getMetadata(std::string_view key) const;
+    bool hasMetadata(std::string_view key) const;
     
     std::string toString() const;
 };
@@ -84,29 +99,46 @@ public:
     std::string getFilterName() const override;
 };
 
+// 批量投递策略：攒够max_messages条、内容累计达到max_bytes或最早一条等待超过max_delay_ms时投递
+struct BatchPolicy {
+    size_t max_messages = 64;
+    size_t max_bytes = 64 * 1024;
+    uint32_t max_delay_ms = 2;
+};
+
 // 通道接口
 class Channel {
 public:
     using MessageHandler = std::function<void(const ChannelMessage&)>;
+    using BatchHandler = std::function<void(const std::vector<ChannelMessage>&)>;
     using ErrorHandler = std::function<void(const std::string&)>;
     
 protected:
     std::string name_;
     ChannelType type_;
     bool active_;
-    std::atomic<uint64_t> messages_sent_;
-    std::atomic<uint64_t> messages_received_;
-    std::atomic<uint64_t> errors_count_;
+    // 多个发送线程并发累加，用分片计数器；以channel标签导出到MetricsRegistry
+    metrics::Counter messages_sent_;
+    metrics::Counter messages_received_;
+    metrics::Counter errors_count_;
+    std::vector<uint64_t> metric_handles_;
     
     std::vector<std::shared_ptr<MessageFilter>> filters_;
     MessageHandler message_handler_;
     ErrorHandler error_handler_;
     
+    // 批量接收，仅由接收线程访问
+    BatchHandler batch_handler_;
+    BatchPolicy batch_policy_;
+    std::vector<ChannelMessage> receive_batch_;
+    size_t receive_batch_bytes_;
+    std::chrono::steady_clock::time_point receive_batch_started_;
+    
     mutable std::mutex mutex_;
     
 public:
     Channel(const std::string& name, ChannelType type);
-    virtual ~Channel() = default;
+    virtual ~Channel();
     
     // 禁用拷贝
     Channel(const Channel&) = delete;
@@ -121,9 +153,16 @@ public:
     virtual bool send(const ChannelMessage& msg) = 0;
     virtual bool send(const std::string& content, const std::string& topic = "") = 0;
     
+    // 批量发送，按顺序发送直到第一条失败，返回成功发送的条数。
+    // 默认实现逐条调用send()，子类可以合并成更少的帧并只加一次锁
+    virtual size_t sendBatch(const ChannelMessage* messages, size_t count);
+    size_t sendBatch(const std::vector<ChannelMessage>& messages) {
+        return sendBatch(messages.data(), messages.size());
+    }
+    
     // 订阅/取消订阅（仅适用于某些通道类型）
-    virtual bool subscribe(const std::string& topic) { return false; }
-    virtual bool unsubscribe(const std::string& topic) { return false; }
+    virtual bool subscribe(const std::string& /*topic*/) { return false; }
+    virtual bool unsubscribe(const std::string& /*topic*/) { return false; }
     
     // 过滤器管理
     void addFilter(std::shared_ptr<MessageFilter> filter);
@@ -133,15 +172,17 @@ public:
     // 回调设置
     void setMessageHandler(MessageHandler handler) { message_handler_ = handler; }
     void setErrorHandler(ErrorHandler handler) { error_handler_ = handler; }
+    // 设置后接收到的消息按policy攒批交给handler，不再调用MessageHandler；需在start()之前设置
+    void setBatchHandler(BatchHandler handler, const BatchPolicy& policy = BatchPolicy());
     
     // 属性访问
     const std::string& getName() const { return name_; }
     ChannelType getType() const { return type_; }
     
     // 统计信息
-    uint64_t getMessagesSent() const { return messages_sent_.load(); }
-    uint64_t getMessagesReceived() const { return messages_received_.load(); }
-    uint64_t getErrorsCount() const { return errors_count_.load(); }
+    uint64_t getMessagesSent() const { return messages_sent_.value(); }
+    uint64_t getMessagesReceived() const { return messages_received_.value(); }
+    uint64_t getErrorsCount() const { return errors_count_.value(); }
     
     // 调试功能
     virtual void printStatistics() const;
@@ -150,20 +191,42 @@ public:
 protected:
     bool applyFilters(const ChannelMessage& msg) const;
     void notifyMessageReceived(const ChannelMessage& msg);
+    void notifyMessageReceived(ChannelMessage&& msg);
     void notifyError(const std::string& error);
     
-    void updateSendStats() { messages_sent_++; }
-    void updateReceiveStats() { messages_received_++; }
-    void updateErrorStats() { errors_count_++; }
+    // 投递攒下的批次；force为false时只在达到max_delay_ms后投递
+    void flushReceivedBatch(bool force);
+    // 距离当前批次到期的毫秒数，没有待投递批次时返回max_wait_ms
+    long receiveBatchWaitMs(long max_wait_ms) const;
+    
+    void updateSendStats(uint64_t count = 1) { messages_sent_.add(count); }
+    void updateReceiveStats() { messages_received_.increment(); }
+    void updateErrorStats() { errors_count_.increment(); }
 };
 
 // ZeroMQ通道实现
+// endpoint以'@'开头表示bind，以'>'开头表示connect；都没有时地址中含'*'则bind，否则connect。
+// 套接字类型由通道类型和bind/connect决定：
+//   POINT_TO_POINT -> PAIR
+//   PUBLISH_SUBSCRIBE/BROADCAST/MULTICAST -> bind端PUB（只发）、connect端SUB（只收）
+//   REQUEST_RESPONSE -> bind端REP、connect端REQ
+// 每条消息是两帧：[topic][编码后的消息]，SUB端按topic前缀订阅；
+// sendBatch把同topic的一串消息编码进同一个消息帧。
+// 默认每个通道一个接收线程；setEventLoop()后改为把ZMQ_FD注册到该EventLoop，
+// 由loop线程接收并回调MessageHandler，多个通道可以共用一个reactor线程
 class ZmqChannel : public Channel {
 private:
     std::string endpoint_;
     void* zmq_socket_;
+    int socket_type_;
     std::thread receive_thread_;
     std::atomic<bool> stop_requested_;
+    std::atomic<int> pending_senders_;   // 等待套接字的发送线程数，接收线程据此让出锁
+    
+    network::EventLoop* loop_;
+    std::shared_ptr<hybrid_comm::ZmqWatcher> watcher_;   // 由mutex_保护：发送线程读取，start/stop写入
+    network::TimerId batch_timer_;
+    std::vector<ChannelMessage> received_;   // 接收线程或loop线程复用
     
 public:
     ZmqChannel(const std::string& name, ChannelType type, const std::string& endpoint);
@@ -174,28 +237,90 @@ public:
     
     bool send(const ChannelMessage& msg) override;
     bool send(const std::string& content, const std::string& topic = "") override;
+    // 相邻且topic相同的消息合并成一个打包帧，整批只加一次锁、更新一次统计
+    using Channel::sendBatch;
+    size_t sendBatch(const ChannelMessage* messages, size_t count) override;
     
     bool subscribe(const std::string& topic) override;
     bool unsubscribe(const std::string& topic) override;
     
+    // 需在start()之前设置，loop需要在stop()之前保持运行
+    void setEventLoop(network::EventLoop* loop) { loop_ = loop; }
+    network::EventLoop* getEventLoop() const { return loop_; }
+    
 private:
     void receiveLoop();
+    // 持有mutex_时调用，非阻塞地接收一条消息并解码追加到received_，没有消息时返回false
+    bool receiveFrames(bool& malformed);
+    void handleReadable();
+    void deliverReceived(bool malformed);
+    // 持有mutex_时调用，loop模式下发送可能吞掉ZMQ_FD的通知，仍可读时让watcher重新检查
+    void recheckAfterSend();
     bool initializeSocket();
     void cleanupSocket();
+    bool canSend() const;
+    bool canReceive() const;
+};
+
+// 发送端攒批：add()累积消息，达到策略的条数/字节数上限时立即sendBatch，
+// 时间上限由调用方定时调用flushIfDue()保证（例如挂在事件循环的定时器上）。
+// 适合流式输出这类每个会话产生大量小消息的场景。线程安全，析构时发送剩余消息
+class MessageBatcher {
+private:
+    std::shared_ptr<Channel> channel_;
+    BatchPolicy policy_;
+    std::vector<ChannelMessage> pending_;
+    size_t pending_bytes_;
+    std::chrono::steady_clock::time_point first_added_;
+    mutable std::mutex mutex_;
+    
+public:
+    explicit MessageBatcher(std::shared_ptr<Channel> channel, const BatchPolicy& policy = BatchPolicy());
+    ~MessageBatcher();
+    
+    MessageBatcher(const MessageBatcher&) = delete;
+    MessageBatcher& operator=(const MessageBatcher&) = delete;
+    
+    // 返回false表示触发的发送没有全部成功
+    bool add(ChannelMessage msg);
+    // 发送全部待发消息，返回成功发送的条数；失败的消息被丢弃并由通道报告错误
+    size_t flush();
+    // 最早一条消息等待超过max_delay_ms时发送
+    size_t flushIfDue();
+    
+    size_t getPendingCount() const;
+    
+private:
+    size_t flushLocked();
 };
 
 // 通道管理器
+// 流控：下游（例如TcpConnection达到高水位）可以按topic暂停路由，routeMessage对暂停的topic
+// 直接返回false，上游据此减速；暂停/恢复通过FlowControlCallback通知上游，例如转告产生该会话输出的模型单元
 class ChannelManager {
+public:
+    using FlowControlCallback = std::function<void(const InternedString& topic, bool paused)>;
+    
 private:
     std::unordered_map<std::string, std::shared_ptr<Channel>> channels_;
     mutable std::mutex channels_mutex_;
     
-    // 路由表：topic -> channel names
+    // 路由表：topic模式 -> channel names，是路由配置的原始记录
     std::unordered_map<std::string, std::vector<std::string>> routing_table_;
     mutable std::mutex routing_mutex_;
     
+    // 由channels_和routing_table_编译出的字典树，routeMessage只查询它，不获取上面两个锁
+    TopicRouter router_;
+    
+    // 暂停的topic（精确匹配），paused_count_为0时routeMessage不加锁
+    std::unordered_set<InternedString> paused_topics_;
+    mutable std::mutex paused_mutex_;
+    std::atomic<size_t> paused_count_;
+    std::atomic<uint64_t> throttled_messages_;
+    FlowControlCallback flow_control_callback_;
+    
 public:
-    ChannelManager() = default;
+    ChannelManager();
     ~ChannelManager();
     
     // 禁用拷贝
@@ -220,6 +345,15 @@ public:
     bool routeMessage(const ChannelMessage& msg);
     bool routeMessage(const std::string& topic, const std::string& content);
     
+    // 流控（线程安全），状态发生变化时返回true并回调FlowControlCallback
+    bool pauseTopic(const InternedString& topic);
+    bool resumeTopic(const InternedString& topic);
+    bool isTopicPaused(const InternedString& topic) const;
+    // 需在开始路由之前设置
+    void setFlowControlCallback(FlowControlCallback cb) { flow_control_callback_ = std::move(cb); }
+    size_t getPausedTopicCount() const { return paused_count_.load(); }
+    uint64_t getThrottledMessages() const { return throttled_messages_.load(); }
+    
     // 广播
     void broadcast(const ChannelMessage& msg);
     void broadcast(const std::string& content);
@@ -232,6 +366,10 @@ public:
     // 统计和调试
     void printAllStatistics() const;
     void printRoutingTable() const;
+    
+private:
+    // 调用方需按channels_mutex_、routing_mutex_的顺序持有两个锁
+    void rebuildRouter();
 };
 
 // 工具函数
@@ -0,0 +1,117 @@
+#include "../include/InternedString.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace edge_infra {
+namespace infra_controller {
+
+namespace {
+
+// 按哈希分片的驻留表，Entry存放在deque中地址稳定
+class InternTable {
+public:
+    static const size_t kShardCount = 16;
+
+    static InternTable& instance() {
+        // 有意不析构：静态析构期间仍可能有InternedString被访问
+        static InternTable* table = new InternTable();
+        return *table;
+    }
+
+    const InternedString::Entry* intern(std::string_view str, size_t hash) {
+        Shard& shard = shards_[hash % kShardCount];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(str);
+        if (it != shard.index.end()) {
+            return it->second;
+        }
+        shard.entries.emplace_back(std::string(str), hash, true);
+        const InternedString::Entry* entry = &shard.entries.back();
+        shard.index.emplace(std::string_view(entry->str), entry);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return entry;
+    }
+
+    // 只查找，不存在时返回nullptr
+    const InternedString::Entry* find(std::string_view str, size_t hash) {
+        Shard& shard = shards_[hash % kShardCount];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(str);
+        return it != shard.index.end() ? it->second : nullptr;
+    }
+
+    size_t count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::deque<InternedString::Entry> entries;
+        std::unordered_map<std::string_view, const InternedString::Entry*> index;
+    };
+
+    Shard shards_[kShardCount];
+    std::atomic<size_t> count_{0};
+};
+
+// 线程本地的直接映射缓存，命中时不需要加锁；只缓存驻留项。
+// intern为false时只查找，未驻留返回nullptr
+const InternedString::Entry* lookup(std::string_view str, size_t hash, bool intern) {
+    static const size_t kCacheSlots = 256;
+    thread_local const InternedString::Entry* cache[kCacheSlots] = {};
+
+    const InternedString::Entry*& slot = cache[hash % kCacheSlots];
+    if (slot != nullptr && slot->hash == hash && slot->str == str) {
+        return slot;
+    }
+    const InternedString::Entry* entry =
+        intern ? InternTable::instance().intern(str, hash) : InternTable::instance().find(str, hash);
+    if (entry != nullptr) slot = entry;
+    return entry;
+}
+
+const InternedString::Entry* lookup(std::string_view str) {
+    return lookup(str, std::hash<std::string_view>()(str), true);
+}
+
+const InternedString::Entry* emptyEntry() {
+    static const InternedString::Entry* entry = lookup(std::string_view());
+    return entry;
+}
+
+} // namespace
+
+InternedString::InternedString() : entry_(emptyEntry()) {
+}
+
+InternedString::InternedString(std::string_view str) : entry_(str.empty() ? emptyEntry() : lookup(str)) {
+}
+
+bool InternedString::find(std::string_view str, InternedString* out) {
+    if (str.empty()) {
+        *out = InternedString();
+        return true;
+    }
+    const InternedString::Entry* entry = lookup(str, std::hash<std::string_view>()(str), false);
+    if (entry == nullptr) return false;
+    *out = InternedString(entry);
+    return true;
+}
+
+InternedString InternedString::lookupOrCopy(std::string_view str) {
+    InternedString result;
+    if (!find(str, &result)) {
+        const size_t hash = std::hash<std::string_view>()(str);
+        // 私有构造函数接管new出的引用（refs初始为1）
+        result = InternedString(new Entry(std::string(str), hash, false));
+    }
+    return result;
+}
+
+size_t InternedString::internedCount() {
+    return InternTable::instance().count();
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
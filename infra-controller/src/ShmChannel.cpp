@@ -0,0 +1,567 @@
+#include "../include/ShmChannel.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace edge_infra {
+namespace infra_controller {
+
+// 段布局：[RingHeader][Slot * slot_count][数据区 capacity字节]，各部分按缓存行对齐。
+// 计数器都是u32且自然回绕，slot_count和capacity为2的幂，取模用掩码
+struct ShmChannel::RingHeader {
+    std::atomic<uint32_t> magic;                   // 创建方初始化完成后最后写入
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t capacity;
+
+    alignas(64) std::atomic<uint64_t> reserve;     // 高32位：已预留记录数；低32位：数据区预留尾
+    alignas(64) std::atomic<uint32_t> read_index;  // 已释放记录数，只有消费者写
+    std::atomic<uint32_t> data_head;               // 数据区已释放位置，只有消费者写
+    alignas(64) std::atomic<uint32_t> data_ready;  // futex字：唤醒消费者前+1
+    std::atomic<uint32_t> consumer_waiting;
+    alignas(64) std::atomic<uint32_t> space_ready; // futex字：唤醒生产者前+1
+    std::atomic<uint32_t> producers_waiting;
+};
+
+struct ShmChannel::Slot {
+    std::atomic<uint32_t> sequence;   // 记录index发布后为index+1
+    uint32_t start;                   // 数据区计数位置（未取模）
+    uint32_t size;
+    uint32_t reserved;
+};
+
+namespace {
+
+const uint32_t kShmMagic = 0x45534d52;   // "ESMR"
+const uint32_t kShmVersion = 1;
+const size_t kCacheLine = 64;
+const size_t kRecordAlign = 8;
+const int kWaitSliceMs = 10;             // 单次futex等待上限，便于检查停止标志
+const size_t kReceiveBurst = 64;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared-memory ring requires lock-free u32 atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring requires lock-free u64 atomics");
+
+// 记录布局：[RecordHeader][topic][id][sender][receiver]([u32 key][u32 value][key][value])*[对齐][content]
+struct RecordHeader {
+    uint64_t timestamp;
+    uint32_t content_size;
+    uint32_t content_offset;   // 相对记录起始，按kRecordAlign对齐
+    uint32_t topic_size;
+    uint32_t id_size;
+    uint32_t sender_size;
+    uint32_t receiver_size;
+    uint16_t metadata_count;
+    uint8_t priority;
+    uint8_t reserved;
+};
+
+size_t alignUp(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+size_t roundUpPow2(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    // 段在进程间共享，不能使用FUTEX_PRIVATE_FLAG
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word, int count) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+std::string shmNameFor(const std::string& endpoint) {
+    std::string name = endpoint;
+    if (!name.empty() && (name[0] == '@' || name[0] == '>')) {
+        name.erase(0, 1);
+    }
+    if (name.empty() || name[0] != '/') {
+        name.insert(0, "/");
+    }
+    return name;
+}
+
+void putBytes(char*& dst, const void* src, size_t size) {
+    std::memcpy(dst, src, size);
+    dst += size;
+}
+
+} // namespace
+
+ShmChannel::ShmChannel(const std::string& name, ChannelType type, const std::string& endpoint,
+                       size_t capacity, size_t slot_count)
+    : Channel(name, type),
+      endpoint_(endpoint),
+      shm_name_(shmNameFor(endpoint)),
+      owner_(!endpoint.empty() && endpoint[0] == '@'),
+      requested_capacity_(roundUpPow2(capacity < 4096 ? 4096 : capacity)),
+      requested_slots_(roundUpPow2(slot_count < 2 ? 2 : slot_count)),
+      send_timeout_ms_(100),
+      mapping_(nullptr),
+      mapping_size_(0),
+      header_(nullptr),
+      slots_(nullptr),
+      data_(nullptr),
+      stop_requested_(false) {
+}
+
+ShmChannel::~ShmChannel() {
+    stop();
+}
+
+bool ShmChannel::start() {
+    if (active_) return true;
+    if (!(owner_ ? createSegment() : openSegment())) {
+        return false;
+    }
+
+    stop_requested_.store(false);
+    active_ = true;
+    if (owner_) {
+        receive_thread_ = std::thread(&ShmChannel::receiveLoop, this);
+    }
+    return true;
+}
+
+void ShmChannel::stop() {
+    if (!active_) return;
+
+    stop_requested_.store(true);
+    if (receive_thread_.joinable()) {
+        if (header_ != nullptr) {
+            header_->data_ready.fetch_add(1);
+            futexWake(&header_->data_ready, 1);
+        }
+        receive_thread_.join();
+    }
+    active_ = false;
+    unmapSegment();
+    if (owner_) {
+        shm_unlink(shm_name_.c_str());
+    }
+}
+
+// ==================== 段管理 ====================
+
+bool ShmChannel::createSegment() {
+    static_assert(sizeof(RingHeader) % kCacheLine == 0, "ring header must cover whole cache lines");
+    const size_t slots_offset = sizeof(RingHeader);
+    const size_t data_offset = alignUp(slots_offset + requested_slots_ * sizeof(Slot), kCacheLine);
+    const size_t total = data_offset + requested_capacity_;
+    if (requested_capacity_ > (size_t(1) << 30)) {
+        notifyError("shm capacity exceeds 1GiB");
+        return false;
+    }
+
+    int fd = shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        // 上次异常退出残留的段
+        shm_unlink(shm_name_.c_str());
+        fd = shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        notifyError("shm_open " + shm_name_ + " failed: " + std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        notifyError("ftruncate " + shm_name_ + " failed: " + std::strerror(errno));
+        close(fd);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+    void* mapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        notifyError("mmap " + shm_name_ + " failed: " + std::strerror(errno));
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    // ftruncate出的页已清零，只需写入非零字段
+    mapping_ = mapping;
+    mapping_size_ = total;
+    header_ = new (mapping) RingHeader();
+    header_->version = kShmVersion;
+    header_->slot_count = static_cast<uint32_t>(requested_slots_);
+    header_->capacity = static_cast<uint32_t>(requested_capacity_);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + slots_offset);
+    data_ = static_cast<char*>(mapping) + data_offset;
+    header_->magic.store(kShmMagic, std::memory_order_release);
+    return true;
+}
+
+bool ShmChannel::openSegment() {
+    const int fd = shm_open(shm_name_.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        notifyError("shm_open " + shm_name_ + " failed: " + std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingHeader)) {
+        notifyError("shm segment " + shm_name_ + " is not initialized");
+        close(fd);
+        return false;
+    }
+    const size_t total = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        notifyError("mmap " + shm_name_ + " failed: " + std::strerror(errno));
+        return false;
+    }
+
+    RingHeader* header = static_cast<RingHeader*>(mapping);
+    const size_t slots_offset = sizeof(RingHeader);
+    const size_t slot_count = header->slot_count;
+    const size_t capacity = header->capacity;
+    const size_t data_offset = alignUp(slots_offset + slot_count * sizeof(Slot), kCacheLine);
+    const bool valid = header->magic.load(std::memory_order_acquire) == kShmMagic &&
+                       header->version == kShmVersion && slot_count != 0 && capacity != 0 &&
+                       (slot_count & (slot_count - 1)) == 0 && (capacity & (capacity - 1)) == 0 &&
+                       data_offset + capacity <= total;
+    if (!valid) {
+        notifyError("shm segment " + shm_name_ + " has an invalid header");
+        munmap(mapping, total);
+        return false;
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = total;
+    header_ = header;
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + slots_offset);
+    data_ = static_cast<char*>(mapping) + data_offset;
+    return true;
+}
+
+void ShmChannel::unmapSegment() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    header_ = nullptr;
+    slots_ = nullptr;
+    data_ = nullptr;
+}
+
+size_t ShmChannel::getCapacity() const {
+    return header_ != nullptr ? header_->capacity : requested_capacity_;
+}
+
+size_t ShmChannel::getPendingRecords() const {
+    if (header_ == nullptr) return 0;
+    const uint32_t reserved = static_cast<uint32_t>(header_->reserve.load() >> 32);
+    return reserved - header_->read_index.load();
+}
+
+// ==================== 发送 ====================
+
+bool ShmChannel::send(const ChannelMessage& msg) {
+    if (!writeRecord(msg, msg.content, msg.content.size(), nullptr)) {
+        return false;
+    }
+    wakeConsumer();
+    updateSendStats();
+    return true;
+}
+
+bool ShmChannel::send(const std::string& content, const std::string& topic) {
+    ChannelMessage msg(content);
+    msg.sender = name_;
+    msg.topic = InternedString::lookupOrCopy(topic);
+    return send(msg);
+}
+
+size_t ShmChannel::sendBatch(const ChannelMessage* messages, size_t count) {
+    size_t sent = 0;
+    while (sent < count && writeRecord(messages[sent], messages[sent].content, messages[sent].content.size(), nullptr)) {
+        ++sent;
+    }
+    if (sent > 0) {
+        wakeConsumer();
+        updateSendStats(sent);
+    }
+    return sent;
+}
+
+bool ShmChannel::sendInPlace(const ChannelMessage& msg, size_t payload_size, const PayloadWriter& writer) {
+    if (!writer) return false;
+    if (!writeRecord(msg, std::string_view(), payload_size, writer)) {
+        return false;
+    }
+    wakeConsumer();
+    updateSendStats();
+    return true;
+}
+
+bool ShmChannel::writeRecord(const ChannelMessage& msg, std::string_view content, size_t content_size,
+                             const PayloadWriter& writer) {
+    if (!active_ || header_ == nullptr) {
+        notifyError("send on inactive channel");
+        return false;
+    }
+    if (owner_) {
+        notifyError("channel is receive-only");
+        return false;
+    }
+
+    const std::string& topic = msg.topic.str();
+    size_t meta_size = 0;
+    for (const auto& entry : msg.metadata) {
+        meta_size += 2 * sizeof(uint32_t) + entry.first.size() + entry.second.size();
+    }
+    const size_t content_offset = alignUp(sizeof(RecordHeader) + topic.size() + msg.id.size() + msg.sender.size() +
+                                          msg.receiver.size() + meta_size, kRecordAlign);
+    const size_t record_size = alignUp(content_offset + content_size, kRecordAlign);
+    // 不超过一半容量的记录在环空时一定能预留成功
+    if (record_size > header_->capacity / 2) {
+        notifyError("message of " + std::to_string(content_size) + " bytes exceeds shm ring capacity");
+        return false;
+    }
+
+    uint32_t index = 0;
+    uint32_t start = 0;
+    if (!reserve(static_cast<uint32_t>(record_size), index, start) &&
+        !reserveBlocking(static_cast<uint32_t>(record_size), index, start)) {
+        notifyError("shm ring full");
+        return false;
+    }
+
+    char* record = data_ + (start & (header_->capacity - 1));
+    RecordHeader rh;
+    rh.timestamp = msg.timestamp;
+    rh.content_size = static_cast<uint32_t>(content_size);
+    rh.content_offset = static_cast<uint32_t>(content_offset);
+    rh.topic_size = static_cast<uint32_t>(topic.size());
+    rh.id_size = static_cast<uint32_t>(msg.id.size());
+    rh.sender_size = static_cast<uint32_t>(msg.sender.size());
+    rh.receiver_size = static_cast<uint32_t>(msg.receiver.size());
+    rh.metadata_count = static_cast<uint16_t>(msg.metadata.size());
+    rh.priority = static_cast<uint8_t>(msg.priority);
+    rh.reserved = 0;
+
+    char* dst = record;
+    putBytes(dst, &rh, sizeof(rh));
+    putBytes(dst, topic.data(), topic.size());
+    putBytes(dst, msg.id.data(), msg.id.size());
+    putBytes(dst, msg.sender.data(), msg.sender.size());
+    putBytes(dst, msg.receiver.data(), msg.receiver.size());
+    for (const auto& entry : msg.metadata) {
+        const uint32_t key_size = static_cast<uint32_t>(entry.first.size());
+        const uint32_t value_size = static_cast<uint32_t>(entry.second.size());
+        putBytes(dst, &key_size, sizeof(key_size));
+        putBytes(dst, &value_size, sizeof(value_size));
+        putBytes(dst, entry.first.c_str(), key_size);
+        putBytes(dst, entry.second.data(), value_size);
+    }
+    if (writer) {
+        writer(record + content_offset);
+    } else {
+        std::memcpy(record + content_offset, content.data(), content_size);
+    }
+
+    Slot& slot = slots_[index & (header_->slot_count - 1)];
+    slot.start = start;
+    slot.size = static_cast<uint32_t>(record_size);
+    slot.sequence.store(index + 1, std::memory_order_seq_cst);
+    return true;
+}
+
+bool ShmChannel::reserve(uint32_t size, uint32_t& index, uint32_t& start) {
+    const uint32_t capacity = header_->capacity;
+    uint64_t current = header_->reserve.load(std::memory_order_acquire);
+    while (true) {
+        const uint32_t next_index = static_cast<uint32_t>(current >> 32);
+        const uint32_t tail = static_cast<uint32_t>(current);
+        if (next_index - header_->read_index.load(std::memory_order_seq_cst) >= header_->slot_count) {
+            return false;
+        }
+        // 记录不跨越数据区末尾，放不下时跳过剩余部分从下一圈开始
+        const uint32_t offset = tail & (capacity - 1);
+        const uint32_t padding = offset + size > capacity ? capacity - offset : 0;
+        const uint32_t record_start = tail + padding;
+        const uint32_t record_end = record_start + size;
+        if (record_end - header_->data_head.load(std::memory_order_seq_cst) > capacity) {
+            return false;
+        }
+        const uint64_t desired = (static_cast<uint64_t>(next_index + 1) << 32) | record_end;
+        if (header_->reserve.compare_exchange_weak(current, desired, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+            index = next_index;
+            start = record_start;
+            return true;
+        }
+    }
+}
+
+bool ShmChannel::reserveBlocking(uint32_t size, uint32_t& index, uint32_t& start) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(send_timeout_ms_);
+    while (true) {
+        // 先登记再重试，消费者释放后看到登记就会改变space_ready并唤醒
+        const uint32_t observed = header_->space_ready.load(std::memory_order_seq_cst);
+        header_->producers_waiting.fetch_add(1, std::memory_order_seq_cst);
+        const bool reserved = reserve(size, index, start);
+        const auto now = std::chrono::steady_clock::now();
+        if (!reserved && now < deadline && !stop_requested_.load()) {
+            const long remaining = static_cast<long>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+            futexWait(&header_->space_ready, observed, static_cast<int>(std::min<long>(remaining + 1, kWaitSliceMs)));
+        }
+        header_->producers_waiting.fetch_sub(1, std::memory_order_seq_cst);
+        if (reserved) return true;
+        if (now >= deadline || stop_requested_.load()) return false;
+    }
+}
+
+void ShmChannel::wakeConsumer() {
+    if (header_->consumer_waiting.load(std::memory_order_seq_cst) != 0) {
+        header_->data_ready.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(&header_->data_ready, 1);
+    }
+}
+
+// ==================== 接收 ====================
+
+bool ShmChannel::hasRecord() const {
+    const uint32_t index = header_->read_index.load(std::memory_order_relaxed);
+    return slots_[index & (header_->slot_count - 1)].sequence.load(std::memory_order_seq_cst) == index + 1;
+}
+
+bool ShmChannel::consumeOne() {
+    const uint32_t index = header_->read_index.load(std::memory_order_relaxed);
+    Slot& slot = slots_[index & (header_->slot_count - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+        return false;
+    }
+
+    const uint32_t capacity = header_->capacity;
+    const uint32_t offset = slot.start & (capacity - 1);
+    const char* record = data_ + offset;
+    const size_t size = slot.size;
+
+    RecordHeader rh;
+    bool valid = size >= sizeof(rh) && offset + size <= capacity;
+    if (valid) {
+        std::memcpy(&rh, record, sizeof(rh));
+        const size_t strings = sizeof(rh) + static_cast<size_t>(rh.topic_size) + rh.id_size + rh.sender_size +
+                               rh.receiver_size;
+        valid = strings <= rh.content_offset && static_cast<size_t>(rh.content_offset) + rh.content_size <= size &&
+                rh.priority <= static_cast<uint8_t>(MessagePriority::CRITICAL);
+    }
+
+    ChannelMessage msg;
+    if (valid) {
+        const char* src = record + sizeof(rh);
+        // 对端写入的主题和键只查找不驻留，避免驻留表无限增长
+        msg.topic = InternedString::lookupOrCopy(std::string_view(src, rh.topic_size));
+        src += rh.topic_size;
+        msg.id.assign(src, rh.id_size);
+        src += rh.id_size;
+        msg.sender.assign(src, rh.sender_size);
+        src += rh.sender_size;
+        msg.receiver.assign(src, rh.receiver_size);
+        src += rh.receiver_size;
+        msg.timestamp = rh.timestamp;
+        msg.priority = static_cast<MessagePriority>(rh.priority);
+
+        const char* meta_end = record + rh.content_offset;
+        for (uint16_t i = 0; i < rh.metadata_count && valid; ++i) {
+            uint32_t key_size = 0;
+            uint32_t value_size = 0;
+            if (static_cast<size_t>(meta_end - src) < 2 * sizeof(uint32_t)) {
+                valid = false;
+                break;
+            }
+            std::memcpy(&key_size, src, sizeof(key_size));
+            std::memcpy(&value_size, src + sizeof(key_size), sizeof(value_size));
+            src += 2 * sizeof(uint32_t);
+            if (static_cast<size_t>(meta_end - src) < static_cast<size_t>(key_size) + value_size) {
+                valid = false;
+                break;
+            }
+            msg.metadata.set(InternedString::lookupOrCopy(std::string_view(src, key_size)),
+                             std::string(src + key_size, value_size));
+            src += key_size + value_size;
+        }
+    }
+
+    if (!valid) {
+        notifyError("malformed shm record dropped");
+    } else if (payload_handler_) {
+        updateReceiveStats();
+        if (applyFilters(msg)) {
+            try {
+                payload_handler_(msg, std::string_view(record + rh.content_offset, rh.content_size),
+                                 static_cast<size_t>(data_ - static_cast<char*>(mapping_)) + offset +
+                                     rh.content_offset);
+            } catch (const std::exception& e) {
+                notifyError(std::string("payload handler threw: ") + e.what());
+            }
+        }
+    } else {
+        msg.content.assign(record + rh.content_offset, rh.content_size);
+        notifyMessageReceived(std::move(msg));
+    }
+
+    // 释放：先数据区后记录数，生产者以read_index判断描述符是否空闲
+    header_->data_head.store(slot.start + slot.size, std::memory_order_seq_cst);
+    header_->read_index.store(index + 1, std::memory_order_seq_cst);
+    if (header_->producers_waiting.load(std::memory_order_seq_cst) != 0) {
+        header_->space_ready.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(&header_->space_ready, INT_MAX);
+    }
+    return true;
+}
+
+void ShmChannel::receiveLoop() {
+    while (!stop_requested_.load()) {
+        size_t processed = 0;
+        while (processed < kReceiveBurst && consumeOne()) {
+            ++processed;
+        }
+        flushReceivedBatch(false);
+        if (processed > 0) {
+            continue;
+        }
+
+        // 先登记再检查，生产者发布后看到登记就会改变data_ready并唤醒
+        const uint32_t observed = header_->data_ready.load(std::memory_order_seq_cst);
+        header_->consumer_waiting.store(1, std::memory_order_seq_cst);
+        if (!hasRecord() && !stop_requested_.load()) {
+            futexWait(&header_->data_ready, observed, static_cast<int>(receiveBatchWaitMs(kWaitSliceMs)));
+        }
+        header_->consumer_waiting.store(0, std::memory_order_relaxed);
+    }
+    while (consumeOne()) {
+    }
+    flushReceivedBatch(true);
+}
+
+void ShmChannel::printStatistics() const {
+    Channel::printStatistics();
+    std::cout << "Shm Segment: " << shm_name_ << (owner_ ? " (owner)" : "") << std::endl;
+    std::cout << "Ring Capacity: " << getCapacity() << " bytes" << std::endl;
+    std::cout << "Pending Records: " << getPendingRecords() << std::endl;
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
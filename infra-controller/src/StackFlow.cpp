@@ -0,0 +1,1011 @@
+#include "../include/StackFlow.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace edge_infra {
+namespace infra_controller {
+
+namespace {
+
+uint64_t steadyMicros() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t systemMillis() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+const size_t kDefaultBatchSize = 64;
+
+// 并行分支的取消标记，嵌套的PARALLEL步骤通过parent串成一条链。
+// parent为共享所有权：外层步骤超时返回、外层group释放后，内层仍在运行的分支也能安全地沿链检查
+struct CancelScope {
+    std::atomic<bool> cancelled{false};
+    std::shared_ptr<const CancelScope> parent;
+
+    bool requested() const {
+        for (const CancelScope* scope = this; scope != nullptr; scope = scope->parent.get()) {
+            if (scope->cancelled.load(std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+};
+
+thread_local std::shared_ptr<const CancelScope> tls_cancel_scope;
+
+} // namespace
+
+// ==================== Event ====================
+
+Event::Event(EventType t, const InternedString& src, const InternedString& tgt)
+    : type(t), source(src), target(tgt), timestamp(systemMillis()), priority(1) {
+}
+
+void Event::setData(const InternedString& key, std::string value) {
+    data.set(key, std::move(value));
+}
+
+const std::string& Event::getData(std::string_view key) const {
+    static const std::string kEmpty;
+    auto it = data.find(key);
+    return it != data.end() ? it->second : kEmpty;
+}
+
+bool Event::hasData(std::string_view key) const {
+    return data.find(key) != data.end();
+}
+
+// ==================== WorkflowStep ====================
+
+// 一次PARALLEL执行的共享状态。持有事件副本，run_child/skip_child捕获子步骤所需对象的所有权，
+// 父步骤超时返回后仍在运行的子步骤可以安全地在后台结束
+struct WorkflowStep::ParallelGroup {
+    std::function<bool(size_t, const Event&)> run_child;
+    std::function<void(size_t)> skip_child;
+    size_t count = 0;
+    Event event;
+    std::shared_ptr<CancelScope> scope = std::make_shared<CancelScope>();
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> remaining{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+WorkflowStep::WorkflowStep(const std::string& name, StepType type)
+    : name_(name), type_(type), status_(StepStatus::PENDING), timeout_(0) {
+}
+
+bool WorkflowStep::cancelRequested() {
+    return tls_cancel_scope != nullptr && tls_cancel_scope->requested();
+}
+
+void WorkflowStep::setCondition(std::function<bool(const Event&)> cond) {
+    condition_ = std::move(cond);
+}
+
+void WorkflowStep::setAction(std::function<bool(const Event&)> act) {
+    action_ = std::move(act);
+}
+
+void WorkflowStep::addChild(std::shared_ptr<WorkflowStep> child) {
+    if (child) {
+        children_.push_back(std::move(child));
+    }
+}
+
+WorkflowStep::SelfResult WorkflowStep::runSelf(const Event& event, std::atomic<StepStatus>& status) const {
+    if (cancelRequested()) {
+        status.store(StepStatus::SKIPPED);
+        return SelfResult::FAILED;
+    }
+    status.store(StepStatus::RUNNING);
+    const auto start = std::chrono::steady_clock::now();
+
+    try {
+        if (type_ == StepType::CONDITION && condition_ && !condition_(event)) {
+            // 条件不满足时跳过整个分支，不视为失败
+            status.store(StepStatus::SKIPPED);
+            return SelfResult::SKIPPED;
+        }
+
+        if (action_ && !action_(event)) {
+            status.store(StepStatus::FAILED);
+            return SelfResult::FAILED;
+        }
+        if (type_ != StepType::PARALLEL && timeout_.count() > 0 &&
+            std::chrono::steady_clock::now() - start > timeout_) {
+            std::cerr << "[WorkflowStep " << name_ << "] timed out after " << timeout_.count() << "ms" << std::endl;
+            status.store(StepStatus::FAILED);
+            return SelfResult::FAILED;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[WorkflowStep " << name_ << "] exception: " << e.what() << std::endl;
+        status.store(StepStatus::FAILED);
+        return SelfResult::FAILED;
+    } catch (...) {
+        std::cerr << "[WorkflowStep " << name_ << "] non-standard exception" << std::endl;
+        status.store(StepStatus::FAILED);
+        return SelfResult::FAILED;
+    }
+    return SelfResult::PROCEED;
+}
+
+bool WorkflowStep::execute(const Event& event) {
+    switch (runSelf(event, status_)) {
+        case SelfResult::SKIPPED: return true;
+        case SelfResult::FAILED: return false;
+        case SelfResult::PROCEED: break;
+    }
+
+    bool ok = executeChildren(event);
+    setStatus(ok ? StepStatus::COMPLETED : StepStatus::FAILED);
+    return ok;
+}
+
+void WorkflowStep::reset() {
+    setStatus(StepStatus::PENDING);
+    for (auto& child : children_) {
+        child->reset();
+    }
+}
+
+std::string WorkflowStep::statusToString() const {
+    switch (getStatus()) {
+        case StepStatus::PENDING: return "PENDING";
+        case StepStatus::RUNNING: return "RUNNING";
+        case StepStatus::COMPLETED: return "COMPLETED";
+        case StepStatus::FAILED: return "FAILED";
+        case StepStatus::SKIPPED: return "SKIPPED";
+        default: return "UNKNOWN";
+    }
+}
+
+void WorkflowStep::printStepTree(int indent) const {
+    static const char* kTypeNames[] = {"CONDITION", "ACTION", "PARALLEL", "SEQUENTIAL"};
+    std::cout << std::string(static_cast<size_t>(indent) * 2, ' ')
+              << "- " << name_ << " [" << kTypeNames[static_cast<int>(type_)] << "] "
+              << statusToString() << std::endl;
+    for (const auto& child : children_) {
+        child->printStepTree(indent + 1);
+    }
+}
+
+bool WorkflowStep::executeChildren(const Event& event) {
+    if (children_.empty()) {
+        return true;
+    }
+    if (type_ == StepType::PARALLEL) {
+        return executeChildrenParallel(event);
+    }
+    return executeChildrenSequential(event);
+}
+
+void WorkflowStep::drainParallelGroup(const std::shared_ptr<ParallelGroup>& group) {
+    std::shared_ptr<const CancelScope> saved = std::move(tls_cancel_scope);
+    tls_cancel_scope = group->scope;
+
+    while (true) {
+        const size_t index = group->next.fetch_add(1);
+        if (index >= group->count) break;
+
+        if (group->scope->requested()) {
+            group->skip_child(index);
+        } else if (!group->run_child(index, group->event)) {
+            // 一个分支失败即取消其余分支
+            group->failed.store(true);
+            group->scope->cancelled.store(true);
+        }
+
+        if (group->remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(group->mutex);
+            group->cv.notify_all();
+        }
+    }
+
+    tls_cancel_scope = std::move(saved);
+}
+
+bool WorkflowStep::executeChildrenParallel(const Event& event) {
+    // 复制子步骤列表，超时后仍在运行的分支不依赖本对象
+    auto children = std::make_shared<const std::vector<std::shared_ptr<WorkflowStep>>>(children_);
+    return runParallel(
+        children->size(),
+        [children](size_t index, const Event& ev) { return (*children)[index]->execute(ev); },
+        [children](size_t index) { (*children)[index]->setStatus(StepStatus::SKIPPED); },
+        event);
+}
+
+bool WorkflowStep::runParallel(size_t count, std::function<bool(size_t, const Event&)> run_child,
+                               std::function<void(size_t)> skip_child, const Event& event) const {
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+    auto group = std::make_shared<ParallelGroup>();
+    group->run_child = std::move(run_child);
+    group->skip_child = std::move(skip_child);
+    group->count = count;
+    group->event = event;
+    group->scope->parent = tls_cancel_scope;
+    group->remaining.store(count);
+
+    // fan-out：最多投递 子步骤数-1 个取任务的helper，当前线程也参与执行（caller-runs），
+    // 线程池被占满或嵌套并行时仍能推进，不会死锁
+    std::shared_ptr<WorkflowExecutor> executor = executor_ ? executor_ : WorkflowExecutor::shared();
+    // 设置了超时时当前线程只负责等待，以便按时返回；若一个helper都没投递成功则仍由当前线程执行
+    const bool caller_runs = timeout_.count() == 0;
+    const size_t helpers = std::min(count - (caller_runs ? 1 : 0), executor->getThreadCount());
+    size_t submitted = 0;
+    for (; submitted < helpers; ++submitted) {
+        if (!executor->trySubmit([group] { drainParallelGroup(group); })) {
+            break;
+        }
+    }
+    if (caller_runs || submitted == 0) {
+        drainParallelGroup(group);
+    }
+
+    // fan-in
+    std::unique_lock<std::mutex> lock(group->mutex);
+    auto done = [&group] { return group->remaining.load() == 0; };
+    if (timeout_.count() > 0) {
+        if (!group->cv.wait_until(lock, deadline, done)) {
+            group->scope->cancelled.store(true);
+            std::cerr << "[WorkflowStep " << name_ << "] parallel step timed out after "
+                      << timeout_.count() << "ms" << std::endl;
+            return false;
+        }
+    } else {
+        group->cv.wait(lock, done);
+    }
+    return !group->failed.load();
+}
+
+bool WorkflowStep::executeChildrenSequential(const Event& event) {
+    for (auto& child : children_) {
+        if (cancelRequested() || !child->execute(event)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== CompiledWorkflow ====================
+
+static_assert(kEventTypeCount <= 32, "CompiledWorkflow::trigger_mask_ holds at most 32 event types");
+
+bool CompiledWorkflow::hasCycle(const WorkflowStep* step, std::vector<const WorkflowStep*>& path) {
+    if (std::find(path.begin(), path.end(), step) != path.end()) {
+        return true;
+    }
+    path.push_back(step);
+    for (const auto& child : step->children_) {
+        if (hasCycle(child.get(), path)) return true;
+    }
+    path.pop_back();
+    return false;
+}
+
+std::shared_ptr<const CompiledWorkflow> CompiledWorkflow::compile(const std::string& name,
+                                                                  std::shared_ptr<WorkflowStep> root,
+                                                                  const std::vector<EventType>& triggers) {
+    if (!root) return nullptr;
+
+    std::vector<const WorkflowStep*> path;
+    if (hasCycle(root.get(), path)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<CompiledWorkflow> compiled(new CompiledWorkflow());
+    compiled->name_ = name;
+    for (EventType type : triggers) {
+        compiled->trigger_mask_ |= 1u << static_cast<uint32_t>(type);
+    }
+
+    // 广度优先展开：处理到第i个步骤时把它的子步骤追加到数组末尾，子步骤下标自然连续。
+    // DAG中被多个父步骤共享的子步骤会展开多份，与按树执行的语义一致
+    std::vector<Step>& steps = compiled->steps_;
+    std::vector<const WorkflowStep*> sources{root.get()};
+    steps.push_back(Step{snapshot(*root), 0, 0});
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const WorkflowStep* step = sources[i];
+        steps[i].first_child = static_cast<uint32_t>(steps.size());
+        steps[i].child_count = static_cast<uint32_t>(step->children_.size());
+        for (const auto& child : step->children_) {
+            sources.push_back(child.get());
+            steps.push_back(Step{snapshot(*child), 0, 0});
+        }
+    }
+    compiled->root_ = std::move(root);
+    return compiled;
+}
+
+std::shared_ptr<const WorkflowStep> CompiledWorkflow::snapshot(const WorkflowStep& step) {
+    // 只复制runSelf/runParallel用到的配置，子步骤关系由steps_的下标表示
+    auto copy = std::make_shared<WorkflowStep>(step.name_, step.type_);
+    copy->condition_ = step.condition_;
+    copy->action_ = step.action_;
+    copy->timeout_ = step.timeout_;
+    copy->executor_ = step.executor_;
+    return copy;
+}
+
+// 一次执行的步骤状态，下标与steps_一致。由超时后仍在后台运行的并行分支共同持有
+struct CompiledWorkflow::RunContext {
+    std::unique_ptr<std::atomic<WorkflowStep::StepStatus>[]> status;
+
+    explicit RunContext(size_t count) : status(new std::atomic<WorkflowStep::StepStatus>[count]) {
+        for (size_t i = 0; i < count; ++i) {
+            status[i].store(WorkflowStep::StepStatus::PENDING, std::memory_order_relaxed);
+        }
+    }
+};
+
+bool CompiledWorkflow::execute(const Event& event, std::vector<WorkflowStep::StepStatus>* statuses) const {
+    auto run = std::make_shared<RunContext>(steps_.size());
+    const bool ok = runStep(0, event, run);
+    if (statuses != nullptr) {
+        statuses->clear();
+        statuses->reserve(steps_.size());
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            statuses->push_back(run->status[i].load());
+        }
+    }
+    return ok;
+}
+
+bool CompiledWorkflow::runStep(uint32_t index, const Event& event, const std::shared_ptr<RunContext>& run) const {
+    const Step& s = steps_[index];
+    const WorkflowStep* step = s.step.get();
+    std::atomic<WorkflowStep::StepStatus>& status = run->status[index];
+
+    switch (step->runSelf(event, status)) {
+        case WorkflowStep::SelfResult::SKIPPED: return true;
+        case WorkflowStep::SelfResult::FAILED: return false;
+        case WorkflowStep::SelfResult::PROCEED: break;
+    }
+
+    bool ok = true;
+    if (s.child_count > 0) {
+        if (step->type_ == WorkflowStep::StepType::PARALLEL) {
+            // 并行分支交给步骤自身的fan-out逻辑；分支持有工作流和本次执行状态的所有权，超时返回后仍可安全结束
+            std::shared_ptr<const CompiledWorkflow> self = shared_from_this();
+            const uint32_t first = s.first_child;
+            ok = step->runParallel(
+                s.child_count,
+                [self, run, first](size_t i, const Event& ev) {
+                    return self->runStep(first + static_cast<uint32_t>(i), ev, run);
+                },
+                [run, first](size_t i) { run->status[first + i].store(WorkflowStep::StepStatus::SKIPPED); },
+                event);
+        } else {
+            const uint32_t end = s.first_child + s.child_count;
+            for (uint32_t child = s.first_child; child < end; ++child) {
+                if (WorkflowStep::cancelRequested() || !runStep(child, event, run)) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+    status.store(ok ? WorkflowStep::StepStatus::COMPLETED : WorkflowStep::StepStatus::FAILED);
+    return ok;
+}
+
+// ==================== StackFlow ====================
+
+StackFlow::StackFlow(const std::string& name)
+    : name_(name),
+      running_(false),
+      stop_requested_(false),
+      handler_epoch_(0),
+      has_retired_lists_(false),
+      pending_events_(0),
+      consumer_waiting_(false),
+      dequeue_policy_(DequeuePolicy::STRICT),
+      lane_weights_{{1, 2, 4, 8}},
+      batch_size_(kDefaultBatchSize),
+      worker_threads_(0),
+      blocking_threads_(0),
+      debug_enabled_(false) {
+    for (auto& slot : handler_lists_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    publishWorkflowTable(std::make_shared<WorkflowTable>());
+
+    metrics::MetricsRegistry& registry = metrics::MetricsRegistry::instance();
+    const std::string labels = metrics::label("flow", name_);
+    queue_wait_metric_ = registry.histogram("edge_controller_event_queue_wait_us",
+                                            "Time events spend queued before dispatch in microseconds", labels);
+    handler_duration_metric_ = registry.histogram("edge_controller_handler_duration_us",
+                                                  "Event handler execution time in microseconds", labels);
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_controller_events_processed_total", "Events dispatched to handlers", metrics::MetricType::kCounter,
+        labels, [this] { return static_cast<double>(events_processed_.value()); }));
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_controller_workflows_executed_total", "Workflows executed", metrics::MetricType::kCounter,
+        labels, [this] { return static_cast<double>(workflows_executed_.value()); }));
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_controller_errors_total", "Handler and workflow failures", metrics::MetricType::kCounter,
+        labels, [this] { return static_cast<double>(errors_count_.value()); }));
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_controller_pending_events", "Events waiting in the dispatch queues", metrics::MetricType::kGauge,
+        labels, [this] { return static_cast<double>(pending_events_.load(std::memory_order_relaxed)); }));
+}
+
+StackFlow::~StackFlow() {
+    for (uint64_t handle : metric_handles_) {
+        metrics::MetricsRegistry::instance().unregisterCallback(handle);
+    }
+    stop();
+    for (auto& slot : handler_lists_) {
+        delete slot.exchange(nullptr);
+    }
+    reclaimHandlerLists();
+}
+
+bool StackFlow::start() {
+    if (running_) {
+        return false;
+    }
+
+    stop_requested_.store(false);
+    if (worker_threads_ > 0) {
+        worker_pool_ = std::make_unique<StrandExecutor>(name_ + "-worker", worker_threads_);
+        worker_pool_->start();
+    }
+    if (blocking_threads_ > 0) {
+        blocking_pool_ = std::make_unique<StrandExecutor>(name_ + "-blocking", blocking_threads_);
+        blocking_pool_->start();
+    }
+    running_ = true;
+    event_thread_ = std::thread(&StackFlow::eventProcessingLoop, this);
+    debugLog("started");
+    return true;
+}
+
+void StackFlow::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stop_requested_.store(true);
+    }
+    queue_cv_.notify_all();
+    if (event_thread_.joinable()) {
+        event_thread_.join();
+    }
+    // 事件线程退出后不再有新任务，依次等待两个线程池处理完已分发的事件
+    if (worker_pool_) {
+        worker_pool_->stop();
+    }
+    if (blocking_pool_) {
+        blocking_pool_->stop();
+    }
+    worker_pool_.reset();
+    blocking_pool_.reset();
+    // 所有分发线程都已退出，可以安全释放被替换下来的处理器表
+    reclaimHandlerLists();
+    running_ = false;
+    debugLog("stopped, " + std::to_string(pending_events_.load()) + " events left in queue");
+}
+
+size_t StackFlow::eventTypeIndex(EventType type) {
+    const size_t index = static_cast<size_t>(type);
+    // 越界的强制转换值按CUSTOM处理
+    return index < kEventTypeCount ? index : static_cast<size_t>(EventType::CUSTOM);
+}
+
+void StackFlow::replaceHandlerList(EventType type, std::unique_ptr<HandlerList> list) {
+    if (list && list->owners.empty()) {
+        list.reset();
+    }
+    if (list) {
+        std::vector<std::shared_ptr<EventHandler>> blocking;
+        for (const auto& handler : list->owners) {
+            if (handler->isBlocking()) {
+                blocking.push_back(handler);
+            } else {
+                list->inline_handlers.push_back(handler.get());
+            }
+        }
+        if (!blocking.empty()) {
+            list->blocking_handlers =
+                std::make_shared<const std::vector<std::shared_ptr<EventHandler>>>(std::move(blocking));
+        }
+    }
+
+    // 调用方持有handlers_mutex_。与读者的登记/读取构成Dekker式握手，均使用seq_cst：
+    // 读到旧表的读者，其登记一定能被之后推进宽限期时的检查看到
+    const HandlerList* old = handler_lists_[eventTypeIndex(type)].exchange(list.release(), std::memory_order_seq_cst);
+    if (old != nullptr) {
+        retired_handler_lists_.push_back({std::unique_ptr<const HandlerList>(old), handler_epoch_.load()});
+    }
+    advanceHandlerEpoch();
+}
+
+void StackFlow::advanceHandlerEpoch() {
+    while (!retired_handler_lists_.empty()) {
+        // 推进到epoch+1后新读者登记到(epoch+1)&1槽，该槽中不能还有更早的读者
+        const uint64_t epoch = handler_epoch_.load();
+        uint64_t readers = 0;
+        for (const ReaderSlot& slot : handler_readers_[(epoch + 1) & 1]) {
+            readers += slot.count.load();
+        }
+        if (readers != 0) break;
+        handler_epoch_.store(epoch + 1);
+
+        // 替换后两个槽都已归零过一次，读到旧表的读者均已结束
+        retired_handler_lists_.erase(
+            std::remove_if(retired_handler_lists_.begin(), retired_handler_lists_.end(),
+                           [epoch](const RetiredHandlerList& retired) { return retired.epoch + 2 <= epoch + 1; }),
+            retired_handler_lists_.end());
+    }
+    has_retired_lists_.store(!retired_handler_lists_.empty(), std::memory_order_release);
+}
+
+void StackFlow::tryReclaimHandlerLists() {
+    if (!has_retired_lists_.load(std::memory_order_acquire)) return;
+    std::unique_lock<std::mutex> lock(handlers_mutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+        advanceHandlerEpoch();
+    }
+}
+
+void StackFlow::reclaimHandlerLists() {
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    retired_handler_lists_.clear();
+    has_retired_lists_.store(false, std::memory_order_release);
+}
+
+StackFlow::HandlerReadScope::HandlerReadScope(StackFlow* flow)
+    : flow_(flow), bucket_(flow->handler_epoch_.load() & 1) {
+    flow_->handler_readers_[bucket_][metrics::threadShard()].count.fetch_add(1);
+}
+
+StackFlow::HandlerReadScope::~HandlerReadScope() {
+    flow_->handler_readers_[bucket_][metrics::threadShard()].count.fetch_sub(1, std::memory_order_release);
+}
+
+void StackFlow::registerHandler(EventType type, std::shared_ptr<EventHandler> handler) {
+    if (!handler) return;
+
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    auto list = std::make_unique<HandlerList>();
+    if (const HandlerList* current = handler_lists_[eventTypeIndex(type)].load(std::memory_order_acquire)) {
+        list->owners = current->owners;
+    }
+    list->owners.push_back(handler);
+    replaceHandlerList(type, std::move(list));
+    debugLog("registered handler " + handler->getHandlerName() + " for " + eventTypeToString(type));
+}
+
+void StackFlow::unregisterHandler(EventType type, const std::string& handler_name) {
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    const HandlerList* current = handler_lists_[eventTypeIndex(type)].load(std::memory_order_acquire);
+    if (current == nullptr) return;
+
+    auto list = std::make_unique<HandlerList>();
+    for (const auto& handler : current->owners) {
+        if (handler->getHandlerName() != handler_name) {
+            list->owners.push_back(handler);
+        }
+    }
+    if (list->owners.size() == current->owners.size()) return;
+    replaceHandlerList(type, std::move(list));
+}
+
+void StackFlow::unregisterAllHandlers(EventType type) {
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    replaceHandlerList(type, nullptr);
+}
+
+void StackFlow::publishEvent(Event&& event) {
+    EventLane& lane = lanes_[laneForPriority(event.priority)];
+
+    QueuedEvent queued;
+    queued.event = std::move(event);
+    queued.enqueue_us = steadyMicros();
+    // 计数先于入队增加，消费者的fetch_sub不会先于对应的fetch_add发生而回绕
+    lane.depth.fetch_add(1, std::memory_order_relaxed);
+    lane.enqueued.fetch_add(1, std::memory_order_relaxed);
+    pending_events_.fetch_add(1);
+    lane.queue.push(std::move(queued));
+
+    // 与消费者的consumer_waiting_/pending_events_检查构成Dekker式握手，均使用seq_cst
+    if (consumer_waiting_.load()) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_cv_.notify_one();
+    }
+}
+
+void StackFlow::publishEvent(const Event& event) {
+    publishEvent(Event(event));
+}
+
+void StackFlow::publishEvent(EventType type, const InternedString& source, const InternedString& target) {
+    publishEvent(Event(type, source, target));
+}
+
+std::shared_ptr<const StackFlow::WorkflowTable> StackFlow::loadWorkflowTable() const {
+    return std::atomic_load_explicit(&workflow_table_, std::memory_order_acquire);
+}
+
+void StackFlow::publishWorkflowTable(std::shared_ptr<const WorkflowTable> table) {
+    std::atomic_store_explicit(&workflow_table_, std::move(table), std::memory_order_release);
+}
+
+bool StackFlow::registerWorkflow(const std::string& name, std::shared_ptr<WorkflowStep> workflow,
+                                 const std::vector<EventType>& triggers) {
+    auto compiled = CompiledWorkflow::compile(name, std::move(workflow), triggers);
+    if (!compiled) {
+        debugLog("workflow rejected (empty or cyclic): " + name);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(workflow_mutex_);
+    auto table = std::make_shared<WorkflowTable>(*loadWorkflowTable());
+    table->by_name[name] = compiled;
+    for (size_t i = 0; i < kEventTypeCount; ++i) {
+        auto& list = table->by_event[i];
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [&name](const std::shared_ptr<const CompiledWorkflow>& w) {
+                                      return w->getName() == name;
+                                  }),
+                   list.end());
+        if (compiled->isTriggeredBy(static_cast<EventType>(i))) {
+            list.push_back(compiled);
+        }
+    }
+    publishWorkflowTable(std::move(table));
+    debugLog("registered workflow " + name + " (" + std::to_string(compiled->getStepCount()) + " steps)");
+    return true;
+}
+
+void StackFlow::unregisterWorkflow(const std::string& name) {
+    std::lock_guard<std::mutex> lock(workflow_mutex_);
+    auto current = loadWorkflowTable();
+    if (current->by_name.find(name) == current->by_name.end()) return;
+
+    auto table = std::make_shared<WorkflowTable>(*current);
+    table->by_name.erase(name);
+    for (auto& list : table->by_event) {
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [&name](const std::shared_ptr<const CompiledWorkflow>& w) {
+                                      return w->getName() == name;
+                                  }),
+                   list.end());
+    }
+    publishWorkflowTable(std::move(table));
+}
+
+bool StackFlow::executeWorkflow(const std::string& name, const Event& trigger_event) {
+    auto table = loadWorkflowTable();
+    auto it = table->by_name.find(name);
+    if (it == table->by_name.end()) {
+        debugLog("workflow not found: " + name);
+        return false;
+    }
+    return runCompiledWorkflow(*it->second, trigger_event);
+}
+
+bool StackFlow::runCompiledWorkflow(const CompiledWorkflow& workflow, const Event& event) {
+    bool ok = workflow.execute(event);
+    workflows_executed_.increment();
+    if (!ok) {
+        errors_count_.increment();
+        debugLog("workflow failed: " + workflow.getName());
+    }
+    return ok;
+}
+
+size_t StackFlow::getQueueSize() const {
+    return static_cast<size_t>(pending_events_.load());
+}
+
+StackFlow::LaneStats StackFlow::getLaneStats(size_t lane) const {
+    LaneStats stats{};
+    if (lane >= kEventLaneCount) return stats;
+
+    const EventLane& l = lanes_[lane];
+    stats.depth = l.depth.load(std::memory_order_relaxed);
+    stats.enqueued = l.enqueued.load(std::memory_order_relaxed);
+    stats.dequeued = l.dequeued.load(std::memory_order_relaxed);
+    stats.max_wait_us = l.max_wait_us.load(std::memory_order_relaxed);
+    stats.avg_wait_us = stats.dequeued > 0 ? l.total_wait_us.load(std::memory_order_relaxed) / stats.dequeued : 0;
+    return stats;
+}
+
+void StackFlow::setLaneWeights(const std::array<uint32_t, kEventLaneCount>& weights) {
+    for (size_t i = 0; i < kEventLaneCount; ++i) {
+        lane_weights_[i] = std::max<uint32_t>(weights[i], 1);
+    }
+}
+
+void StackFlow::setWorkerThreads(size_t worker_threads, size_t blocking_threads) {
+    if (running_) {
+        debugLog("setWorkerThreads ignored while running");
+        return;
+    }
+    worker_threads_ = worker_threads;
+    blocking_threads_ = blocking_threads;
+}
+
+void StackFlow::enableDebug(bool enable) {
+    debug_enabled_ = enable;
+}
+
+void StackFlow::printStatistics() const {
+    static const char* kLaneNames[kEventLaneCount] = {"LOW", "NORMAL", "HIGH", "CRITICAL"};
+
+    std::cout << "=== StackFlow Statistics [" << name_ << "] ===" << std::endl;
+    std::cout << "Running: " << (running_ ? "yes" : "no") << std::endl;
+    std::cout << "Events Processed: " << getEventsProcessed() << std::endl;
+    std::cout << "Workflows Executed: " << getWorkflowsExecuted() << std::endl;
+    std::cout << "Errors: " << getErrorsCount() << std::endl;
+    std::cout << "Queue Size: " << getQueueSize() << std::endl;
+    std::cout << "Dequeue Policy: " << (getDequeuePolicy() == DequeuePolicy::STRICT ? "STRICT" : "WEIGHTED")
+              << std::endl;
+    for (size_t i = kEventLaneCount; i-- > 0;) {
+        LaneStats stats = getLaneStats(i);
+        std::cout << "  Lane " << kLaneNames[i] << ": depth=" << stats.depth
+                  << " enqueued=" << stats.enqueued << " dequeued=" << stats.dequeued
+                  << " avg_wait=" << stats.avg_wait_us << "us max_wait=" << stats.max_wait_us << "us"
+                  << std::endl;
+    }
+    for (const StrandExecutor* pool : {worker_pool_.get(), blocking_pool_.get()}) {
+        if (!pool) continue;
+        std::cout << "  Pool " << pool->getName() << ": threads=" << pool->getThreadCount()
+                  << " executed=" << pool->getTasksExecuted() << " stolen=" << pool->getTasksStolen()
+                  << " pending=" << pool->getPendingTasks() << std::endl;
+    }
+}
+
+void StackFlow::printRegisteredHandlers() const {
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    std::cout << "=== Registered Handlers [" << name_ << "] ===" << std::endl;
+    for (size_t i = 0; i < kEventTypeCount; ++i) {
+        const HandlerList* list = handler_lists_[i].load(std::memory_order_acquire);
+        if (list == nullptr) continue;
+        std::cout << eventTypeToString(static_cast<EventType>(i)) << ":" << std::endl;
+        for (const auto& handler : list->owners) {
+            std::cout << "  - " << handler->getHandlerName() << (handler->isBlocking() ? " (blocking)" : "")
+                      << std::endl;
+        }
+    }
+}
+
+void StackFlow::printRegisteredWorkflows() const {
+    auto table = loadWorkflowTable();
+    std::cout << "=== Registered Workflows [" << name_ << "] ===" << std::endl;
+    for (const auto& pair : table->by_name) {
+        std::cout << pair.first << " (" << pair.second->getStepCount() << " steps), triggers:";
+        for (size_t i = 0; i < kEventTypeCount; ++i) {
+            if (pair.second->isTriggeredBy(static_cast<EventType>(i))) {
+                std::cout << " " << eventTypeToString(static_cast<EventType>(i));
+            }
+        }
+        std::cout << std::endl;
+        pair.second->getRoot()->printStepTree(1);
+    }
+}
+
+size_t StackFlow::laneForPriority(uint32_t priority) {
+    return priority < kEventLaneCount ? priority : kEventLaneCount - 1;
+}
+
+bool StackFlow::popFromLane(size_t lane_index, std::vector<QueuedEvent>& batch) {
+    EventLane& lane = lanes_[lane_index];
+    if (lane.depth.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    QueuedEvent queued;
+    if (!lane.queue.tryPop(queued)) {
+        // 生产者尚未完成链接，下一轮再取
+        return false;
+    }
+
+    lane.depth.fetch_sub(1, std::memory_order_relaxed);
+    lane.dequeued.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t wait_us = steadyMicros() - queued.enqueue_us;
+    queue_wait_metric_->record(wait_us);
+    lane.total_wait_us.fetch_add(wait_us, std::memory_order_relaxed);
+    if (wait_us > lane.max_wait_us.load(std::memory_order_relaxed)) {
+        // 只有消费者线程写入，无需CAS
+        lane.max_wait_us.store(wait_us, std::memory_order_relaxed);
+    }
+    batch.push_back(std::move(queued));
+    return true;
+}
+
+size_t StackFlow::dequeueBatch(std::vector<QueuedEvent>& batch) {
+    batch.clear();
+
+    if (dequeue_policy_.load(std::memory_order_relaxed) == DequeuePolicy::STRICT) {
+        // 每取一个都从最高优先级重新检查，高优先级事件到达后立即插队
+        while (batch.size() < batch_size_) {
+            bool found = false;
+            for (size_t lane = kEventLaneCount; lane-- > 0;) {
+                if (popFromLane(lane, batch)) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) break;
+        }
+    } else {
+        while (batch.size() < batch_size_) {
+            bool found = false;
+            for (size_t lane = kEventLaneCount; lane-- > 0 && batch.size() < batch_size_;) {
+                for (uint32_t n = 0; n < lane_weights_[lane] && batch.size() < batch_size_; ++n) {
+                    if (!popFromLane(lane, batch)) break;
+                    found = true;
+                }
+            }
+            if (!found) break;
+        }
+    }
+
+    pending_events_.fetch_sub(batch.size());
+    return batch.size();
+}
+
+void StackFlow::eventProcessingLoop() {
+    std::vector<QueuedEvent> batch;
+    batch.reserve(batch_size_);
+
+    while (!stop_requested_.load()) {
+        if (dequeueBatch(batch) == 0) {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            consumer_waiting_.store(true);
+            queue_cv_.wait(lock, [this] { return stop_requested_.load() || pending_events_.load() > 0; });
+            consumer_waiting_.store(false);
+            continue;
+        }
+
+        // 已出队的事件不再计入pending_events_，停止时也要分发完，否则会被静默丢弃
+        for (auto& queued : batch) {
+            dispatchEvent(std::move(queued.event));
+        }
+        // 批次之间释放已过宽限期的旧处理器表
+        tryReclaimHandlerLists();
+    }
+}
+
+size_t StackFlow::sourceKey(const Event& event) {
+    return event.source.hash();
+}
+
+void StackFlow::dispatchEvent(Event&& event) {
+    if (!worker_pool_) {
+        processEvent(event);
+        return;
+    }
+
+    const size_t key = sourceKey(event);
+    worker_pool_->post(key, [this, ev = std::move(event)] { processEvent(ev); });
+}
+
+void StackFlow::processEvent(const Event& event) {
+    {
+        HandlerReadScope scope(this);
+        const HandlerList* list = handler_lists_[eventTypeIndex(event.type)].load(std::memory_order_seq_cst);
+        if (list != nullptr) {
+            runHandlers(event, *list);
+        }
+    }
+
+    triggerWorkflows(event);
+    events_processed_.increment();
+}
+
+void StackFlow::runHandlers(const Event& event, const HandlerList& list) {
+    if (!blocking_pool_) {
+        for (const auto& handler : list.owners) {
+            runHandler(event, handler.get());
+        }
+        return;
+    }
+    if (list.blocking_handlers) {
+        // 阻塞处理器同样按source分片，同一source的阻塞处理仍保持顺序。
+        // 任务持有处理器列表本身，已注销的处理器在排队的任务执行完后释放
+        blocking_pool_->post(sourceKey(event), [this, ev = event, handlers = list.blocking_handlers] {
+            for (const auto& handler : *handlers) {
+                runHandler(ev, handler.get());
+            }
+        });
+    }
+    for (EventHandler* handler : list.inline_handlers) {
+        runHandler(event, handler);
+    }
+}
+
+void StackFlow::runHandler(const Event& event, EventHandler* handler) {
+    metrics::ScopedLatency latency(handler_duration_metric_);
+    try {
+        if (!handler->handleEvent(event)) {
+            errors_count_.increment();
+            debugLog("handler " + handler->getHandlerName() + " failed on " + eventTypeToString(event.type));
+        }
+    } catch (const std::exception& e) {
+        errors_count_.increment();
+        debugLog("handler " + handler->getHandlerName() + " threw: " + e.what());
+    }
+}
+
+void StackFlow::triggerWorkflows(const Event& event) {
+    auto table = loadWorkflowTable();
+
+    // 按事件类型触发：数组下标直接定位，无锁
+    for (const auto& workflow : table->by_event[eventTypeIndex(event.type)]) {
+        runCompiledWorkflow(*workflow, event);
+    }
+
+    // 事件通过data["workflow"]或target按名称指定要触发的工作流
+    const std::string* name = &event.target.str();
+    auto data_it = event.data.find("workflow");
+    if (data_it != event.data.end() && !data_it->second.empty()) {
+        name = &data_it->second;
+    }
+    if (name->empty() || table->by_name.empty()) return;
+
+    auto it = table->by_name.find(*name);
+    if (it == table->by_name.end()) return;
+    // 同一个工作流已经由事件类型触发过时不再重复执行
+    if (it->second->isTriggeredBy(event.type)) return;
+    runCompiledWorkflow(*it->second, event);
+}
+
+void StackFlow::debugLog(const std::string& message) const {
+    if (!debug_enabled_) return;
+    std::cout << "[StackFlow " << name_ << "] " << message << std::endl;
+}
+
+// ==================== SimpleEventHandler ====================
+
+SimpleEventHandler::SimpleEventHandler(const std::string& name,
+                                       const std::vector<EventType>& events,
+                                       std::function<bool(const Event&)> func)
+    : name_(name), supported_events_(events), handler_func_(std::move(func)), blocking_(false) {
+}
+
+bool SimpleEventHandler::handleEvent(const Event& event) {
+    return handler_func_ ? handler_func_(event) : false;
+}
+
+// ==================== 工具函数 ====================
+
+std::string eventTypeToString(EventType type) {
+    switch (type) {
+        case EventType::SYSTEM_START: return "SYSTEM_START";
+        case EventType::SYSTEM_STOP: return "SYSTEM_STOP";
+        case EventType::SERVICE_REGISTER: return "SERVICE_REGISTER";
+        case EventType::SERVICE_UNREGISTER: return "SERVICE_UNREGISTER";
+        case EventType::MESSAGE_RECEIVED: return "MESSAGE_RECEIVED";
+        case EventType::CONNECTION_ESTABLISHED: return "CONNECTION_ESTABLISHED";
+        case EventType::CONNECTION_LOST: return "CONNECTION_LOST";
+        case EventType::ERROR_OCCURRED: return "ERROR_OCCURRED";
+        case EventType::CUSTOM: return "CUSTOM";
+        default: return "UNKNOWN";
+    }
+}
+
+EventType stringToEventType(const std::string& str) {
+    if (str == "SYSTEM_START") return EventType::SYSTEM_START;
+    if (str == "SYSTEM_STOP") return EventType::SYSTEM_STOP;
+    if (str == "SERVICE_REGISTER") return EventType::SERVICE_REGISTER;
+    if (str == "SERVICE_UNREGISTER") return EventType::SERVICE_UNREGISTER;
+    if (str == "MESSAGE_RECEIVED") return EventType::MESSAGE_RECEIVED;
+    if (str == "CONNECTION_ESTABLISHED") return EventType::CONNECTION_ESTABLISHED;
+    if (str == "CONNECTION_LOST") return EventType::CONNECTION_LOST;
+    if (str == "ERROR_OCCURRED") return EventType::ERROR_OCCURRED;
+    return EventType::CUSTOM;
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,177 @@
+#include "../include/StrandExecutor.h"
+#include <iostream>
+
+namespace edge_infra {
+namespace infra_controller {
+
+StrandExecutor::StrandExecutor(const std::string& name, size_t thread_count, size_t strand_count)
+    : name_(name),
+      ready_count_(0),
+      idle_workers_(0),
+      running_(false),
+      stopping_(false),
+      tasks_executed_(0),
+      tasks_stolen_(0),
+      pending_tasks_(0) {
+    if (thread_count == 0) thread_count = 1;
+    if (strand_count == 0) strand_count = thread_count * 16;
+
+    strands_.reserve(strand_count);
+    for (size_t i = 0; i < strand_count; ++i) {
+        strands_.push_back(std::make_unique<Strand>());
+    }
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+}
+
+StrandExecutor::~StrandExecutor() {
+    stop();
+}
+
+void StrandExecutor::start() {
+    if (running_.exchange(true)) return;
+
+    stopping_.store(false);
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&StrandExecutor::workerLoop, this, i);
+    }
+}
+
+void StrandExecutor::stop() {
+    if (!running_.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stopping_.store(true);
+    }
+    idle_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool StrandExecutor::post(size_t key, Task task) {
+    if (!running_.load() || !task) return false;
+
+    const size_t index = key % strands_.size();
+    Strand& strand = *strands_[index];
+    bool need_schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(strand.mutex);
+        strand.tasks.push_back(std::move(task));
+        if (!strand.scheduled) {
+            strand.scheduled = true;
+            need_schedule = true;
+        }
+    }
+    pending_tasks_++;
+
+    if (need_schedule) {
+        // 同一个strand固定优先投递给同一个worker，保持缓存亲和
+        schedule(index, index % workers_.size());
+    }
+    return true;
+}
+
+void StrandExecutor::schedule(size_t strand, size_t worker) {
+    {
+        std::lock_guard<std::mutex> lock(workers_[worker]->mutex);
+        workers_[worker]->ready.push_back(strand);
+    }
+    // ready_count_与idle_workers_的检查顺序和workerLoop相反，均为seq_cst，不会丢失唤醒
+    ready_count_.fetch_add(1);
+    if (idle_workers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_one();
+    }
+}
+
+bool StrandExecutor::popLocal(size_t worker, size_t& strand) {
+    Worker& w = *workers_[worker];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.ready.empty()) return false;
+    strand = w.ready.front();
+    w.ready.pop_front();
+    ready_count_.fetch_sub(1);
+    return true;
+}
+
+bool StrandExecutor::steal(size_t worker, size_t& strand) {
+    const size_t count = workers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(worker + offset) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.ready.empty()) continue;
+
+        // 从尾部窃取，与本地worker从头部取的位置错开
+        strand = victim.ready.back();
+        victim.ready.pop_back();
+        ready_count_.fetch_sub(1);
+        tasks_stolen_++;
+        return true;
+    }
+    return false;
+}
+
+void StrandExecutor::runStrand(size_t worker, size_t index) {
+    Strand& strand = *strands_[index];
+
+    for (size_t n = 0; n < kStrandBudget; ++n) {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(strand.mutex);
+            if (strand.tasks.empty()) {
+                strand.scheduled = false;
+                return;
+            }
+            task = std::move(strand.tasks.front());
+            strand.tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "[StrandExecutor " << name_ << "] task threw: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "[StrandExecutor " << name_ << "] task threw unknown exception" << std::endl;
+        }
+        tasks_executed_++;
+        pending_tasks_--;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(strand.mutex);
+        if (strand.tasks.empty()) {
+            strand.scheduled = false;
+            return;
+        }
+    }
+    // 预算用完仍有任务，排到本地队列尾部，让其他strand有机会执行
+    schedule(index, worker);
+}
+
+void StrandExecutor::workerLoop(size_t index) {
+    while (true) {
+        size_t strand = 0;
+        if (popLocal(index, strand) || steal(index, strand)) {
+            runStrand(index, strand);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_workers_.fetch_add(1);
+        idle_cv_.wait(lock, [this] { return ready_count_.load() > 0 || stopping_.load(); });
+        idle_workers_.fetch_sub(1);
+        // 停止时先把剩余任务执行完
+        if (stopping_.load() && ready_count_.load() == 0) {
+            break;
+        }
+    }
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
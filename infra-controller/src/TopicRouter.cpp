@@ -0,0 +1,150 @@
+#include "../include/TopicRouter.h"
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace edge_infra {
+namespace infra_controller {
+
+struct TopicRouter::Node {
+    std::string segment;           // children的键指向子节点自己的segment，查找时不构造string
+    std::unordered_map<std::string_view, std::unique_ptr<Node>> children;
+    std::unique_ptr<Node> star;    // '*'
+    std::unique_ptr<Node> hash;    // '#'
+    ChannelList channels;          // 在此结束的模式对应的通道
+};
+
+struct TopicRouter::Snapshot {
+    static const size_t kCacheShards = 16;
+
+    struct CacheShard {
+        std::mutex mutex;
+        std::unordered_map<InternedString, std::shared_ptr<const ChannelList>> entries;
+    };
+
+    Node root;
+    size_t route_count = 0;
+    mutable std::array<CacheShard, kCacheShards> cache;
+
+    void collect(const Node& node, const std::vector<std::string_view>& segments, size_t index,
+                 ChannelList& out) const {
+        if (node.hash) {
+            // '#'可以吞掉从index开始的任意段数（包括零段）
+            for (size_t k = index; k <= segments.size(); ++k) {
+                collect(*node.hash, segments, k, out);
+            }
+        }
+        if (index == segments.size()) {
+            for (const auto& channel : node.channels) {
+                if (std::find(out.begin(), out.end(), channel) == out.end()) {
+                    out.push_back(channel);
+                }
+            }
+            return;
+        }
+        if (node.star) {
+            collect(*node.star, segments, index + 1, out);
+        }
+        auto it = node.children.find(segments[index]);
+        if (it != node.children.end()) {
+            collect(*it->second, segments, index + 1, out);
+        }
+    }
+};
+
+namespace {
+
+std::vector<std::string_view> splitTopic(std::string_view topic) {
+    std::vector<std::string_view> segments;
+    if (topic.empty()) return segments;
+    size_t start = 0;
+    while (true) {
+        const size_t dot = topic.find('.', start);
+        segments.push_back(topic.substr(start, dot == std::string_view::npos ? std::string_view::npos : dot - start));
+        if (dot == std::string_view::npos) break;
+        start = dot + 1;
+    }
+    return segments;
+}
+
+} // namespace
+
+TopicRouter::TopicRouter() : cache_hits_(0), cache_misses_(0) {
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::make_shared<Snapshot>()));
+}
+
+TopicRouter::~TopicRouter() = default;
+
+std::shared_ptr<const TopicRouter::Snapshot> TopicRouter::load() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+}
+
+void TopicRouter::rebuild(const std::vector<Route>& routes) {
+    auto snapshot = std::make_shared<Snapshot>();
+    for (const auto& route : routes) {
+        if (!route.second) continue;
+
+        Node* node = &snapshot->root;
+        for (std::string_view segment : splitTopic(route.first)) {
+            if (segment == "*" || segment == "#") {
+                std::unique_ptr<Node>& next = segment == "*" ? node->star : node->hash;
+                if (!next) {
+                    next.reset(new Node());
+                }
+                node = next.get();
+                continue;
+            }
+
+            auto it = node->children.find(segment);
+            if (it == node->children.end()) {
+                std::unique_ptr<Node> child(new Node());
+                child->segment.assign(segment.data(), segment.size());
+                const std::string_view key(child->segment);
+                it = node->children.emplace(key, std::move(child)).first;
+            }
+            node = it->second.get();
+        }
+        if (std::find(node->channels.begin(), node->channels.end(), route.second) == node->channels.end()) {
+            node->channels.push_back(route.second);
+        }
+        ++snapshot->route_count;
+    }
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const Snapshot>(std::move(snapshot)),
+                               std::memory_order_release);
+}
+
+std::shared_ptr<const TopicRouter::ChannelList> TopicRouter::match(const InternedString& topic) const {
+    auto snapshot = load();
+    auto& shard = snapshot->cache[topic.hash() % Snapshot::kCacheShards];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(topic);
+        if (it != shard.entries.end()) {
+            cache_hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    cache_misses_.fetch_add(1, std::memory_order_relaxed);
+    auto result = std::make_shared<ChannelList>();
+    snapshot->collect(snapshot->root, splitTopic(topic.str()), 0, *result);
+
+    // 未驻留的主题（来自对端的未知主题）多为一次性的，不占用缓存
+    if (!topic.isInterned()) return result;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.entries.size() >= kCacheEntriesPerShard) {
+        shard.entries.clear();
+    }
+    shard.entries.emplace(topic, result);
+    return result;
+}
+
+size_t TopicRouter::getRouteCount() const {
+    return load()->route_count;
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,74 @@
+#include "../include/WorkflowExecutor.h"
+#include <iostream>
+
+namespace edge_infra {
+namespace infra_controller {
+
+WorkflowExecutor::WorkflowExecutor(size_t thread_count, size_t max_queue)
+    : max_queue_(max_queue > 0 ? max_queue : 1), stopping_(false) {
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+        if (thread_count == 0) thread_count = 2;
+    }
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back(&WorkflowExecutor::workerLoop, this);
+    }
+}
+
+WorkflowExecutor::~WorkflowExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+bool WorkflowExecutor::trySubmit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || tasks_.size() >= max_queue_) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+std::shared_ptr<WorkflowExecutor> WorkflowExecutor::shared() {
+    static std::shared_ptr<WorkflowExecutor> instance = std::make_shared<WorkflowExecutor>();
+    return instance;
+}
+
+void WorkflowExecutor::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "[WorkflowExecutor] task threw: " << e.what() << std::endl;
+        } catch (...) {
+            // 非std::exception的异常同样不能让工作线程退出
+            std::cerr << "[WorkflowExecutor] task threw a non-standard exception" << std::endl;
+        }
+    }
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
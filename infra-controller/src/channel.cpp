@@ -0,0 +1,1106 @@
+#include "../include/channel.h"
+#include "pzmq.hpp"
+#include "pzmq_watcher.h"
+#include "network/EventLoop.h"
+#include "trace.h"
+#include <zmq.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace edge_infra {
+namespace infra_controller {
+
+namespace {
+
+uint64_t systemMillis() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// 跨进程传播追踪上下文的元数据键，值为W3C traceparent
+const InternedString& traceparentKey() {
+    static const InternedString key("traceparent");
+    return key;
+}
+
+std::string generateMessageId() {
+    static std::atomic<uint64_t> sequence{0};
+    return std::to_string(systemMillis()) + "-" + std::to_string(sequence.fetch_add(1));
+}
+
+// 主题按'.'分段：'*'匹配一段，'#'匹配零段或多段
+bool topicMatches(std::string_view topic, std::string_view pattern) {
+    if (pattern.empty()) {
+        return topic.empty();
+    }
+
+    const size_t pattern_dot = pattern.find('.');
+    const std::string_view segment = pattern.substr(0, pattern_dot);
+    const std::string_view pattern_rest =
+        pattern_dot == std::string_view::npos ? std::string_view() : pattern.substr(pattern_dot + 1);
+
+    if (segment == "#") {
+        if (pattern_rest.empty()) return true;
+        // '#'吞掉0..n段
+        std::string_view rest = topic;
+        while (true) {
+            if (topicMatches(rest, pattern_rest)) return true;
+            const size_t dot = rest.find('.');
+            if (dot == std::string_view::npos) return false;
+            rest = rest.substr(dot + 1);
+        }
+    }
+
+    if (topic.empty()) return false;
+    const size_t topic_dot = topic.find('.');
+    const std::string_view topic_segment = topic.substr(0, topic_dot);
+    if (segment != "*" && segment != topic_segment) return false;
+
+    if (topic_dot == std::string_view::npos) {
+        // 主题已结束，剩余模式只能是若干'#'
+        return pattern_dot == std::string_view::npos || topicMatches(std::string_view(), pattern_rest);
+    }
+    if (pattern_dot == std::string_view::npos) return false;
+    return topicMatches(topic.substr(topic_dot + 1), pattern_rest);
+}
+
+// ==================== 消息编码 ====================
+// 单条：[u8 version=1][u8 priority][u64 timestamp][str id][str sender][str receiver][str content]
+//       [u16 metadata_count]([str key][str value])*
+// 打包：[u8 version=2][u32 count]([u32 length][单条编码])*，同一帧内的消息共用topic帧
+// str为u32长度加字节，整数为主机字节序
+
+const uint8_t kWireVersion = 1;
+const uint8_t kWireBatchVersion = 2;
+
+void putBytes(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+template<typename T>
+void putInt(std::string& out, T value) {
+    putBytes(out, &value, sizeof(value));
+}
+
+void putString(std::string& out, std::string_view str) {
+    putInt<uint32_t>(out, static_cast<uint32_t>(str.size()));
+    putBytes(out, str.data(), str.size());
+}
+
+class WireReader {
+public:
+    WireReader(const char* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    template<typename T>
+    bool readInt(T& value) {
+        if (size_ - pos_ < sizeof(T)) return false;
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string_view& str) {
+        uint32_t len = 0;
+        if (!readInt(len) || size_ - pos_ < len) return false;
+        str = std::string_view(data_ + pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+    bool readString(std::string& str) {
+        std::string_view view;
+        if (!readString(view)) return false;
+        str.assign(view.data(), view.size());
+        return true;
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_;
+};
+
+size_t encodedSizeHint(const ChannelMessage& msg) {
+    return 32 + msg.id.size() + msg.sender.size() + msg.receiver.size() + msg.content.size();
+}
+
+void appendMessage(std::string& out, const ChannelMessage& msg) {
+    putInt<uint8_t>(out, kWireVersion);
+    putInt<uint8_t>(out, static_cast<uint8_t>(msg.priority));
+    putInt<uint64_t>(out, msg.timestamp);
+    putString(out, msg.id);
+    putString(out, msg.sender);
+    putString(out, msg.receiver);
+    putString(out, msg.content);
+    putInt<uint16_t>(out, static_cast<uint16_t>(msg.metadata.size()));
+    for (const auto& entry : msg.metadata) {
+        putString(out, entry.first.str());
+        putString(out, entry.second);
+    }
+}
+
+std::string encodeMessage(const ChannelMessage& msg) {
+    std::string out;
+    out.reserve(encodedSizeHint(msg));
+    appendMessage(out, msg);
+    return out;
+}
+
+std::string encodeBatch(const ChannelMessage* messages, size_t count) {
+    size_t hint = 8;
+    for (size_t i = 0; i < count; ++i) {
+        hint += 4 + encodedSizeHint(messages[i]);
+    }
+    std::string out;
+    out.reserve(hint);
+    putInt<uint8_t>(out, kWireBatchVersion);
+    putInt<uint32_t>(out, static_cast<uint32_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        // 先占位长度，编码完再回填
+        const size_t length_pos = out.size();
+        putInt<uint32_t>(out, 0);
+        appendMessage(out, messages[i]);
+        const uint32_t length = static_cast<uint32_t>(out.size() - length_pos - sizeof(uint32_t));
+        std::memcpy(&out[length_pos], &length, sizeof(length));
+    }
+    return out;
+}
+
+bool decodeMessage(const char* data, size_t size, ChannelMessage& msg) {
+    WireReader reader(data, size);
+    uint8_t version = 0;
+    uint8_t priority = 0;
+    uint16_t metadata_count = 0;
+    if (!reader.readInt(version) || version != kWireVersion) return false;
+    if (!reader.readInt(priority) || priority > static_cast<uint8_t>(MessagePriority::CRITICAL)) return false;
+    if (!reader.readInt(msg.timestamp)) return false;
+    if (!reader.readString(msg.id) || !reader.readString(msg.sender) ||
+        !reader.readString(msg.receiver) || !reader.readString(msg.content)) {
+        return false;
+    }
+    if (!reader.readInt(metadata_count)) return false;
+
+    msg.priority = static_cast<MessagePriority>(priority);
+    msg.metadata.clear();
+    for (uint16_t i = 0; i < metadata_count; ++i) {
+        std::string_view key;
+        std::string value;
+        if (!reader.readString(key) || !reader.readString(value)) return false;
+        // 接收到的键只查找不驻留，未知键使用独立副本
+        msg.metadata.set(InternedString::lookupOrCopy(key), std::move(value));
+    }
+    return true;
+}
+
+// 解码一个消息帧（单条或打包）追加到out，任何一条损坏时整帧丢弃
+bool decodeFrame(const char* data, size_t size, const InternedString& topic, std::vector<ChannelMessage>& out) {
+    if (size == 0) return false;
+    const size_t original = out.size();
+    if (static_cast<uint8_t>(data[0]) == kWireVersion) {
+        out.emplace_back();
+        out.back().topic = topic;
+        if (!decodeMessage(data, size, out.back())) {
+            out.resize(original);
+            return false;
+        }
+        return true;
+    }
+
+    WireReader reader(data, size);
+    uint8_t version = 0;
+    uint32_t count = 0;
+    if (!reader.readInt(version) || version != kWireBatchVersion || !reader.readInt(count)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string_view encoded;
+        out.emplace_back();
+        out.back().topic = topic;
+        if (!reader.readString(encoded) || !decodeMessage(encoded.data(), encoded.size(), out.back())) {
+            out.resize(original);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ==================== ChannelMessage ====================
+
+ChannelMessage::ChannelMessage()
+    : id(generateMessageId()), priority(MessagePriority::NORMAL), timestamp(systemMillis()) {
+}
+
+ChannelMessage::ChannelMessage(std::string content, MessagePriority prio)
+    : id(generateMessageId()), content(std::move(content)), priority(prio), timestamp(systemMillis()) {
+}
+
+void ChannelMessage::setMetadata(const InternedString& key, std::string value) {
+    metadata.set(key, std::move(value));
+}
+
+const std::string& ChannelMessage::getMetadata(std::string_view key) const {
+    static const std::string kEmpty;
+    auto it = metadata.find(key);
+    return it != metadata.end() ? it->second : kEmpty;
+}
+
+bool ChannelMessage::hasMetadata(std::string_view key) const {
+    return metadata.find(key) != metadata.end();
+}
+
+std::string ChannelMessage::toString() const {
+    std::ostringstream oss;
+    oss << "ChannelMessage{id=" << id << ", sender=" << sender << ", receiver=" << receiver
+        << ", topic=" << topic << ", priority=" << messagePriorityToString(priority)
+        << ", timestamp=" << timestamp << ", size=" << content.size();
+    for (const auto& entry : metadata) {
+        oss << ", " << entry.first << "=" << entry.second;
+    }
+    oss << "}";
+    return oss.str();
+}
+
+// ==================== 过滤器 ====================
+
+TopicFilter::TopicFilter(const std::string& pattern) : topic_pattern_(pattern) {
+}
+
+bool TopicFilter::shouldProcess(const ChannelMessage& msg) const {
+    return matchPattern(msg.topic, topic_pattern_);
+}
+
+std::string TopicFilter::getFilterName() const {
+    return "TopicFilter(" + topic_pattern_ + ")";
+}
+
+bool TopicFilter::matchPattern(const std::string& topic, const std::string& pattern) const {
+    return topicMatches(topic, pattern);
+}
+
+SenderFilter::SenderFilter(const std::string& sender) : sender_id_(sender) {
+}
+
+bool SenderFilter::shouldProcess(const ChannelMessage& msg) const {
+    return msg.sender == sender_id_;
+}
+
+std::string SenderFilter::getFilterName() const {
+    return "SenderFilter(" + sender_id_ + ")";
+}
+
+// ==================== Channel ====================
+
+Channel::Channel(const std::string& name, ChannelType type)
+    : name_(name),
+      type_(type),
+      active_(false),
+      receive_batch_bytes_(0) {
+    metrics::MetricsRegistry& registry = metrics::MetricsRegistry::instance();
+    const std::string labels = metrics::label("channel", name_);
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_channel_messages_sent_total", "Messages sent on the channel", metrics::MetricType::kCounter,
+        labels, [this] { return static_cast<double>(messages_sent_.value()); }));
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_channel_messages_received_total", "Messages received on the channel", metrics::MetricType::kCounter,
+        labels, [this] { return static_cast<double>(messages_received_.value()); }));
+    metric_handles_.push_back(registry.registerCallback(
+        "edge_channel_errors_total", "Channel errors", metrics::MetricType::kCounter,
+        labels, [this] { return static_cast<double>(errors_count_.value()); }));
+}
+
+Channel::~Channel() {
+    for (uint64_t handle : metric_handles_) {
+        metrics::MetricsRegistry::instance().unregisterCallback(handle);
+    }
+}
+
+size_t Channel::sendBatch(const ChannelMessage* messages, size_t count) {
+    size_t sent = 0;
+    while (sent < count && send(messages[sent])) {
+        ++sent;
+    }
+    return sent;
+}
+
+void Channel::setBatchHandler(BatchHandler handler, const BatchPolicy& policy) {
+    batch_handler_ = std::move(handler);
+    batch_policy_ = policy;
+    if (batch_policy_.max_messages == 0) {
+        batch_policy_.max_messages = 1;
+    }
+    receive_batch_.reserve(batch_policy_.max_messages);
+}
+
+void Channel::addFilter(std::shared_ptr<MessageFilter> filter) {
+    if (!filter) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    filters_.push_back(std::move(filter));
+}
+
+void Channel::removeFilter(const std::string& filter_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    filters_.erase(std::remove_if(filters_.begin(), filters_.end(),
+                                  [&filter_name](const std::shared_ptr<MessageFilter>& f) {
+                                      return f->getFilterName() == filter_name;
+                                  }),
+                   filters_.end());
+}
+
+void Channel::clearFilters() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    filters_.clear();
+}
+
+bool Channel::applyFilters(const ChannelMessage& msg) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& filter : filters_) {
+        if (!filter->shouldProcess(msg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Channel::notifyMessageReceived(const ChannelMessage& msg) {
+    if (batch_handler_) {
+        notifyMessageReceived(ChannelMessage(msg));
+        return;
+    }
+    updateReceiveStats();
+    if (!applyFilters(msg)) {
+        return;
+    }
+    if (message_handler_) {
+        trace::Span span(name_, trace::TraceContext::fromTraceparent(msg.getMetadata("traceparent")),
+                         "channel.receive");
+        try {
+            message_handler_(msg);
+        } catch (const std::exception& e) {
+            notifyError(std::string("message handler threw: ") + e.what());
+        }
+    }
+}
+
+void Channel::notifyMessageReceived(ChannelMessage&& msg) {
+    if (!batch_handler_) {
+        notifyMessageReceived(static_cast<const ChannelMessage&>(msg));
+        return;
+    }
+    updateReceiveStats();
+    if (!applyFilters(msg)) {
+        return;
+    }
+    if (receive_batch_.empty()) {
+        receive_batch_started_ = std::chrono::steady_clock::now();
+    }
+    receive_batch_bytes_ += msg.content.size();
+    receive_batch_.push_back(std::move(msg));
+    if (receive_batch_.size() >= batch_policy_.max_messages || receive_batch_bytes_ >= batch_policy_.max_bytes) {
+        flushReceivedBatch(true);
+    }
+}
+
+void Channel::flushReceivedBatch(bool force) {
+    if (receive_batch_.empty()) return;
+    if (!force && std::chrono::steady_clock::now() - receive_batch_started_ <
+                      std::chrono::milliseconds(batch_policy_.max_delay_ms)) {
+        return;
+    }
+    try {
+        batch_handler_(receive_batch_);
+    } catch (const std::exception& e) {
+        notifyError(std::string("batch handler threw: ") + e.what());
+    }
+    // clear()保留容量，下一批不再分配
+    receive_batch_.clear();
+    receive_batch_bytes_ = 0;
+}
+
+long Channel::receiveBatchWaitMs(long max_wait_ms) const {
+    if (receive_batch_.empty()) return max_wait_ms;
+    const auto deadline = receive_batch_started_ + std::chrono::milliseconds(batch_policy_.max_delay_ms);
+    const long remaining = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count());
+    return std::max(0L, std::min(max_wait_ms, remaining));
+}
+
+void Channel::notifyError(const std::string& error) {
+    updateErrorStats();
+    if (error_handler_) {
+        error_handler_(error);
+    } else {
+        std::cerr << "[Channel " << name_ << "] " << error << std::endl;
+    }
+}
+
+void Channel::printStatistics() const {
+    std::cout << "=== Channel Statistics [" << name_ << "] ===" << std::endl;
+    std::cout << "Type: " << channelTypeToString(type_) << std::endl;
+    std::cout << "Active: " << (active_ ? "yes" : "no") << std::endl;
+    std::cout << "Messages Sent: " << getMessagesSent() << std::endl;
+    std::cout << "Messages Received: " << getMessagesReceived() << std::endl;
+    std::cout << "Errors: " << getErrorsCount() << std::endl;
+}
+
+std::string Channel::getStatusString() const {
+    std::ostringstream oss;
+    oss << name_ << " [" << channelTypeToString(type_) << "] " << (active_ ? "active" : "inactive")
+        << " sent=" << getMessagesSent() << " received=" << getMessagesReceived()
+        << " errors=" << getErrorsCount();
+    return oss.str();
+}
+
+// ==================== ZmqChannel ====================
+
+ZmqChannel::ZmqChannel(const std::string& name, ChannelType type, const std::string& endpoint)
+    : Channel(name, type),
+      endpoint_(endpoint),
+      zmq_socket_(nullptr),
+      socket_type_(ZMQ_PAIR),
+      stop_requested_(false),
+      pending_senders_(0),
+      loop_(nullptr) {
+}
+
+ZmqChannel::~ZmqChannel() {
+    stop();
+}
+
+bool ZmqChannel::start() {
+    if (active_) return true;
+    if (!initializeSocket()) {
+        return false;
+    }
+
+    stop_requested_.store(false);
+    active_ = true;
+    if (canReceive() && loop_ != nullptr) {
+        auto watcher = std::make_shared<hybrid_comm::ZmqWatcher>(loop_, zmq_socket_, &mutex_, name_);
+        watcher->setReadableCallback([this]() { handleReadable(); });
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            watcher_ = watcher;
+        }
+        watcher->start();
+        if (batch_handler_) {
+            // 没有新消息时也要按时投递攒下的批次
+            const double interval = std::max<uint32_t>(batch_policy_.max_delay_ms, 1) / 1000.0;
+            batch_timer_ = loop_->runEvery(interval, [this]() { flushReceivedBatch(false); });
+        }
+    } else if (canReceive()) {
+        receive_thread_ = std::thread(&ZmqChannel::receiveLoop, this);
+    }
+    return true;
+}
+
+void ZmqChannel::stop() {
+    if (!active_) return;
+
+    stop_requested_.store(true);
+    if (receive_thread_.joinable()) {
+        receive_thread_.join();
+    }
+    // 在mutex_下取走watcher_，正在发送的线程要么已用完，要么看到空指针；
+    // watcher->stop()要等loop线程，不能持锁调用
+    std::shared_ptr<hybrid_comm::ZmqWatcher> watcher;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watcher.swap(watcher_);
+    }
+    if (watcher) {
+        // cancel先于watcher注销排进loop，stop()返回后loop不会再访问本通道
+        if (batch_timer_.valid()) {
+            loop_->cancel(batch_timer_);
+            batch_timer_ = network::TimerId();
+        }
+        watcher->stop();
+        watcher.reset();
+        flushReceivedBatch(true);
+    }
+    active_ = false;
+    cleanupSocket();
+}
+
+bool ZmqChannel::canSend() const {
+    return socket_type_ != ZMQ_SUB;
+}
+
+bool ZmqChannel::canReceive() const {
+    return socket_type_ != ZMQ_PUB;
+}
+
+bool ZmqChannel::send(const ChannelMessage& msg) {
+    if (!active_ || zmq_socket_ == nullptr) {
+        notifyError("send on inactive channel");
+        return false;
+    }
+    if (!canSend()) {
+        notifyError("channel is receive-only");
+        return false;
+    }
+
+    // 处于被采样的请求中时，把子span的上下文写入元数据带给接收端
+    trace::Span span(name_, "channel.send");
+    std::string body;
+    if (span.active() && !msg.hasMetadata("traceparent")) {
+        ChannelMessage traced(msg);
+        traced.setMetadata(traceparentKey(), span.context().toTraceparent());
+        body = encodeMessage(traced);
+    } else {
+        body = encodeMessage(msg);
+    }
+    const std::string& topic = msg.topic.str();
+
+    bool ok;
+    pending_senders_.fetch_add(1);
+    {
+        // zmq套接字不是线程安全的，发送与接收线程共用mutex_
+        std::lock_guard<std::mutex> lock(mutex_);
+        ok = zmq_send(zmq_socket_, topic.data(), topic.size(), ZMQ_SNDMORE) >= 0 &&
+             zmq_send(zmq_socket_, body.data(), body.size(), 0) >= 0;
+        recheckAfterSend();
+    }
+    pending_senders_.fetch_sub(1);
+
+    if (!ok) {
+        notifyError(std::string("zmq_send failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+    updateSendStats();
+    return true;
+}
+
+bool ZmqChannel::send(const std::string& content, const std::string& topic) {
+    ChannelMessage msg(content);
+    msg.sender = name_;
+    msg.topic = InternedString::lookupOrCopy(topic);
+    return send(msg);
+}
+
+size_t ZmqChannel::sendBatch(const ChannelMessage* messages, size_t count) {
+    if (count == 0) return 0;
+    if (!active_ || zmq_socket_ == nullptr) {
+        notifyError("send on inactive channel");
+        return 0;
+    }
+    if (!canSend()) {
+        notifyError("channel is receive-only");
+        return 0;
+    }
+
+    // 在锁外完成编码：相邻同topic的消息合成一帧
+    struct Frame {
+        const std::string* topic;
+        std::string body;
+        size_t message_count;
+    };
+    std::vector<Frame> frames;
+    for (size_t begin = 0; begin < count;) {
+        size_t end = begin + 1;
+        while (end < count && messages[end].topic == messages[begin].topic) {
+            ++end;
+        }
+        const size_t run = end - begin;
+        frames.push_back(Frame{&messages[begin].topic.str(),
+                               run == 1 ? encodeMessage(messages[begin]) : encodeBatch(messages + begin, run),
+                               run});
+        begin = end;
+    }
+
+    size_t sent = 0;
+    bool ok = true;
+    pending_senders_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Frame& frame : frames) {
+            ok = zmq_send(zmq_socket_, frame.topic->data(), frame.topic->size(), ZMQ_SNDMORE) >= 0 &&
+                 zmq_send(zmq_socket_, frame.body.data(), frame.body.size(), 0) >= 0;
+            if (!ok) break;
+            sent += frame.message_count;
+        }
+        recheckAfterSend();
+    }
+    pending_senders_.fetch_sub(1);
+
+    if (!ok) {
+        notifyError(std::string("zmq_send failed: ") + zmq_strerror(zmq_errno()));
+    }
+    updateSendStats(sent);
+    return sent;
+}
+
+bool ZmqChannel::subscribe(const std::string& topic) {
+    if (zmq_socket_ == nullptr || socket_type_ != ZMQ_SUB) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return zmq_setsockopt(zmq_socket_, ZMQ_SUBSCRIBE, topic.data(), topic.size()) == 0;
+}
+
+bool ZmqChannel::unsubscribe(const std::string& topic) {
+    if (zmq_socket_ == nullptr || socket_type_ != ZMQ_SUB) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return zmq_setsockopt(zmq_socket_, ZMQ_UNSUBSCRIBE, topic.data(), topic.size()) == 0;
+}
+
+bool ZmqChannel::initializeSocket() {
+    std::string address = endpoint_;
+    bool bind = address.find('*') != std::string::npos;
+    if (!address.empty() && (address[0] == '@' || address[0] == '>')) {
+        bind = address[0] == '@';
+        address.erase(0, 1);
+    }
+
+    switch (type_) {
+        case ChannelType::POINT_TO_POINT:
+            socket_type_ = ZMQ_PAIR;
+            break;
+        case ChannelType::REQUEST_RESPONSE:
+            socket_type_ = bind ? ZMQ_REP : ZMQ_REQ;
+            break;
+        case ChannelType::PUBLISH_SUBSCRIBE:
+        case ChannelType::BROADCAST:
+        case ChannelType::MULTICAST:
+        default:
+            socket_type_ = bind ? ZMQ_PUB : ZMQ_SUB;
+            break;
+    }
+
+    // 与hybrid-comm共用上下文，inproc端点才能互通
+    void* context = hybrid_comm::ZmqContext::getInstance()->getContext();
+    zmq_socket_ = zmq_socket(context, socket_type_);
+    if (zmq_socket_ == nullptr) {
+        notifyError(std::string("zmq_socket failed: ") + zmq_strerror(zmq_errno()));
+        return false;
+    }
+
+    int linger = 0;
+    zmq_setsockopt(zmq_socket_, ZMQ_LINGER, &linger, sizeof(linger));
+
+    const int rc = bind ? zmq_bind(zmq_socket_, address.c_str()) : zmq_connect(zmq_socket_, address.c_str());
+    if (rc != 0) {
+        notifyError(std::string(bind ? "zmq_bind " : "zmq_connect ") + address + " failed: " +
+                    zmq_strerror(zmq_errno()));
+        cleanupSocket();
+        return false;
+    }
+    return true;
+}
+
+void ZmqChannel::cleanupSocket() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (zmq_socket_ != nullptr) {
+        zmq_close(zmq_socket_);
+        zmq_socket_ = nullptr;
+    }
+}
+
+void ZmqChannel::recheckAfterSend() {
+    // 调用方持有mutex_，持有快照期间stop()无法销毁watcher
+    const std::shared_ptr<hybrid_comm::ZmqWatcher> watcher = watcher_;
+    if (!watcher) return;
+    int events = 0;
+    size_t size = sizeof(events);
+    if (zmq_getsockopt(zmq_socket_, ZMQ_EVENTS, &events, &size) == 0 && (events & ZMQ_POLLIN)) {
+        watcher->recheck();
+    }
+}
+
+bool ZmqChannel::receiveFrames(bool& malformed) {
+    zmq_msg_t frames[2];
+    size_t count = 0;
+    int more = 1;
+    while (more) {
+        zmq_msg_t part;
+        zmq_msg_init(&part);
+        // 多帧消息整体到达，只有第一帧可能没有
+        if (zmq_msg_recv(&part, zmq_socket_, count == 0 ? ZMQ_DONTWAIT : 0) < 0) {
+            zmq_msg_close(&part);
+            if (count == 0 && zmq_errno() == EAGAIN) {
+                return false;
+            }
+            malformed = true;
+            break;
+        }
+        more = zmq_msg_more(&part);
+        if (count < 2) {
+            zmq_msg_init(&frames[count]);
+            zmq_msg_move(&frames[count], &part);
+        } else {
+            malformed = true;
+        }
+        zmq_msg_close(&part);
+        ++count;
+    }
+
+    if (!malformed && count == 2) {
+        const InternedString topic = InternedString::lookupOrCopy(std::string_view(
+            static_cast<const char*>(zmq_msg_data(&frames[0])), zmq_msg_size(&frames[0])));
+        malformed = !decodeFrame(static_cast<const char*>(zmq_msg_data(&frames[1])), zmq_msg_size(&frames[1]),
+                                 topic, received_);
+    } else {
+        malformed = true;
+    }
+    for (size_t i = 0; i < count && i < 2; ++i) {
+        zmq_msg_close(&frames[i]);
+    }
+    return true;
+}
+
+void ZmqChannel::deliverReceived(bool malformed) {
+    for (ChannelMessage& msg : received_) {
+        notifyMessageReceived(std::move(msg));
+    }
+    received_.clear();
+    if (malformed) {
+        notifyError("malformed message dropped");
+    }
+}
+
+void ZmqChannel::handleReadable() {
+    bool malformed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (zmq_socket_ == nullptr) return;
+        receiveFrames(malformed);
+    }
+    deliverReceived(malformed);
+    flushReceivedBatch(false);
+}
+
+void ZmqChannel::receiveLoop() {
+    static const long kPollTimeoutMs = 10;
+
+    while (!stop_requested_.load()) {
+        // 有发送线程在等锁时先让出，避免接收线程反复抢占
+        while (pending_senders_.load() > 0 && !stop_requested_.load()) {
+            std::this_thread::yield();
+        }
+
+        bool malformed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            zmq_pollitem_t item = {zmq_socket_, 0, ZMQ_POLLIN, 0};
+            // 有攒着的批次时poll不超过它的剩余等待时间
+            const bool readable = zmq_poll(&item, 1, receiveBatchWaitMs(kPollTimeoutMs)) > 0 &&
+                                  (item.revents & ZMQ_POLLIN);
+            if (readable) {
+                receiveFrames(malformed);
+            }
+        }
+
+        deliverReceived(malformed);
+        flushReceivedBatch(false);
+    }
+    flushReceivedBatch(true);
+}
+
+// ==================== MessageBatcher ====================
+
+MessageBatcher::MessageBatcher(std::shared_ptr<Channel> channel, const BatchPolicy& policy)
+    : channel_(std::move(channel)), policy_(policy), pending_bytes_(0) {
+    if (policy_.max_messages == 0) {
+        policy_.max_messages = 1;
+    }
+    pending_.reserve(policy_.max_messages);
+}
+
+MessageBatcher::~MessageBatcher() {
+    flush();
+}
+
+bool MessageBatcher::add(ChannelMessage msg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty()) {
+        first_added_ = std::chrono::steady_clock::now();
+    }
+    pending_bytes_ += msg.content.size();
+    pending_.push_back(std::move(msg));
+    if (pending_.size() < policy_.max_messages && pending_bytes_ < policy_.max_bytes) {
+        return true;
+    }
+    const size_t count = pending_.size();
+    return flushLocked() == count;
+}
+
+size_t MessageBatcher::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flushLocked();
+}
+
+size_t MessageBatcher::flushIfDue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty() || std::chrono::steady_clock::now() - first_added_ <
+                                std::chrono::milliseconds(policy_.max_delay_ms)) {
+        return 0;
+    }
+    return flushLocked();
+}
+
+size_t MessageBatcher::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+size_t MessageBatcher::flushLocked() {
+    if (pending_.empty() || !channel_) return 0;
+    const size_t sent = channel_->sendBatch(pending_);
+    pending_.clear();
+    pending_bytes_ = 0;
+    return sent;
+}
+
+// ==================== ChannelManager ====================
+
+ChannelManager::ChannelManager() : paused_count_(0), throttled_messages_(0) {
+}
+
+ChannelManager::~ChannelManager() {
+    stopAllChannels();
+}
+
+bool ChannelManager::registerChannel(std::shared_ptr<Channel> channel) {
+    if (!channel) return false;
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    if (!channels_.emplace(channel->getName(), channel).second) {
+        return false;
+    }
+    // 先配置路由、后注册通道的情况
+    std::lock_guard<std::mutex> routing_lock(routing_mutex_);
+    rebuildRouter();
+    return true;
+}
+
+bool ChannelManager::unregisterChannel(const std::string& name) {
+    std::shared_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        auto it = channels_.find(name);
+        if (it == channels_.end()) return false;
+        channel = it->second;
+        channels_.erase(it);
+
+        std::lock_guard<std::mutex> routing_lock(routing_mutex_);
+        for (auto route = routing_table_.begin(); route != routing_table_.end();) {
+            auto& names = route->second;
+            names.erase(std::remove(names.begin(), names.end(), name), names.end());
+            route = names.empty() ? routing_table_.erase(route) : std::next(route);
+        }
+        rebuildRouter();
+    }
+    channel->stop();
+    return true;
+}
+
+std::shared_ptr<Channel> ChannelManager::getChannel(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    auto it = channels_.find(name);
+    return it != channels_.end() ? it->second : nullptr;
+}
+
+void ChannelManager::startAllChannels() {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    for (auto& pair : channels_) {
+        if (!pair.second->start()) {
+            std::cerr << "[ChannelManager] failed to start channel " << pair.first << std::endl;
+        }
+    }
+}
+
+void ChannelManager::stopAllChannels() {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    for (auto& pair : channels_) {
+        pair.second->stop();
+    }
+}
+
+void ChannelManager::rebuildRouter() {
+    std::vector<TopicRouter::Route> routes;
+    for (const auto& route : routing_table_) {
+        for (const auto& name : route.second) {
+            auto it = channels_.find(name);
+            if (it != channels_.end()) {
+                routes.emplace_back(route.first, it->second);
+            }
+        }
+    }
+    router_.rebuild(routes);
+}
+
+void ChannelManager::addRoute(const std::string& topic, const std::string& channel_name) {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    std::lock_guard<std::mutex> routing_lock(routing_mutex_);
+    auto& names = routing_table_[topic];
+    if (std::find(names.begin(), names.end(), channel_name) != names.end()) {
+        return;
+    }
+    names.push_back(channel_name);
+    rebuildRouter();
+}
+
+void ChannelManager::removeRoute(const std::string& topic, const std::string& channel_name) {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    std::lock_guard<std::mutex> routing_lock(routing_mutex_);
+    auto it = routing_table_.find(topic);
+    if (it == routing_table_.end()) return;
+    auto& names = it->second;
+    names.erase(std::remove(names.begin(), names.end(), channel_name), names.end());
+    if (names.empty()) {
+        routing_table_.erase(it);
+    }
+    rebuildRouter();
+}
+
+void ChannelManager::clearRoutes(const std::string& topic) {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    std::lock_guard<std::mutex> routing_lock(routing_mutex_);
+    if (routing_table_.erase(topic) > 0) {
+        rebuildRouter();
+    }
+}
+
+bool ChannelManager::routeMessage(const ChannelMessage& msg) {
+    if (paused_count_.load(std::memory_order_acquire) != 0 && isTopicPaused(msg.topic)) {
+        throttled_messages_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const auto targets = router_.match(msg.topic);
+    bool delivered = false;
+    for (const auto& channel : *targets) {
+        if (channel->isActive()) {
+            delivered = channel->send(msg) || delivered;
+        }
+    }
+    return delivered;
+}
+
+bool ChannelManager::routeMessage(const std::string& topic, const std::string& content) {
+    ChannelMessage msg(content);
+    msg.topic = InternedString::lookupOrCopy(topic);
+    return routeMessage(msg);
+}
+
+bool ChannelManager::pauseTopic(const InternedString& topic) {
+    {
+        std::lock_guard<std::mutex> lock(paused_mutex_);
+        if (!paused_topics_.insert(topic).second) return false;
+        paused_count_.store(paused_topics_.size(), std::memory_order_release);
+    }
+    if (flow_control_callback_) {
+        flow_control_callback_(topic, true);
+    }
+    return true;
+}
+
+bool ChannelManager::resumeTopic(const InternedString& topic) {
+    {
+        std::lock_guard<std::mutex> lock(paused_mutex_);
+        if (paused_topics_.erase(topic) == 0) return false;
+        paused_count_.store(paused_topics_.size(), std::memory_order_release);
+    }
+    if (flow_control_callback_) {
+        flow_control_callback_(topic, false);
+    }
+    return true;
+}
+
+bool ChannelManager::isTopicPaused(const InternedString& topic) const {
+    std::lock_guard<std::mutex> lock(paused_mutex_);
+    return paused_topics_.count(topic) != 0;
+}
+
+void ChannelManager::broadcast(const ChannelMessage& msg) {
+    std::vector<std::shared_ptr<Channel>> channels;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        channels.reserve(channels_.size());
+        for (const auto& pair : channels_) {
+            channels.push_back(pair.second);
+        }
+    }
+    for (auto& channel : channels) {
+        if (channel->isActive()) {
+            channel->send(msg);
+        }
+    }
+}
+
+void ChannelManager::broadcast(const std::string& content) {
+    broadcast(ChannelMessage(content));
+}
+
+std::vector<std::string> ChannelManager::getChannelNames() const {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    std::vector<std::string> names;
+    names.reserve(channels_.size());
+    for (const auto& pair : channels_) {
+        names.push_back(pair.first);
+    }
+    return names;
+}
+
+std::vector<std::string> ChannelManager::getChannelsForTopic(const std::string& topic) const {
+    const auto targets = router_.match(InternedString::lookupOrCopy(topic));
+    std::vector<std::string> names;
+    names.reserve(targets->size());
+    for (const auto& channel : *targets) {
+        names.push_back(channel->getName());
+    }
+    return names;
+}
+
+size_t ChannelManager::getChannelCount() const {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    return channels_.size();
+}
+
+void ChannelManager::printAllStatistics() const {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    std::cout << "=== ChannelManager: " << channels_.size() << " channels ===" << std::endl;
+    for (const auto& pair : channels_) {
+        pair.second->printStatistics();
+    }
+}
+
+void ChannelManager::printRoutingTable() const {
+    std::lock_guard<std::mutex> lock(routing_mutex_);
+    std::cout << "=== Routing Table ===" << std::endl;
+    for (const auto& route : routing_table_) {
+        std::cout << route.first << " ->";
+        for (const auto& name : route.second) {
+            std::cout << " " << name;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Compiled routes: " << router_.getRouteCount() << ", cache hits: " << router_.getCacheHits()
+              << ", misses: " << router_.getCacheMisses() << std::endl;
+    std::cout << "Paused topics: " << getPausedTopicCount() << ", throttled messages: " << getThrottledMessages()
+              << std::endl;
+}
+
+// ==================== 工具函数 ====================
+
+std::string channelTypeToString(ChannelType type) {
+    switch (type) {
+        case ChannelType::POINT_TO_POINT: return "POINT_TO_POINT";
+        case ChannelType::PUBLISH_SUBSCRIBE: return "PUBLISH_SUBSCRIBE";
+        case ChannelType::REQUEST_RESPONSE: return "REQUEST_RESPONSE";
+        case ChannelType::BROADCAST: return "BROADCAST";
+        case ChannelType::MULTICAST: return "MULTICAST";
+        default: return "UNKNOWN";
+    }
+}
+
+std::string messagePriorityToString(MessagePriority priority) {
+    switch (priority) {
+        case MessagePriority::LOW: return "LOW";
+        case MessagePriority::NORMAL: return "NORMAL";
+        case MessagePriority::HIGH: return "HIGH";
+        case MessagePriority::CRITICAL: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace infra_controller
+} // namespace edge_infra
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "InetAddress.h"
+#include "Socket.h"
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+namespace edge_infra {
+namespace network {
+
+class EventLoop;
+class Channel;
+
+// 监听socket封装，默认运行在TcpServer的base loop中；
+// reuse_port模式下每个IO loop各有一个，由内核分摊新连接。
+// 每次可读事件循环accept4直到EAGAIN（最多kMaxAcceptsPerWakeup个），应对重连风暴；
+// fd耗尽（EMFILE/ENFILE）时借用预留的idle fd接受并立即关闭连接，避免backlog堆积导致空转
+class Acceptor {
+public:
+    using NewConnectionCallback = std::function<void(int sockfd, const InetAddress& peer_addr)>;
+
+    static const int kMaxAcceptsPerWakeup = 256;
+
+private:
+    EventLoop* loop_;
+    Socket accept_socket_;
+    std::unique_ptr<Channel> accept_channel_;
+    NewConnectionCallback new_connection_callback_;
+    bool listening_;
+    int idle_fd_;
+
+    // 统计（仅在所属loop线程更新）
+    uint64_t accepted_count_;
+    uint64_t dropped_count_;
+
+public:
+    Acceptor(EventLoop* loop, const InetAddress& listen_addr, bool reuse_port = false);
+    ~Acceptor();
+
+    // 禁用拷贝
+    Acceptor(const Acceptor&) = delete;
+    Acceptor& operator=(const Acceptor&) = delete;
+
+    void setNewConnectionCallback(const NewConnectionCallback& cb) { new_connection_callback_ = cb; }
+
+    void listen();
+    bool listening() const { return listening_; }
+    EventLoop* getLoop() const { return loop_; }
+
+    uint64_t getAcceptedCount() const { return accepted_count_; }
+    uint64_t getDroppedCount() const { return dropped_count_; }
+
+private:
+    void handleRead();
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <sys/types.h>
+#include <endian.h>
+
+namespace edge_infra {
+namespace network {
+
+// 网络缓冲区
+//
+// +-------------------+------------------+------------------+
+// | prependable bytes |  readable bytes  |  writable bytes  |
+// |                   |     (CONTENT)    |                  |
+// +-------------------+------------------+------------------+
+// |                   |                  |                  |
+// 0      <=      reader_index   <=   writer_index    <=   size
+//
+// 头部预留kCheapPrepend字节，便于在消息前追加长度等头部而无需移动数据
+class Buffer {
+public:
+    static const size_t kCheapPrepend = 8;
+    static const size_t kInitialSize = 1024;
+
+private:
+    std::vector<char> buffer_;
+    size_t reader_index_;
+    size_t writer_index_;
+
+    static const char kCRLF[];
+
+public:
+    explicit Buffer(size_t initial_size = kInitialSize)
+        : buffer_(kCheapPrepend + initial_size),
+          reader_index_(kCheapPrepend),
+          writer_index_(kCheapPrepend) {}
+
+    void swap(Buffer& rhs) {
+        buffer_.swap(rhs.buffer_);
+        std::swap(reader_index_, rhs.reader_index_);
+        std::swap(writer_index_, rhs.writer_index_);
+    }
+
+    // 容量查询
+    size_t readableBytes() const { return writer_index_ - reader_index_; }
+    size_t writableBytes() const { return buffer_.size() - writer_index_; }
+    size_t prependableBytes() const { return reader_index_; }
+    size_t internalCapacity() const { return buffer_.capacity(); }
+
+    // 可读数据访问
+    const char* peek() const { return begin() + reader_index_; }
+    std::string_view toStringView() const { return std::string_view(peek(), readableBytes()); }
+
+    const char* findCRLF() const;
+    const char* findCRLF(const char* start) const;
+    const char* findEOL() const;
+    const char* findEOL(const char* start) const;
+
+    // 消费数据
+    void retrieve(size_t len) {
+        assert(len <= readableBytes());
+        if (len < readableBytes()) {
+            reader_index_ += len;
+        } else {
+            retrieveAll();
+        }
+    }
+    void retrieveUntil(const char* end) {
+        assert(peek() <= end && end <= beginWrite());
+        retrieve(end - peek());
+    }
+    void retrieveAll() {
+        reader_index_ = kCheapPrepend;
+        writer_index_ = kCheapPrepend;
+    }
+    std::string retrieveAsString(size_t len) {
+        assert(len <= readableBytes());
+        std::string result(peek(), len);
+        retrieve(len);
+        return result;
+    }
+    std::string retrieveAllAsString() { return retrieveAsString(readableBytes()); }
+
+    // 写入数据
+    void append(const char* data, size_t len) {
+        ensureWritableBytes(len);
+        std::copy(data, data + len, beginWrite());
+        hasWritten(len);
+    }
+    void append(const void* data, size_t len) { append(static_cast<const char*>(data), len); }
+    void append(std::string_view str) { append(str.data(), str.size()); }
+
+    void ensureWritableBytes(size_t len) {
+        if (writableBytes() < len) {
+            makeSpace(len);
+        }
+        assert(writableBytes() >= len);
+    }
+    char* beginWrite() { return begin() + writer_index_; }
+    const char* beginWrite() const { return begin() + writer_index_; }
+    void hasWritten(size_t len) {
+        assert(len <= writableBytes());
+        writer_index_ += len;
+    }
+    void unwrite(size_t len) {
+        assert(len <= readableBytes());
+        writer_index_ -= len;
+    }
+
+    // 整数读写（网络字节序）
+    void appendInt64(int64_t x) { uint64_t be = htobe64(static_cast<uint64_t>(x)); append(&be, sizeof(be)); }
+    void appendInt32(int32_t x) { uint32_t be = htobe32(static_cast<uint32_t>(x)); append(&be, sizeof(be)); }
+    void appendInt16(int16_t x) { uint16_t be = htobe16(static_cast<uint16_t>(x)); append(&be, sizeof(be)); }
+    void appendInt8(int8_t x) { append(&x, sizeof(x)); }
+
+    int64_t peekInt64() const;
+    int32_t peekInt32() const;
+    int16_t peekInt16() const;
+    int8_t peekInt8() const;
+
+    int64_t readInt64() { int64_t x = peekInt64(); retrieve(sizeof(x)); return x; }
+    int32_t readInt32() { int32_t x = peekInt32(); retrieve(sizeof(x)); return x; }
+    int16_t readInt16() { int16_t x = peekInt16(); retrieve(sizeof(x)); return x; }
+    int8_t readInt8() { int8_t x = peekInt8(); retrieve(sizeof(x)); return x; }
+
+    // 在可读数据之前追加（如长度头）
+    void prepend(const void* data, size_t len) {
+        assert(len <= prependableBytes());
+        reader_index_ -= len;
+        const char* d = static_cast<const char*>(data);
+        std::copy(d, d + len, begin() + reader_index_);
+    }
+    void prependInt64(int64_t x) { uint64_t be = htobe64(static_cast<uint64_t>(x)); prepend(&be, sizeof(be)); }
+    void prependInt32(int32_t x) { uint32_t be = htobe32(static_cast<uint32_t>(x)); prepend(&be, sizeof(be)); }
+    void prependInt16(int16_t x) { uint16_t be = htobe16(static_cast<uint16_t>(x)); prepend(&be, sizeof(be)); }
+    void prependInt8(int8_t x) { prepend(&x, sizeof(x)); }
+
+    // 释放多余内存，保留reserve字节可写空间
+    void shrink(size_t reserve);
+
+    // 从fd读取数据，使用readv配合栈上缓冲区一次系统调用尽量读完
+    ssize_t readFd(int fd, int* saved_errno);
+
+private:
+    char* begin() { return buffer_.data(); }
+    const char* begin() const { return buffer_.data(); }
+
+    void makeSpace(size_t len);
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <sys/epoll.h>
 
 namespace edge_infra {
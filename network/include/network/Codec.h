@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Buffer.h"
+#include "OutputQueue.h"
+#include "TcpConnection.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace edge_infra {
+namespace network {
+
+// 帧编解码器：直接在连接的输入缓冲区上切分帧，一次读事件中解出的所有帧合并成一批回调，
+// 回调返回后才统一retrieve，因此帧可以是指向输入缓冲区的视图（零拷贝）。
+// 派生类实现decodeFrame/encodeFrame；同一个codec可被多个IO线程的连接共享，派生类不应保存per-connection状态
+template <typename Frame>
+class Codec : public std::enable_shared_from_this<Codec<Frame>> {
+public:
+    // frames只在回调期间有效，需要保留时自行拷贝/移走
+    using FrameCallback = std::function<void(const TcpConnectionPtr&, std::vector<Frame>&)>;
+    using ErrorCallback = std::function<void(const TcpConnectionPtr&, const std::string&)>;
+
+    enum DecodeResult {
+        kFrame,      // 解出一帧，consumed为该帧占用的字节数
+        kNeedMore,   // 数据不足一帧；consumed为其前可以丢弃的字节数（如已跳过的空行），通常为0
+        kError       // 格式错误，连接将被关闭
+    };
+
+    static const size_t kDefaultMaxFrameSize = 64 * 1024 * 1024;
+
+protected:
+    FrameCallback frame_callback_;
+    ErrorCallback error_callback_;
+    size_t max_frame_size_;
+
+public:
+    explicit Codec(const FrameCallback& cb = FrameCallback())
+        : frame_callback_(cb), max_frame_size_(kDefaultMaxFrameSize) {}
+    virtual ~Codec() = default;
+
+    Codec(const Codec&) = delete;
+    Codec& operator=(const Codec&) = delete;
+
+    void setFrameCallback(const FrameCallback& cb) { frame_callback_ = cb; }
+    // 默认只打印错误并关闭连接
+    void setErrorCallback(const ErrorCallback& cb) { error_callback_ = cb; }
+    void setMaxFrameSize(size_t size) { max_frame_size_ = size; }
+    size_t getMaxFrameSize() const { return max_frame_size_; }
+
+    // 作为TcpConnection/TcpServer的BufferMessageCallback
+    BufferMessageCallback messageCallback() {
+        std::shared_ptr<Codec> self = this->shared_from_this();
+        return [self](const TcpConnectionPtr& conn, Buffer* buf) { self->onMessage(conn, buf); };
+    }
+
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf) {
+        std::vector<Frame> frames;
+        const char* data = buf->peek();
+        const size_t readable = buf->readableBytes();
+        size_t offset = 0;
+        std::string error;
+        bool failed = false;
+
+        while (offset < readable) {
+            Frame frame;
+            size_t consumed = 0;
+            DecodeResult result = decodeFrame(data + offset, readable - offset, &frame, &consumed, &error);
+            if (result == kNeedMore) {
+                // 丢弃可跳过的字节，否则只发空行的对端会让输入缓冲区无限增长、每次读事件重复扫描
+                offset += consumed;
+                break;
+            }
+            if (result == kError) {
+                failed = true;
+                break;
+            }
+            offset += consumed;
+            frames.push_back(std::move(frame));
+        }
+
+        // 出错前已完整解出的帧照常交付
+        if (!frames.empty() && frame_callback_) {
+            frame_callback_(conn, frames);
+        }
+        frames.clear();
+        buf->retrieve(offset);
+
+        if (failed) {
+            buf->retrieveAll();
+            if (error_callback_) {
+                error_callback_(conn, error);
+            }
+            conn->forceClose();
+        }
+    }
+
+    // 编码后整体交给连接的输出队列
+    void send(const TcpConnectionPtr& conn, const Frame& frame) {
+        OutputQueue out;
+        encodeFrame(frame, &out);
+        conn->send(std::move(out));
+    }
+
+    void send(const TcpConnectionPtr& conn, const std::vector<Frame>& frames) {
+        OutputQueue out;
+        for (const Frame& frame : frames) {
+            encodeFrame(frame, &out);
+        }
+        conn->send(std::move(out));
+    }
+
+    virtual DecodeResult decodeFrame(const char* data, size_t len, Frame* frame,
+                                     size_t* consumed, std::string* error) = 0;
+    virtual void encodeFrame(const Frame& frame, OutputQueue* out) = 0;
+};
+
+template <typename Frame>
+const size_t Codec<Frame>::kDefaultMaxFrameSize;
+
+// 按行分帧的JSON（NDJSON）：每行一个JSON文档，帧为指向输入缓冲区的视图（不含行尾的\r\n），跳过空行。
+// 这里只负责分帧，文档本身由调用方用json_parser解析
+class JsonLineCodec : public Codec<std::string_view> {
+public:
+    explicit JsonLineCodec(const FrameCallback& cb = FrameCallback()) : Codec<std::string_view>(cb) {}
+
+    DecodeResult decodeFrame(const char* data, size_t len, std::string_view* frame,
+                             size_t* consumed, std::string* error) override;
+    // 调用方保证文档本身不含换行
+    void encodeFrame(const std::string_view& frame, OutputQueue* out) override;
+};
+
+} // namespace network
+} // namespace edge_infra
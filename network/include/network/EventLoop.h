@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Timer.h"
 #include <vector>
 #include <memory>
 #include <functional>
@@ -13,11 +14,20 @@ namespace network {
 
 class Channel;
 class Poller;
+class TimerQueue;
 
 using EventCallback = std::function<void()>;
-using TimerCallback = std::function<void()>;
 
 class EventLoop {
+public:
+    // Poller后端。kDefaultPoller由环境变量EDGE_NETWORK_POLLER决定（epoll/io_uring），未设置时为epoll；
+    // io_uring不可用时回退到epoll
+    enum PollerType {
+        kDefaultPoller,
+        kEpollPoller,
+        kIoUringPoller
+    };
+
 private:
     std::atomic<bool> running_;
     std::atomic<bool> quit_;
@@ -26,16 +36,20 @@ private:
     std::unique_ptr<Poller> poller_;
     std::vector<std::function<void()>> pending_functors_;
     std::mutex functors_mutex_;
+    bool calling_pending_functors_;
     
     int wakeup_fd_;
     std::unique_ptr<Channel> wakeup_channel_;
+    std::unique_ptr<TimerQueue> timer_queue_;
+    
+    std::vector<Channel*> active_channels_;
     
     // 调试和统计信息
     std::atomic<uint64_t> loop_count_;
     std::atomic<uint64_t> event_count_;
     
 public:
-    EventLoop();
+    explicit EventLoop(PollerType poller_type = kDefaultPoller);
     ~EventLoop();
     
     // 禁用拷贝
@@ -55,9 +69,10 @@ public:
     void removeChannel(Channel* channel);
     bool hasChannel(Channel* channel);
     
-    // 定时器支持
-    void runAfter(double delay, TimerCallback cb);
-    void runEvery(double interval, TimerCallback cb);
+    // 定时器支持（线程安全，时间单位为秒，精度1ms）
+    TimerId runAfter(double delay, TimerCallback cb);
+    TimerId runEvery(double interval, TimerCallback cb);
+    void cancel(TimerId timer_id);
     
     // 线程安全检查
     bool isInLoopThread() const;
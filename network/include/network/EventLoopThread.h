@@ -0,0 +1,51 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace edge_infra {
+namespace network {
+
+class EventLoop;
+
+// 在独立线程中运行一个EventLoop (one loop per thread)
+class EventLoopThread {
+public:
+    using ThreadInitCallback = std::function<void(EventLoop*)>;
+
+private:
+    EventLoop* loop_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    ThreadInitCallback callback_;
+
+    std::string name_;
+    int cpu_id_; // 绑定的CPU核心，-1表示不绑定
+
+public:
+    explicit EventLoopThread(const ThreadInitCallback& cb = ThreadInitCallback(),
+                             const std::string& name = "", int cpu_id = -1);
+    ~EventLoopThread();
+
+    // 禁用拷贝
+    EventLoopThread(const EventLoopThread&) = delete;
+    EventLoopThread& operator=(const EventLoopThread&) = delete;
+
+    // 启动线程并等待其中的EventLoop创建完成
+    EventLoop* startLoop();
+
+    EventLoop* getLoop() const { return loop_; }
+    const std::string& name() const { return name_; }
+    int cpuId() const { return cpu_id_; }
+
+private:
+    void threadFunc();
+    bool bindToCpu(int cpu_id);
+};
+
+} // namespace network
+} // namespace edge_infra
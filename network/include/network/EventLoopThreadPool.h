@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <string>
+#include <atomic>
+
+namespace edge_infra {
+namespace network {
+
+class EventLoop;
+class EventLoopThread;
+
+// IO线程池：base loop负责accept，sub loop负责连接读写
+class EventLoopThreadPool {
+public:
+    using ThreadInitCallback = std::function<void(EventLoop*)>;
+
+    // 连接分配策略
+    enum LoadBalanceStrategy {
+        kRoundRobin,      // 轮询
+        kLeastConnections // 选择当前连接数最少的loop
+    };
+
+private:
+    EventLoop* base_loop_;
+    std::string name_;
+    bool started_;
+    int num_threads_;
+    size_t next_;
+    LoadBalanceStrategy strategy_;
+
+    // CPU绑定
+    bool cpu_affinity_;
+    std::vector<int> cpu_list_;
+
+    std::vector<std::unique_ptr<EventLoopThread>> threads_;
+    std::vector<EventLoop*> loops_;
+    std::unique_ptr<std::atomic<int>[]> loads_; // 与loops_一一对应
+
+public:
+    EventLoopThreadPool(EventLoop* base_loop, const std::string& name);
+    ~EventLoopThreadPool();
+
+    // 禁用拷贝
+    EventLoopThreadPool(const EventLoopThreadPool&) = delete;
+    EventLoopThreadPool& operator=(const EventLoopThreadPool&) = delete;
+
+    // 配置（需在start之前调用）
+    void setThreadNum(int num_threads) { num_threads_ = num_threads; }
+    void setLoadBalanceStrategy(LoadBalanceStrategy strategy) { strategy_ = strategy; }
+    // cpus为空时按loop序号依次绑定到 0..hardware_concurrency-1
+    void setCpuAffinity(bool enable, const std::vector<int>& cpus = std::vector<int>());
+
+    void start(const ThreadInitCallback& cb = ThreadInitCallback());
+
+    // 以下接口需在base loop线程调用；未启用线程池时返回base loop
+    EventLoop* getNextLoop();
+    EventLoop* getLoopForHash(size_t hash_code);
+    std::vector<EventLoop*> getAllLoops();
+
+    // 负载统计（连接数），用于kLeastConnections策略
+    void addLoad(EventLoop* loop, int delta);
+    int getLoad(EventLoop* loop) const;
+
+    bool started() const { return started_; }
+    int threadNum() const { return num_threads_; }
+    LoadBalanceStrategy strategy() const { return strategy_; }
+    const std::string& name() const { return name_; }
+
+    // 调试功能
+    void printStatistics() const;
+
+private:
+    int indexOf(EventLoop* loop) const;
+    EventLoop* getLeastLoadedLoop();
+};
+
+} // namespace network
+} // namespace edge_infra
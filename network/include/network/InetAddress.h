@@ -2,6 +2,7 @@
 
 #include <netinet/in.h>
 #include <string>
+#include <vector>
 
 namespace edge_infra {
 namespace network {
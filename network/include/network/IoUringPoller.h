@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Poller.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace edge_infra {
+namespace network {
+
+// 基于io_uring的Poller（直接使用系统调用，不依赖liburing）。
+// 保持与EPollPoller相同的就绪通知语义（水平触发），Channel回调无需改动：
+// 每个Channel对应一个oneshot IORING_OP_POLL_ADD，触发后在本轮回调处理完、下次poll()时重新挂上，
+// fd仍就绪时会立即再次完成。关注事件的增删改只写入SQ，与等待合并成一次io_uring_enter，
+// 省去epoll下每次修改一次epoll_ctl的系统调用。
+// 需要IORING_FEAT_EXT_ARG（5.11+）；不可用时valid()为false，由工厂函数回退到epoll
+class IoUringPoller : public Poller {
+private:
+    static const unsigned kQueueDepth = 1024;
+    static const uint64_t kRemoveTag = ~0ULL;   // POLL_REMOVE自身的完成事件
+
+    struct Registration {
+        uint64_t user_data;   // 当前挂载的poll：高32位为代数，低32位为fd
+        int events;           // 当前挂载的关注事件
+        bool armed;
+    };
+
+    int ring_fd_;
+
+    // 提交队列
+    void* sq_ring_;
+    size_t sq_ring_size_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned sq_local_tail_;   // 已填充但尚未发布给内核的尾指针
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+
+    // 完成队列
+    void* cq_ring_;
+    size_t cq_ring_size_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+
+    uint32_t next_generation_;
+    std::unordered_map<int, Registration> registrations_;
+    std::vector<int> rearm_fds_;   // 上一轮已触发、待重新挂载的fd
+
+public:
+    explicit IoUringPoller(EventLoop* loop);
+    ~IoUringPoller() override;
+
+    bool valid() const { return ring_fd_ >= 0; }
+
+    int poll(int timeout_ms, ChannelList* active_channels) override;
+    void updateChannel(Channel* channel) override;
+    void removeChannel(Channel* channel) override;
+    const char* name() const override { return "io_uring"; }
+
+private:
+    bool setupRings();
+    void releaseRings();
+
+    io_uring_sqe* getSqe();
+    // 发布已填充的SQE并进入内核；wait为true时至少等待一个完成事件或超时
+    int enter(bool wait, int timeout_ms);
+
+    void arm(int fd, Registration* reg, int events);
+    void disarm(Registration* reg);
+    int reapCompletions(ChannelList* active_channels);
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "TcpServer.h"
+#include <string>
+
+namespace edge_infra {
+namespace network {
+
+// 在TcpServer上提供Prometheus抓取端点：GET <path> 返回MetricsRegistry的文本导出，
+// GET <traces_path> 取走已结束的span并以Chrome trace格式返回。
+// 每个请求应答后关闭连接。只解析请求行，不支持请求体
+class MetricsServer {
+private:
+    static const size_t kMaxRequestSize = 8192;
+
+    TcpServer server_;
+    std::string path_;
+    std::string traces_path_;
+
+public:
+    MetricsServer(EventLoop* loop, const InetAddress& listen_addr, const std::string& path = "/metrics",
+                  const std::string& traces_path = "/traces");
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    void start() { server_.start(); }
+    void stop() { server_.stop(); }
+    // 需要时可在start之前配置IO线程等
+    TcpServer& server() { return server_; }
+
+private:
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf);
+    static void sendResponse(const TcpConnectionPtr& conn, const char* status,
+                             const char* content_type, const std::string& body);
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -6,8 +6,14 @@
 #include <atomic>
 #include <mutex>
 #include <fstream>
+#include <memory>
+#include "metrics.h"
+#include "trace.h"
 
 namespace edge_infra {
+
+class AsyncLogBackend;
+
 namespace network {
 
 // 网络调试和监控工具
@@ -17,24 +23,37 @@ private:
     static std::atomic<bool> performance_monitoring_;
     static std::mutex log_mutex_;
     static std::ofstream debug_log_;
+    static std::string log_file_;
+    static std::atomic<bool> async_enabled_;
+    static std::unique_ptr<AsyncLogBackend> async_backend_;
     
-    // 性能统计
+    // 性能统计：注册在全局MetricsRegistry中的分片计数器，各IO线程累加互不争用
     struct NetworkStats {
-        std::atomic<uint64_t> bytes_sent{0};
-        std::atomic<uint64_t> bytes_received{0};
-        std::atomic<uint64_t> connections_created{0};
-        std::atomic<uint64_t> connections_closed{0};
-        std::atomic<uint64_t> events_processed{0};
-        std::atomic<uint64_t> errors_count{0};
+        metrics::Counter* bytes_sent;
+        metrics::Counter* bytes_received;
+        metrics::Counter* connections_created;
+        metrics::Counter* connections_closed;
+        metrics::Counter* events_processed;
+        metrics::Counter* errors_count;
+        metrics::Histogram* loop_iteration_us;
+        
+        NetworkStats();
     };
     
-    static NetworkStats stats_;
+    static NetworkStats& stats() {
+        static NetworkStats instance;
+        return instance;
+    }
     
 public:
     // 调试控制
     static void enableDebug(bool enable = true);
     static void enablePerformanceMonitoring(bool enable = true);
     static void setLogFile(const std::string& filename);
+    // 异步模式下日志写入线程本地缓冲区，由后台线程批量输出，loop线程不再阻塞在磁盘IO上
+    static void enableAsyncLogging(bool enable = true);
+    static void flushLog();
+    static uint64_t getDroppedLogLines();
     
     // 调试日志
     static void debugLog(const std::string& component, const std::string& message);
@@ -42,20 +61,22 @@ public:
     static void performanceLog(const std::string& operation, double duration_ms);
     
     // 统计更新
-    static void recordBytesSent(size_t bytes) { stats_.bytes_sent += bytes; }
-    static void recordBytesReceived(size_t bytes) { stats_.bytes_received += bytes; }
-    static void recordConnectionCreated() { stats_.connections_created++; }
-    static void recordConnectionClosed() { stats_.connections_closed++; }
-    static void recordEventProcessed() { stats_.events_processed++; }
-    static void recordError() { stats_.errors_count++; }
+    static void recordBytesSent(size_t bytes) { stats().bytes_sent->add(bytes); }
+    static void recordBytesReceived(size_t bytes) { stats().bytes_received->add(bytes); }
+    static void recordConnectionCreated() { stats().connections_created->increment(); }
+    static void recordConnectionClosed() { stats().connections_closed->increment(); }
+    static void recordEventProcessed(size_t count = 1) { stats().events_processed->add(count); }
+    static void recordError() { stats().errors_count->increment(); }
+    // EventLoop每轮处理就绪事件和pending functor的耗时（不含等待）
+    static void recordLoopIteration(uint64_t duration_us) { stats().loop_iteration_us->record(duration_us); }
     
     // 统计查询
-    static uint64_t getBytesSent() { return stats_.bytes_sent.load(); }
-    static uint64_t getBytesReceived() { return stats_.bytes_received.load(); }
-    static uint64_t getConnectionsCreated() { return stats_.connections_created.load(); }
-    static uint64_t getConnectionsClosed() { return stats_.connections_closed.load(); }
-    static uint64_t getEventsProcessed() { return stats_.events_processed.load(); }
-    static uint64_t getErrorsCount() { return stats_.errors_count.load(); }
+    static uint64_t getBytesSent() { return stats().bytes_sent->value(); }
+    static uint64_t getBytesReceived() { return stats().bytes_received->value(); }
+    static uint64_t getConnectionsCreated() { return stats().connections_created->value(); }
+    static uint64_t getConnectionsClosed() { return stats().connections_closed->value(); }
+    static uint64_t getEventsProcessed() { return stats().events_processed->value(); }
+    static uint64_t getErrorsCount() { return stats().errors_count->value(); }
     
     // 统计报告
     static void printStatistics();
@@ -75,6 +96,7 @@ public:
     
 private:
     static std::string getCurrentTime();
+    static void writeLine(const std::string& line, bool is_error);
     static std::string formatBytes(uint64_t bytes);
 };
 
@@ -83,10 +105,12 @@ class NetworkTimer {
 private:
     std::chrono::high_resolution_clock::time_point start_time_;
     std::string operation_name_;
+    // 处于被采样的请求中时同时记录为子span，未采样时不产生开销
+    trace::Span span_;
     
 public:
     explicit NetworkTimer(const std::string& operation) 
-        : operation_name_(operation) {
+        : operation_name_(operation), span_(operation_name_, "network") {
         start_time_ = std::chrono::high_resolution_clock::now();
     }
     
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <sys/types.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace edge_infra {
+namespace network {
+
+// 连接的输出队列，由若干段组成：
+//   自有内存  - 小块写入合并进队尾的string，大块string直接移交所有权
+//   共享内存  - 引用只读块（例如多个连接共用的权重分片），不拷贝
+//   文件区间  - 用sendfile从页缓存直接发到socket，不经过用户态
+// writeTo()把连续的内存段聚合成一次writev，遇到文件段时切换为sendfile。
+// 只在所属loop线程中访问
+class OutputQueue {
+public:
+    static const size_t kCoalesceLimit = 4096;   // 小于此长度的写入合并到队尾
+    static const int kMaxIovecs = 64;
+
+private:
+    struct Segment {
+        enum Kind { MEMORY, FILE };
+
+        Kind kind;
+        std::string owned;                 // 自有内存（data指向它）
+        std::shared_ptr<const void> keeper;// 共享内存的生命周期持有者
+        const char* data;
+        size_t size;                       // 剩余未发送字节数
+        int fd;
+        off_t file_offset;                 // 下一个待发送字节的文件偏移
+        bool close_fd;
+
+        Segment();
+        ~Segment();
+        Segment(Segment&& other) noexcept;
+        Segment& operator=(Segment&&) = delete;
+        Segment(const Segment&) = delete;
+        Segment& operator=(const Segment&) = delete;
+
+        bool coalescable() const { return kind == MEMORY && !keeper && owned.size() < kCoalesceLimit; }
+    };
+
+    std::deque<Segment> segments_;
+    size_t bytes_;
+
+public:
+    OutputQueue() : bytes_(0) {}
+    ~OutputQueue() = default;
+
+    OutputQueue(OutputQueue&& other) noexcept;
+    OutputQueue& operator=(OutputQueue&& other) noexcept;
+    OutputQueue(const OutputQueue&) = delete;
+    OutputQueue& operator=(const OutputQueue&) = delete;
+
+    // 拷贝写入
+    void append(const char* data, size_t len);
+    void append(const void* data, size_t len) { append(static_cast<const char*>(data), len); }
+    void append(std::string_view str) { append(str.data(), str.size()); }
+    // 移交所有权，小块仍会合并
+    void append(std::string&& data);
+    // 引用共享只读块，keeper保证[data, data+len)在发送完成前有效
+    void append(std::shared_ptr<const void> keeper, const char* data, size_t len);
+    void append(std::shared_ptr<const std::string> block);
+    // 文件区间；close_when_done为true时队列负责在发完或丢弃后关闭fd
+    void appendFile(int fd, off_t offset, size_t len, bool close_when_done = false);
+    // 把other的全部段移到队尾
+    void append(OutputQueue&& other);
+
+    size_t readableBytes() const { return bytes_; }
+    bool empty() const { return bytes_ == 0; }
+    size_t segmentCount() const { return segments_.size(); }
+    void clear();
+
+    // 尽量多地写入fd，直到队列为空或内核缓冲区满。
+    // 返回写入的字节数；出错（EAGAIN除外）时返回-1并设置saved_errno
+    ssize_t writeTo(int fd, int* saved_errno);
+
+private:
+    void consume(size_t len);
+    Segment& pushMemory();
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "EventLoop.h"
+#include <vector>
+#include <unordered_map>
+#include <sys/epoll.h>
+
+namespace edge_infra {
+namespace network {
+
+class Channel;
+
+// IO多路复用抽象，由EventLoop持有，只在loop线程中使用
+class Poller {
+public:
+    using ChannelList = std::vector<Channel*>;
+
+protected:
+    using ChannelMap = std::unordered_map<int, Channel*>;
+    ChannelMap channels_;
+
+private:
+    EventLoop* owner_loop_;
+
+public:
+    explicit Poller(EventLoop* loop);
+    virtual ~Poller();
+
+    // 禁用拷贝
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    // 等待IO事件，将活跃的Channel填入active_channels，返回活跃数
+    virtual int poll(int timeout_ms, ChannelList* active_channels) = 0;
+
+    virtual void updateChannel(Channel* channel) = 0;
+    virtual void removeChannel(Channel* channel) = 0;
+    virtual bool hasChannel(Channel* channel) const;
+
+    virtual const char* name() const = 0;
+
+    static Poller* newDefaultPoller(EventLoop* loop);
+    static Poller* newPoller(EventLoop* loop, EventLoop::PollerType type);
+
+    void assertInLoopThread() const;
+};
+
+// 基于epoll的默认实现（水平触发）
+class EPollPoller : public Poller {
+private:
+    static const int kInitEventListSize = 16;
+
+    int epollfd_;
+    std::vector<struct epoll_event> events_;
+
+public:
+    explicit EPollPoller(EventLoop* loop);
+    ~EPollPoller() override;
+
+    int poll(int timeout_ms, ChannelList* active_channels) override;
+    void updateChannel(Channel* channel) override;
+    void removeChannel(Channel* channel) override;
+    const char* name() const override { return "epoll"; }
+
+private:
+    void fillActiveChannels(int num_events, ChannelList* active_channels) const;
+    void update(int operation, Channel* channel);
+};
+
+} // namespace network
+} // namespace edge_infra
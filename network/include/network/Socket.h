@@ -43,6 +43,8 @@ public:
     
     // Socket选项
     bool setReuseAddr(bool enable = true);
+    // 多个socket绑定同一端口，由内核在它们之间分摊新连接（需在bind之前设置）
+    bool setReusePort(bool enable = true);
     bool setNonBlocking(bool enable = true);
     bool setKeepAlive(bool enable = true);
     bool setNoDelay(bool enable = true);
@@ -2,10 +2,13 @@
 
 #include "InetAddress.h"
 #include "Socket.h"
+#include "Buffer.h"
+#include "OutputQueue.h"
 #include <memory>
 #include <functional>
 #include <string>
 #include <atomic>
+#include <chrono>
 
 namespace edge_infra {
 namespace network {
@@ -14,9 +17,19 @@ class EventLoop;
 class Channel;
 
 using TcpConnectionPtr = std::shared_ptr<class TcpConnection>;
+// 由TcpServer分配，0表示未分配
+using ConnectionId = uint64_t;
 using ConnectionCallback = std::function<void(const TcpConnectionPtr&)>;
 using MessageCallback = std::function<void(const TcpConnectionPtr&, const std::string&)>;
+// 直接交出输入缓冲区，由回调按需解析并retrieve已消费的数据，未消费部分保留到下次
+using BufferMessageCallback = std::function<void(const TcpConnectionPtr&, Buffer*)>;
 using CloseCallback = std::function<void(const TcpConnectionPtr&)>;
+// 输出缓冲区从低于高水位变为达到高水位时回调，参数为当前待发送字节数
+using HighWaterMarkCallback = std::function<void(const TcpConnectionPtr&, size_t)>;
+// 越过高水位后输出缓冲区回落到低水位以下时回调，可用于恢复上游
+using LowWaterMarkCallback = std::function<void(const TcpConnectionPtr&, size_t)>;
+// 输出缓冲区全部写入内核后回调
+using WriteCompleteCallback = std::function<void(const TcpConnectionPtr&)>;
 
 class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
 public:
@@ -30,6 +43,7 @@ public:
 private:
     EventLoop* loop_;
     const std::string name_;
+    const ConnectionId id_;
     std::atomic<State> state_;
     
     std::unique_ptr<Socket> socket_;
@@ -40,10 +54,24 @@ private:
     
     ConnectionCallback connection_callback_;
     MessageCallback message_callback_;
+    BufferMessageCallback buffer_message_callback_;
     CloseCallback close_callback_;
-    
-    std::string input_buffer_;
-    std::string output_buffer_;
+    HighWaterMarkCallback high_water_mark_callback_;
+    LowWaterMarkCallback low_water_mark_callback_;
+    WriteCompleteCallback write_complete_callback_;
+    
+    Buffer input_buffer_;
+    OutputQueue output_queue_;
+    
+    // 背压：输出缓冲区达到高水位时可自动暂停读取，回落到低水位后恢复
+    size_t high_water_mark_;
+    size_t low_water_mark_;
+    bool pause_reading_on_high_water_;
+    bool reading_wanted_;                 // 用户通过startRead/stopRead设置
+    bool reading_paused_;                 // 因背压暂停
+    std::atomic<bool> reading_;           // channel_是否关注可读事件，由loop线程更新，供其他线程查询
+    std::atomic<bool> above_high_water_;
+    std::atomic<size_t> output_bytes_;    // output_queue_的待发送字节数，供其他线程查询
     
     // 连接统计
     std::atomic<uint64_t> bytes_sent_;
@@ -52,7 +80,7 @@ private:
     
 public:
     TcpConnection(EventLoop* loop, const std::string& name, int sockfd,
-                  const InetAddress& local_addr, const InetAddress& peer_addr);
+                  const InetAddress& local_addr, const InetAddress& peer_addr, ConnectionId id = 0);
     ~TcpConnection();
     
     // 禁用拷贝
@@ -68,11 +96,41 @@ public:
     // 数据发送
     void send(const std::string& message);
     void send(const void* data, size_t len);
+    void send(Buffer* buf); // 发送并清空buf
+    // 以下重载不拷贝数据：string移交所有权，共享块只增加引用计数，
+    // OutputQueue整体并入输出队列，适合多段响应（头部+多个共享分片）
+    void send(std::string&& message);
+    void send(std::shared_ptr<const std::string> block);
+    void send(OutputQueue&& segments);
+    // 用sendfile发送文件区间[offset, offset+len)；close_when_done为true时发完或连接关闭后关闭fd
+    void sendFile(int fd, off_t offset, size_t len, bool close_when_done = false);
     
     // 回调设置
     void setConnectionCallback(const ConnectionCallback& cb) { connection_callback_ = cb; }
     void setMessageCallback(const MessageCallback& cb) { message_callback_ = cb; }
+    // 设置后优先于MessageCallback
+    void setBufferMessageCallback(const BufferMessageCallback& cb) { buffer_message_callback_ = cb; }
     void setCloseCallback(const CloseCallback& cb) { close_callback_ = cb; }
+    void setHighWaterMarkCallback(const HighWaterMarkCallback& cb) { high_water_mark_callback_ = cb; }
+    void setLowWaterMarkCallback(const LowWaterMarkCallback& cb) { low_water_mark_callback_ = cb; }
+    void setWriteCompleteCallback(const WriteCompleteCallback& cb) { write_complete_callback_ = cb; }
+    
+    // 背压配置（需在connectEstablished之前或在所属loop线程中调用）
+    // low为0时取high的一半
+    void setWriteWatermarks(size_t high, size_t low = 0);
+    // 达到高水位时暂停读取对端数据，回落到低水位后自动恢复
+    void setPauseReadingOnHighWater(bool enable) { pause_reading_on_high_water_ = enable; }
+    size_t getHighWaterMark() const { return high_water_mark_; }
+    size_t getLowWaterMark() const { return low_water_mark_; }
+    
+    // 读取控制（线程安全）；isReading返回loop线程最近一次更新的状态
+    void startRead();
+    void stopRead();
+    bool isReading() const { return reading_.load(std::memory_order_acquire); }
+    
+    // 背压状态（线程安全）
+    bool isAboveHighWaterMark() const { return above_high_water_.load(); }
+    size_t getOutputBufferedBytes() const { return output_bytes_.load(); }
     
     // 状态查询
     bool connected() const { return state_ == kConnected; }
@@ -91,8 +149,13 @@ public:
     std::chrono::steady_clock::duration getConnectDuration() const;
     
     const std::string& name() const { return name_; }
+    ConnectionId getId() const { return id_; }
     EventLoop* getLoop() const { return loop_; }
     
+    // 缓冲区访问（仅限所属loop线程）
+    Buffer* inputBuffer() { return &input_buffer_; }
+    OutputQueue* outputQueue() { return &output_queue_; }
+    
     // 调试功能
     std::string stateToString() const;
     void enableTcpNoDelay(bool on = true);
@@ -106,9 +169,16 @@ private:
     
     void sendInLoop(const std::string& message);
     void sendInLoop(const void* data, size_t len);
+    void sendInLoop(OutputQueue& segments);
+    // 把输出队列尽量写入内核，返回false表示连接已不可写
+    bool writeOutputQueue();
     void shutdownInLoop();
     void forceCloseInLoop();
     
+    // 输出缓冲区长度变化后更新水位状态和读取状态
+    void updateBackpressure();
+    void updateReading();
+    
     void setState(State s) { state_ = s; }
     
     std::string stateToString(State state) const;
@@ -2,34 +2,75 @@
 
 #include "InetAddress.h"
 #include "EventLoop.h"
+#include "EventLoopThreadPool.h"
+#include "Codec.h"
 #include <memory>
 #include <functional>
 #include <unordered_map>
+#include <vector>
+#include <string>
 #include <atomic>
+#include <mutex>
 
 namespace edge_infra {
 namespace network {
 
 class TcpConnection;
 class Acceptor;
+class Buffer;
 
 using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
+using ConnectionId = uint64_t;
 using ConnectionCallback = std::function<void(const TcpConnectionPtr&)>;
 using MessageCallback = std::function<void(const TcpConnectionPtr&, const std::string&)>;
+using BufferMessageCallback = std::function<void(const TcpConnectionPtr&, Buffer*)>;
 using CloseCallback = std::function<void(const TcpConnectionPtr&)>;
+using HighWaterMarkCallback = std::function<void(const TcpConnectionPtr&, size_t)>;
+using LowWaterMarkCallback = std::function<void(const TcpConnectionPtr&, size_t)>;
+using WriteCompleteCallback = std::function<void(const TcpConnectionPtr&)>;
 
 class TcpServer {
+public:
+    using ThreadInitCallback = std::function<void(EventLoop*)>;
+    
 private:
-    EventLoop* loop_;
+    EventLoop* loop_; // base loop，只负责accept
     const std::string name_;
+    const std::string ip_port_;
+    const InetAddress listen_addr_;
     std::unique_ptr<Acceptor> acceptor_;
+    // reuse_port模式：每个IO loop一个SO_REUSEPORT监听socket，连接直接在accept它的loop中处理
+    bool reuse_port_;
+    std::vector<std::unique_ptr<Acceptor>> loop_acceptors_;
+    std::shared_ptr<EventLoopThreadPool> thread_pool_;
     
     ConnectionCallback connection_callback_;
     MessageCallback message_callback_;
+    BufferMessageCallback buffer_message_callback_;
     CloseCallback close_callback_;
+    HighWaterMarkCallback high_water_mark_callback_;
+    LowWaterMarkCallback low_water_mark_callback_;
+    WriteCompleteCallback write_complete_callback_;
+    ThreadInitCallback thread_init_callback_;
     
-    std::unordered_map<std::string, TcpConnectionPtr> connections_;
-    std::atomic<int> next_conn_id_;
+    // 新连接的背压配置，0表示使用TcpConnection的默认值
+    size_t high_water_mark_;
+    size_t low_water_mark_;
+    bool pause_reading_on_high_water_;
+    
+    // 连接表按IO loop分片：分片只由所属loop增删（建立和关闭都在该loop完成，不再经过base loop），
+    // 锁只用于跨线程查询，几乎没有竞争。连接ID的低kShardIdBits位是分片序号
+    struct ConnectionShard {
+        EventLoop* loop;
+        mutable std::mutex mutex;
+        std::unordered_map<ConnectionId, TcpConnectionPtr> connections;
+
+        explicit ConnectionShard(EventLoop* l) : loop(l) {}
+    };
+    static const int kShardIdBits = 16;
+
+    std::vector<std::unique_ptr<ConnectionShard>> shards_;   // start()后不再变化
+    std::atomic<uint64_t> next_conn_id_;
     
     bool started_;
     
@@ -45,6 +86,18 @@ public:
     TcpServer(const TcpServer&) = delete;
     TcpServer& operator=(const TcpServer&) = delete;
     
+    // IO线程配置（需在start之前调用）
+    // 0: 所有连接都在base loop中处理（默认）
+    // n: 新连接按负载均衡策略分配到n个IO线程
+    void setThreadNum(int num_threads);
+    void setThreadInitCallback(const ThreadInitCallback& cb) { thread_init_callback_ = cb; }
+    void setLoadBalanceStrategy(EventLoopThreadPool::LoadBalanceStrategy strategy);
+    void setCpuAffinity(bool enable, const std::vector<int>& cpus = std::vector<int>());
+    // 为线程池中的每个loop各开一个SO_REUSEPORT监听socket，由内核分摊accept；
+    // 负载均衡策略不再参与分配。未启用线程池时无效
+    void setReusePort(bool enable) { reuse_port_ = enable; }
+    std::shared_ptr<EventLoopThreadPool> threadPool() const { return thread_pool_; }
+    
     // 服务器控制
     void start();
     void stop();
@@ -53,18 +106,34 @@ public:
     // 回调设置
     void setConnectionCallback(const ConnectionCallback& cb) { connection_callback_ = cb; }
     void setMessageCallback(const MessageCallback& cb) { message_callback_ = cb; }
+    void setBufferMessageCallback(const BufferMessageCallback& cb) { buffer_message_callback_ = cb; }
+    // 由codec在输入缓冲区上分帧，按批回调FrameCallback（替代BufferMessageCallback）
+    template <typename Frame>
+    void setCodec(const std::shared_ptr<Codec<Frame>>& codec) { buffer_message_callback_ = codec->messageCallback(); }
     void setCloseCallback(const CloseCallback& cb) { close_callback_ = cb; }
+    void setHighWaterMarkCallback(const HighWaterMarkCallback& cb) { high_water_mark_callback_ = cb; }
+    void setLowWaterMarkCallback(const LowWaterMarkCallback& cb) { low_water_mark_callback_ = cb; }
+    void setWriteCompleteCallback(const WriteCompleteCallback& cb) { write_complete_callback_ = cb; }
+    
+    // 应用到之后建立的连接
+    void setWriteWatermarks(size_t high, size_t low = 0) { high_water_mark_ = high; low_water_mark_ = low; }
+    void setPauseReadingOnHighWater(bool enable) { pause_reading_on_high_water_ = enable; }
     
-    // 连接管理
+    // 连接管理（在连接所属loop中移除，CloseCallback也在该loop中回调）
     void removeConnection(const TcpConnectionPtr& conn);
     void removeConnectionInLoop(const TcpConnectionPtr& conn);
+    // 线程安全，需在start()之后调用；找不到时返回空
+    TcpConnectionPtr getConnection(ConnectionId id) const;
     
-    // 广播消息
+    // 广播消息：负载只构造一次，以共享只读块投递到每个IO loop，由各loop向自己的连接发送
     void broadcastMessage(const std::string& message);
+    void broadcastMessage(std::shared_ptr<const std::string> payload);
+    void sendToConnection(ConnectionId id, const std::string& message);
+    // 按名字发送，名字中含连接ID
     void sendToConnection(const std::string& conn_name, const std::string& message);
     
     // 统计信息
-    size_t getConnectionCount() const { return connections_.size(); }
+    size_t getConnectionCount() const { return active_connections_.load(); }
     uint64_t getTotalConnections() const { return total_connections_.load(); }
     uint64_t getActiveConnections() const { return active_connections_.load(); }
     
@@ -77,7 +146,13 @@ public:
     
 private:
     void newConnection(int sockfd, const InetAddress& peer_addr);
-    std::string generateConnectionName();
+    // reuse_port模式下在accept所在的IO loop中调用
+    void newConnectionInLoop(int sockfd, const InetAddress& peer_addr, EventLoop* io_loop);
+    TcpConnectionPtr createConnection(int sockfd, const InetAddress& peer_addr, EventLoop* io_loop);
+    void addConnectionInLoop(const TcpConnectionPtr& conn);
+    void startLoopAcceptors();
+    std::string generateConnectionName(ConnectionId id) const;
+    ConnectionShard* shardOf(ConnectionId id) const;
 };
 
 } // namespace network
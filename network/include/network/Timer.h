@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+namespace edge_infra {
+namespace network {
+
+using TimerCallback = std::function<void()>;
+
+// 定时器（时间单位：微秒，基于CLOCK_MONOTONIC）
+// 由TimerQueue持有，只在所属loop线程中访问
+class Timer {
+private:
+    const TimerCallback callback_;
+    int64_t expiration_;
+    const int64_t interval_; // 0表示单次定时器
+    const int64_t sequence_;
+    bool cancelled_;
+
+    // 时间轮槽位中的侵入式双向链表
+    Timer* prev_;
+    Timer* next_;
+    Timer** slot_; // 所在槽位的链表头，nullptr表示不在时间轮中
+
+    static std::atomic<int64_t> s_num_created_;
+
+    friend class TimerQueue;
+
+public:
+    Timer(TimerCallback cb, int64_t expiration_us, int64_t interval_us)
+        : callback_(std::move(cb)),
+          expiration_(expiration_us),
+          interval_(interval_us),
+          sequence_(++s_num_created_),
+          cancelled_(false),
+          prev_(nullptr),
+          next_(nullptr),
+          slot_(nullptr) {}
+
+    // 禁用拷贝
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    void run() const { callback_(); }
+
+    int64_t expiration() const { return expiration_; }
+    int64_t interval() const { return interval_; }
+    bool repeat() const { return interval_ > 0; }
+    int64_t sequence() const { return sequence_; }
+
+    static int64_t numCreated() { return s_num_created_.load(); }
+};
+
+// 定时器句柄，用于取消定时器；定时器到期或取消后句柄自动失效
+class TimerId {
+private:
+    int64_t sequence_;
+
+public:
+    TimerId() : sequence_(0) {}
+    explicit TimerId(int64_t seq) : sequence_(seq) {}
+
+    bool valid() const { return sequence_ > 0; }
+    int64_t sequence() const { return sequence_; }
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Timer.h"
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace edge_infra {
+namespace network {
+
+class EventLoop;
+class Channel;
+
+// 基于timerfd的分层时间轮定时器队列
+//
+// 精度为1ms一个tick，共5层：第0层256个槽，其余4层各64个槽，
+// 覆盖约49.7天，更远的定时器放在最后一层并在级联时重新分配。
+// 插入/取消均为O(1)；timerfd只设置到下一个可能有定时器到期的tick，
+// 空闲时不会产生周期性唤醒。
+class TimerQueue {
+public:
+    static const int64_t kTickUs = 1000;
+
+private:
+    static const int kTvrBits = 8;
+    static const int kTvnBits = 6;
+    static const int kTvrSize = 1 << kTvrBits;
+    static const int kTvnSize = 1 << kTvnBits;
+    static const int64_t kTvrMask = kTvrSize - 1;
+    static const int64_t kTvnMask = kTvnSize - 1;
+    static const int kTvnLevels = 4;
+    static const int64_t kMaxTicks = (1LL << (kTvrBits + kTvnLevels * kTvnBits)) - 1;
+
+    EventLoop* loop_;
+    const int timerfd_;
+    std::unique_ptr<Channel> timerfd_channel_;
+
+    Timer* tv1_[kTvrSize];
+    Timer* tvn_[kTvnLevels][kTvnSize];
+
+    const int64_t base_time_us_; // tick 0 对应的时间
+    int64_t current_tick_;       // 下一个待处理的tick
+    int64_t armed_tick_;         // timerfd当前设置的tick，-1表示未设置
+
+    // 持有所有未到期的定时器，按sequence索引以支持O(1)取消
+    std::unordered_map<int64_t, std::unique_ptr<Timer>> timers_;
+    std::vector<Timer*> expired_; // 本轮到期、已从时间轮摘下的定时器
+
+public:
+    explicit TimerQueue(EventLoop* loop);
+    ~TimerQueue();
+
+    // 禁用拷贝
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    // 线程安全
+    TimerId addTimer(TimerCallback cb, int64_t when_us, int64_t interval_us);
+    void cancel(TimerId timer_id);
+
+    // 仅限loop线程
+    size_t size() const { return timers_.size(); }
+
+    static int64_t nowMicros();
+
+private:
+    void addTimerInLoop(Timer* timer);
+    void cancelInLoop(TimerId timer_id);
+    void handleRead();
+
+    int64_t toTick(int64_t when_us) const;
+    void internalAdd(Timer* timer);
+    void link(Timer** slot, Timer* timer);
+    void unlink(Timer* timer);
+    int64_t cascade(Timer** level, int64_t index);
+    void runTick(std::vector<Timer*>* expired);
+
+    int64_t nextPendingTick() const;
+    void resetTimerfd();
+};
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,103 @@
+#include "network/Acceptor.h"
+#include "network/EventLoop.h"
+#include "network/Channel.h"
+#include "network/NetworkDebug.h"
+#include <cerrno>
+#include <fcntl.h>
+
+namespace edge_infra {
+namespace network {
+
+const int Acceptor::kMaxAcceptsPerWakeup;
+
+Acceptor::Acceptor(EventLoop* loop, const InetAddress& listen_addr, bool reuse_port)
+    : loop_(loop),
+      listening_(false),
+      idle_fd_(::open("/dev/null", O_RDONLY | O_CLOEXEC)),
+      accepted_count_(0),
+      dropped_count_(0) {
+    if (!accept_socket_.create()) {
+        NETWORK_LOG_ERROR(-1, errno, "socket");
+    }
+    accept_socket_.setReuseAddr(true);
+    if (reuse_port && !accept_socket_.setReusePort(true)) {
+        NETWORK_LOG_ERROR(accept_socket_.getFd(), errno, "SO_REUSEPORT");
+    }
+    accept_socket_.setNonBlocking(true);
+    if (!accept_socket_.bind(listen_addr.getIP(), listen_addr.getPort())) {
+        NETWORK_LOG_ERROR(accept_socket_.getFd(), errno, "bind " + listen_addr.toString());
+    }
+
+    accept_channel_.reset(new Channel(loop_, accept_socket_.getFd()));
+    accept_channel_->setDebugName("Acceptor " + listen_addr.toString());
+    accept_channel_->setReadCallback(std::bind(&Acceptor::handleRead, this));
+}
+
+Acceptor::~Acceptor() {
+    accept_channel_->disableAll();
+    accept_channel_->remove();
+    if (idle_fd_ >= 0) {
+        ::close(idle_fd_);
+    }
+}
+
+void Acceptor::listen() {
+    loop_->assertInLoopThread();
+    listening_ = true;
+    if (!accept_socket_.listen(SOMAXCONN)) {
+        NETWORK_LOG_ERROR(accept_socket_.getFd(), errno, "listen");
+    }
+    accept_channel_->enableReading();
+}
+
+void Acceptor::handleRead() {
+    loop_->assertInLoopThread();
+
+    const int listen_fd = accept_socket_.getFd();
+    int dropped = 0;
+    // 水平触发：超出预算的连接留到下一轮，不饿死同一loop上的其他fd
+    for (int i = 0; i < kMaxAcceptsPerWakeup; ++i) {
+        sockaddr_in peer;
+        socklen_t len = sizeof(peer);
+        int connfd = ::accept4(listen_fd, reinterpret_cast<sockaddr*>(&peer), &len,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connfd >= 0) {
+            ++accepted_count_;
+            InetAddress peer_addr(peer);
+            if (new_connection_callback_) {
+                new_connection_callback_(connfd, peer_addr);
+            } else {
+                ::close(connfd);
+            }
+            continue;
+        }
+
+        const int saved_errno = errno;
+        if (saved_errno == EAGAIN || saved_errno == EWOULDBLOCK) {
+            break;
+        }
+        // 对端在accept前已断开等，只影响这一个连接
+        if (saved_errno == EINTR || saved_errno == ECONNABORTED || saved_errno == EPROTO) {
+            continue;
+        }
+        if ((saved_errno == EMFILE || saved_errno == ENFILE) && idle_fd_ >= 0) {
+            if (dropped++ == 0) {
+                NETWORK_LOG_ERROR(listen_fd, saved_errno, "accept, dropping connections");
+            }
+            // 让出预留fd接受一个连接并立即关闭，对端能尽快收到FIN而不是一直等待
+            ::close(idle_fd_);
+            idle_fd_ = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (idle_fd_ >= 0) {
+                ::close(idle_fd_);
+                ++dropped_count_;
+            }
+            idle_fd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            continue;
+        }
+        NETWORK_LOG_ERROR(listen_fd, saved_errno, "accept");
+        break;
+    }
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,105 @@
+#include "network/Buffer.h"
+#include <sys/uio.h>
+#include <errno.h>
+
+namespace edge_infra {
+namespace network {
+
+const char Buffer::kCRLF[] = "\r\n";
+
+const size_t Buffer::kCheapPrepend;
+const size_t Buffer::kInitialSize;
+
+const char* Buffer::findCRLF() const {
+    return findCRLF(peek());
+}
+
+const char* Buffer::findCRLF(const char* start) const {
+    assert(peek() <= start && start <= beginWrite());
+    const char* crlf = std::search(start, beginWrite(), kCRLF, kCRLF + 2);
+    return crlf == beginWrite() ? nullptr : crlf;
+}
+
+const char* Buffer::findEOL() const {
+    return findEOL(peek());
+}
+
+const char* Buffer::findEOL(const char* start) const {
+    assert(peek() <= start && start <= beginWrite());
+    const void* eol = std::memchr(start, '\n', beginWrite() - start);
+    return static_cast<const char*>(eol);
+}
+
+int64_t Buffer::peekInt64() const {
+    assert(readableBytes() >= sizeof(int64_t));
+    uint64_t be = 0;
+    std::memcpy(&be, peek(), sizeof(be));
+    return static_cast<int64_t>(be64toh(be));
+}
+
+int32_t Buffer::peekInt32() const {
+    assert(readableBytes() >= sizeof(int32_t));
+    uint32_t be = 0;
+    std::memcpy(&be, peek(), sizeof(be));
+    return static_cast<int32_t>(be32toh(be));
+}
+
+int16_t Buffer::peekInt16() const {
+    assert(readableBytes() >= sizeof(int16_t));
+    uint16_t be = 0;
+    std::memcpy(&be, peek(), sizeof(be));
+    return static_cast<int16_t>(be16toh(be));
+}
+
+int8_t Buffer::peekInt8() const {
+    assert(readableBytes() >= sizeof(int8_t));
+    return static_cast<int8_t>(*peek());
+}
+
+void Buffer::shrink(size_t reserve) {
+    Buffer other(readableBytes() + reserve);
+    other.append(toStringView());
+    swap(other);
+}
+
+ssize_t Buffer::readFd(int fd, int* saved_errno) {
+    // 栈上额外缓冲区：避免为每个连接预分配大块内存，
+    // 同时保证大多数情况下一次readv即可读完socket中的数据
+    char extrabuf[65536];
+    struct iovec vec[2];
+    const size_t writable = writableBytes();
+    vec[0].iov_base = begin() + writer_index_;
+    vec[0].iov_len = writable;
+    vec[1].iov_base = extrabuf;
+    vec[1].iov_len = sizeof(extrabuf);
+
+    // 可写空间已经足够大时不再使用extrabuf
+    const int iovcnt = (writable < sizeof(extrabuf)) ? 2 : 1;
+    const ssize_t n = ::readv(fd, vec, iovcnt);
+    if (n < 0) {
+        *saved_errno = errno;
+    } else if (static_cast<size_t>(n) <= writable) {
+        writer_index_ += n;
+    } else {
+        writer_index_ = buffer_.size();
+        append(extrabuf, n - writable);
+    }
+    return n;
+}
+
+void Buffer::makeSpace(size_t len) {
+    if (writableBytes() + prependableBytes() < len + kCheapPrepend) {
+        buffer_.resize(writer_index_ + len);
+    } else {
+        // 空间足够：将可读数据前移到kCheapPrepend处，复用已消费的空间
+        assert(kCheapPrepend < reader_index_);
+        size_t readable = readableBytes();
+        std::copy(begin() + reader_index_, begin() + writer_index_, begin() + kCheapPrepend);
+        reader_index_ = kCheapPrepend;
+        writer_index_ = reader_index_ + readable;
+        assert(readable == readableBytes());
+    }
+}
+
+} // namespace network
+} // namespace edge_infra
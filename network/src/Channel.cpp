@@ -0,0 +1,92 @@
+#include "network/Channel.h"
+#include "network/EventLoop.h"
+#include "network/NetworkDebug.h"
+#include <cassert>
+#include <sstream>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+// 与Poller中的约定一致：-1表示尚未加入
+const int kNew = -1;
+
+} // namespace
+
+const int Channel::kNoneEvent = 0;
+const int Channel::kReadEvent = EPOLLIN | EPOLLPRI;
+const int Channel::kWriteEvent = EPOLLOUT;
+
+Channel::Channel(EventLoop* loop, int fd)
+    : loop_(loop),
+      fd_(fd),
+      events_(0),
+      revents_(0),
+      index_(kNew),
+      event_handling_(false),
+      added_to_loop_(false) {
+}
+
+Channel::~Channel() {
+    assert(!event_handling_);
+    assert(!added_to_loop_);
+}
+
+void Channel::update() {
+    added_to_loop_ = true;
+    loop_->updateChannel(this);
+}
+
+void Channel::remove() {
+    assert(isNoneEvent());
+    added_to_loop_ = false;
+    loop_->removeChannel(this);
+}
+
+void Channel::handleEvent() {
+    handleEventWithGuard();
+}
+
+void Channel::handleEventWithGuard() {
+    event_handling_ = true;
+
+    if ((revents_ & EPOLLHUP) && !(revents_ & EPOLLIN)) {
+        if (close_callback_) close_callback_();
+    }
+    if (revents_ & EPOLLERR) {
+        if (error_callback_) error_callback_();
+    }
+    if (revents_ & (EPOLLIN | EPOLLPRI | EPOLLRDHUP)) {
+        if (read_callback_) read_callback_();
+    }
+    if (revents_ & EPOLLOUT) {
+        if (write_callback_) write_callback_();
+    }
+
+    event_handling_ = false;
+}
+
+std::string Channel::reventsToString() const {
+    return eventsToString(fd_, revents_);
+}
+
+std::string Channel::eventsToString() const {
+    return eventsToString(fd_, events_);
+}
+
+std::string Channel::eventsToString(int fd, int ev) const {
+    std::ostringstream oss;
+    oss << fd << ": ";
+    if (ev & EPOLLIN) oss << "IN ";
+    if (ev & EPOLLPRI) oss << "PRI ";
+    if (ev & EPOLLOUT) oss << "OUT ";
+    if (ev & EPOLLHUP) oss << "HUP ";
+    if (ev & EPOLLRDHUP) oss << "RDHUP ";
+    if (ev & EPOLLERR) oss << "ERR ";
+    if (!debug_name_.empty()) oss << "(" << debug_name_ << ")";
+    return oss.str();
+}
+
+} // namespace network
+} // namespace edge_infra
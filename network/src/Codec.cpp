@@ -0,0 +1,53 @@
+#include "network/Codec.h"
+#include <cstring>
+
+namespace edge_infra {
+namespace network {
+
+JsonLineCodec::DecodeResult JsonLineCodec::decodeFrame(const char* data, size_t len, std::string_view* frame,
+                                                       size_t* consumed, std::string* error) {
+    size_t start = 0;
+    while (true) {
+        const char* eol = static_cast<const char*>(std::memchr(data + start, '\n', len - start));
+        if (eol == nullptr) {
+            if (len - start > max_frame_size_) {
+                *error = "json line exceeds " + std::to_string(max_frame_size_) + " bytes";
+                return kError;
+            }
+            // 已跳过的空行交给调用方丢弃
+            *consumed = start;
+            return kNeedMore;
+        }
+
+        size_t line_end = eol - data;
+        size_t next = line_end + 1;
+        if (line_end > start && data[line_end - 1] == '\r') {
+            --line_end;
+        }
+        if (line_end - start > max_frame_size_) {
+            *error = "json line exceeds " + std::to_string(max_frame_size_) + " bytes";
+            return kError;
+        }
+        if (line_end == start) {
+            // 空行（心跳常用），并入下一帧的consumed
+            start = next;
+            if (start == len) {
+                *consumed = start;
+                return kNeedMore;
+            }
+            continue;
+        }
+
+        *frame = std::string_view(data + start, line_end - start);
+        *consumed = next;
+        return kFrame;
+    }
+}
+
+void JsonLineCodec::encodeFrame(const std::string_view& frame, OutputQueue* out) {
+    out->append(frame);
+    out->append("\n", 1);
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,217 @@
+#include "network/EventLoop.h"
+#include "network/Channel.h"
+#include "network/Poller.h"
+#include "network/TimerQueue.h"
+#include "network/NetworkDebug.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+thread_local EventLoop* t_loop_in_this_thread = nullptr;
+
+const int kPollTimeMs = 10000;
+
+int createEventfd() {
+    int evtfd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (evtfd < 0) {
+        NETWORK_LOG_ERROR(-1, errno, "eventfd");
+        std::abort();
+    }
+    return evtfd;
+}
+
+} // namespace
+
+EventLoop::EventLoop(PollerType poller_type)
+    : running_(false),
+      quit_(false),
+      thread_id_(std::this_thread::get_id()),
+      poller_(Poller::newPoller(this, poller_type)),
+      calling_pending_functors_(false),
+      wakeup_fd_(createEventfd()),
+      wakeup_channel_(new Channel(this, wakeup_fd_)),
+      loop_count_(0),
+      event_count_(0),
+      debug_enabled_(false) {
+    if (t_loop_in_this_thread != nullptr) {
+        NETWORK_ERROR_LOG("EventLoop", "another EventLoop exists in this thread");
+        std::abort();
+    }
+    t_loop_in_this_thread = this;
+
+    wakeup_channel_->setDebugName("EventLoop wakeup");
+    wakeup_channel_->setReadCallback(std::bind(&EventLoop::handleWakeup, this));
+    wakeup_channel_->enableReading();
+
+    timer_queue_.reset(new TimerQueue(this));
+}
+
+EventLoop::~EventLoop() {
+    timer_queue_.reset();
+    wakeup_channel_->disableAll();
+    wakeup_channel_->remove();
+    ::close(wakeup_fd_);
+    t_loop_in_this_thread = nullptr;
+}
+
+void EventLoop::loop() {
+    assertInLoopThread();
+    running_ = true;
+    quit_ = false;
+    debugLog("loop start");
+
+    while (!quit_) {
+        active_channels_.clear();
+        poller_->poll(kPollTimeMs, &active_channels_);
+        const uint64_t busy_start_us = metrics::steadyMicros();
+        ++loop_count_;
+        event_count_ += active_channels_.size();
+
+        for (Channel* channel : active_channels_) {
+            channel->handleEvent();
+        }
+        doPendingFunctors();
+        NetworkDebug::recordEventProcessed(active_channels_.size());
+        NetworkDebug::recordLoopIteration(metrics::steadyMicros() - busy_start_us);
+    }
+
+    debugLog("loop stop");
+    running_ = false;
+}
+
+void EventLoop::quit() {
+    quit_ = true;
+    if (!isInLoopThread()) {
+        wakeup();
+    }
+}
+
+void EventLoop::runInLoop(std::function<void()> cb) {
+    if (isInLoopThread()) {
+        cb();
+    } else {
+        queueInLoop(std::move(cb));
+    }
+}
+
+void EventLoop::queueInLoop(std::function<void()> cb) {
+    {
+        std::lock_guard<std::mutex> lock(functors_mutex_);
+        pending_functors_.push_back(std::move(cb));
+    }
+
+    // 正在执行pending functors时新加入的任务需要下一轮处理，也要唤醒
+    if (!isInLoopThread() || calling_pending_functors_) {
+        wakeup();
+    }
+}
+
+void EventLoop::updateChannel(Channel* channel) {
+    assertInLoopThread();
+    poller_->updateChannel(channel);
+}
+
+void EventLoop::removeChannel(Channel* channel) {
+    assertInLoopThread();
+    poller_->removeChannel(channel);
+}
+
+bool EventLoop::hasChannel(Channel* channel) {
+    assertInLoopThread();
+    return poller_->hasChannel(channel);
+}
+
+TimerId EventLoop::runAfter(double delay, TimerCallback cb) {
+    int64_t when = TimerQueue::nowMicros() + static_cast<int64_t>(delay * 1000000);
+    return timer_queue_->addTimer(std::move(cb), when, 0);
+}
+
+TimerId EventLoop::runEvery(double interval, TimerCallback cb) {
+    int64_t interval_us = static_cast<int64_t>(interval * 1000000);
+    if (interval_us < TimerQueue::kTickUs) {
+        interval_us = TimerQueue::kTickUs;
+    }
+    int64_t when = TimerQueue::nowMicros() + interval_us;
+    return timer_queue_->addTimer(std::move(cb), when, interval_us);
+}
+
+void EventLoop::cancel(TimerId timer_id) {
+    timer_queue_->cancel(timer_id);
+}
+
+bool EventLoop::isInLoopThread() const {
+    return thread_id_ == std::this_thread::get_id();
+}
+
+void EventLoop::assertInLoopThread() const {
+    if (!isInLoopThread()) {
+        std::ostringstream oss;
+        oss << "EventLoop " << this << " was created in thread " << thread_id_
+            << ", current thread is " << std::this_thread::get_id();
+        NETWORK_ERROR_LOG("EventLoop", oss.str());
+        std::abort();
+    }
+}
+
+void EventLoop::enableDebug(bool enable) {
+    debug_enabled_ = enable;
+}
+
+void EventLoop::printStatistics() const {
+    std::cout << "=== EventLoop Statistics ===" << std::endl;
+    std::cout << "Thread: " << thread_id_ << std::endl;
+    std::cout << "Poller: " << poller_->name() << std::endl;
+    std::cout << "Running: " << (running_.load() ? "yes" : "no") << std::endl;
+    std::cout << "Loop Count: " << loop_count_.load() << std::endl;
+    std::cout << "Event Count: " << event_count_.load() << std::endl;
+    std::cout << "Timers Created: " << Timer::numCreated() << std::endl;
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    ssize_t n = ::write(wakeup_fd_, &one, sizeof(one));
+    if (n != sizeof(one)) {
+        NETWORK_LOG_ERROR(wakeup_fd_, errno, "wakeup write");
+    }
+}
+
+void EventLoop::handleWakeup() {
+    uint64_t one = 0;
+    ssize_t n = ::read(wakeup_fd_, &one, sizeof(one));
+    if (n != sizeof(one)) {
+        NETWORK_LOG_ERROR(wakeup_fd_, errno, "wakeup read");
+    }
+}
+
+void EventLoop::doPendingFunctors() {
+    std::vector<std::function<void()>> functors;
+    calling_pending_functors_ = true;
+
+    {
+        std::lock_guard<std::mutex> lock(functors_mutex_);
+        functors.swap(pending_functors_);
+    }
+
+    for (const auto& functor : functors) {
+        functor();
+    }
+    calling_pending_functors_ = false;
+}
+
+void EventLoop::debugLog(const std::string& message) const {
+    if (!debug_enabled_) return;
+    std::ostringstream oss;
+    oss << "[" << thread_id_ << "] " << message;
+    NetworkDebug::debugLog("EventLoop", oss.str());
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,74 @@
+#include "network/EventLoopThread.h"
+#include "network/EventLoop.h"
+#include "network/NetworkDebug.h"
+#include <pthread.h>
+#include <sched.h>
+
+namespace edge_infra {
+namespace network {
+
+EventLoopThread::EventLoopThread(const ThreadInitCallback& cb, const std::string& name, int cpu_id)
+    : loop_(nullptr),
+      callback_(cb),
+      name_(name),
+      cpu_id_(cpu_id) {
+}
+
+EventLoopThread::~EventLoopThread() {
+    EventLoop* loop = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loop = loop_;
+    }
+    if (loop != nullptr) {
+        loop->quit();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+EventLoop* EventLoopThread::startLoop() {
+    thread_ = std::thread(&EventLoopThread::threadFunc, this);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return loop_ != nullptr; });
+    return loop_;
+}
+
+void EventLoopThread::threadFunc() {
+    if (!name_.empty()) {
+        // 线程名最长15个字符
+        pthread_setname_np(pthread_self(), name_.substr(0, 15).c_str());
+    }
+    if (cpu_id_ >= 0 && !bindToCpu(cpu_id_)) {
+        NETWORK_ERROR_LOG("EventLoopThread", name_ + " failed to bind to cpu " + std::to_string(cpu_id_));
+    }
+
+    EventLoop loop;
+    if (callback_) {
+        callback_(&loop);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loop_ = &loop;
+    }
+    cond_.notify_one();
+
+    NETWORK_DEBUG_LOG("EventLoopThread", name_ + " started");
+    loop.loop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    loop_ = nullptr;
+}
+
+bool EventLoopThread::bindToCpu(int cpu_id) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu_id, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+}
+
+} // namespace network
+} // namespace edge_infra
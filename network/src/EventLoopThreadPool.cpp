@@ -0,0 +1,145 @@
+#include "network/EventLoopThreadPool.h"
+#include "network/EventLoopThread.h"
+#include "network/EventLoop.h"
+#include "network/NetworkDebug.h"
+#include <iostream>
+#include <thread>
+
+namespace edge_infra {
+namespace network {
+
+EventLoopThreadPool::EventLoopThreadPool(EventLoop* base_loop, const std::string& name)
+    : base_loop_(base_loop),
+      name_(name),
+      started_(false),
+      num_threads_(0),
+      next_(0),
+      strategy_(kRoundRobin),
+      cpu_affinity_(false) {
+}
+
+EventLoopThreadPool::~EventLoopThreadPool() {
+    // loop对象位于各自线程的栈上，由EventLoopThread负责退出
+}
+
+void EventLoopThreadPool::setCpuAffinity(bool enable, const std::vector<int>& cpus) {
+    cpu_affinity_ = enable;
+    cpu_list_ = cpus;
+}
+
+void EventLoopThreadPool::start(const ThreadInitCallback& cb) {
+    base_loop_->assertInLoopThread();
+    if (started_) return;
+    started_ = true;
+
+    int hw_cpus = static_cast<int>(std::thread::hardware_concurrency());
+    for (int i = 0; i < num_threads_; ++i) {
+        int cpu_id = -1;
+        if (cpu_affinity_) {
+            if (!cpu_list_.empty()) {
+                cpu_id = cpu_list_[i % cpu_list_.size()];
+            } else if (hw_cpus > 0) {
+                cpu_id = i % hw_cpus;
+            }
+        }
+
+        std::string thread_name = name_ + std::to_string(i);
+        threads_.emplace_back(new EventLoopThread(cb, thread_name, cpu_id));
+        loops_.push_back(threads_.back()->startLoop());
+    }
+
+    loads_.reset(new std::atomic<int>[loops_.size()]);
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        loads_[i].store(0, std::memory_order_relaxed);
+    }
+
+    if (num_threads_ == 0 && cb) {
+        cb(base_loop_);
+    }
+
+    NETWORK_DEBUG_LOG("EventLoopThreadPool", name_ + " started with " +
+                      std::to_string(num_threads_) + " io threads");
+}
+
+EventLoop* EventLoopThreadPool::getNextLoop() {
+    base_loop_->assertInLoopThread();
+    if (loops_.empty()) {
+        return base_loop_;
+    }
+
+    if (strategy_ == kLeastConnections) {
+        return getLeastLoadedLoop();
+    }
+
+    EventLoop* loop = loops_[next_];
+    next_ = (next_ + 1) % loops_.size();
+    return loop;
+}
+
+EventLoop* EventLoopThreadPool::getLoopForHash(size_t hash_code) {
+    base_loop_->assertInLoopThread();
+    if (loops_.empty()) {
+        return base_loop_;
+    }
+    return loops_[hash_code % loops_.size()];
+}
+
+std::vector<EventLoop*> EventLoopThreadPool::getAllLoops() {
+    base_loop_->assertInLoopThread();
+    if (loops_.empty()) {
+        return std::vector<EventLoop*>(1, base_loop_);
+    }
+    return loops_;
+}
+
+void EventLoopThreadPool::addLoad(EventLoop* loop, int delta) {
+    int idx = indexOf(loop);
+    if (idx >= 0) {
+        loads_[idx].fetch_add(delta, std::memory_order_relaxed);
+    }
+}
+
+int EventLoopThreadPool::getLoad(EventLoop* loop) const {
+    int idx = indexOf(loop);
+    return idx >= 0 ? loads_[idx].load(std::memory_order_relaxed) : 0;
+}
+
+void EventLoopThreadPool::printStatistics() const {
+    std::cout << "=== EventLoopThreadPool Statistics ===" << std::endl;
+    std::cout << "Name: " << name_ << std::endl;
+    std::cout << "IO Threads: " << loops_.size() << std::endl;
+    std::cout << "Strategy: " << (strategy_ == kRoundRobin ? "round-robin" : "least-connections") << std::endl;
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        std::cout << "  [" << threads_[i]->name() << "] cpu=" << threads_[i]->cpuId()
+                  << " connections=" << loads_[i].load(std::memory_order_relaxed) << std::endl;
+    }
+}
+
+int EventLoopThreadPool::indexOf(EventLoop* loop) const {
+    // 线程数与核心数相当，线性查找即可
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        if (loops_[i] == loop) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+EventLoop* EventLoopThreadPool::getLeastLoadedLoop() {
+    // 从轮询位置开始扫描，负载相同时依次分散到不同loop
+    size_t best = next_;
+    int best_load = loads_[best].load(std::memory_order_relaxed);
+    for (size_t n = 1; n < loops_.size(); ++n) {
+        size_t i = (next_ + n) % loops_.size();
+        int load = loads_[i].load(std::memory_order_relaxed);
+        if (load < best_load) {
+            best = i;
+            best_load = load;
+        }
+    }
+    next_ = (best + 1) % loops_.size();
+    return loops_[best];
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,318 @@
+#include "network/IoUringPoller.h"
+#include "network/Channel.h"
+#include "network/NetworkDebug.h"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+// Channel::index() 在Poller中的含义
+const int kNew = -1;
+const int kAdded = 1;
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                 const void* arg, size_t arg_size) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+// 与内核共享的环形队列指针：读对端推进的一侧用acquire，发布本端推进用release
+unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+void storeRelease(unsigned* p, unsigned v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+uint32_t toPollMask(int events) {
+    uint32_t mask = static_cast<uint32_t>(events);
+#if __BYTE_ORDER == __BIG_ENDIAN
+    mask = (mask << 16) | (mask >> 16);   // 内核按小端半字布局读取poll32_events
+#endif
+    return mask;
+}
+
+} // namespace
+
+const unsigned IoUringPoller::kQueueDepth;
+const uint64_t IoUringPoller::kRemoveTag;
+
+IoUringPoller::IoUringPoller(EventLoop* loop)
+    : Poller(loop),
+      ring_fd_(-1),
+      sq_ring_(MAP_FAILED),
+      sq_ring_size_(0),
+      sq_head_(nullptr),
+      sq_tail_(nullptr),
+      sq_array_(nullptr),
+      sq_mask_(0),
+      sq_entries_(0),
+      sq_local_tail_(0),
+      sqes_(nullptr),
+      sqes_size_(0),
+      cq_ring_(MAP_FAILED),
+      cq_ring_size_(0),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(0),
+      cqes_(nullptr),
+      next_generation_(1) {
+    if (!setupRings()) {
+        releaseRings();
+    }
+}
+
+IoUringPoller::~IoUringPoller() {
+    releaseRings();
+}
+
+bool IoUringPoller::setupRings() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring_fd_ = ioUringSetup(kQueueDepth, &params);
+    if (ring_fd_ < 0) {
+        NETWORK_LOG_ERROR(-1, errno, "io_uring_setup");
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP)) {
+        NETWORK_ERROR_LOG("IoUringPoller", "kernel lacks IORING_FEAT_EXT_ARG/NODROP");
+        return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        NETWORK_LOG_ERROR(ring_fd_, errno, "mmap sq ring");
+        return false;
+    }
+    if (single_mmap) {
+        cq_ring_ = sq_ring_;
+    } else {
+        cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            NETWORK_LOG_ERROR(ring_fd_, errno, "mmap cq ring");
+            return false;
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        NETWORK_LOG_ERROR(ring_fd_, errno, "mmap sqes");
+        sqes_size_ = 0;
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    sq_local_tail_ = *sq_tail_;
+
+    char* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+}
+
+void IoUringPoller::releaseRings() {
+    if (sqes_ != nullptr) {
+        ::munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = MAP_FAILED;
+    if (sq_ring_ != MAP_FAILED) {
+        ::munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = MAP_FAILED;
+    }
+    // 关闭ring会取消所有未完成的poll
+    if (ring_fd_ >= 0) {
+        ::close(ring_fd_);
+        ring_fd_ = -1;
+    }
+}
+
+io_uring_sqe* IoUringPoller::getSqe() {
+    if (sq_local_tail_ - loadAcquire(sq_head_) >= sq_entries_) {
+        // SQ已满，先提交不等待
+        enter(false, 0);
+        if (sq_local_tail_ - loadAcquire(sq_head_) >= sq_entries_) {
+            NETWORK_ERROR_LOG("IoUringPoller", "submission queue full");
+            return nullptr;
+        }
+    }
+    const unsigned index = sq_local_tail_ & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    ++sq_local_tail_;
+    return sqe;
+}
+
+int IoUringPoller::enter(bool wait, int timeout_ms) {
+    storeRelease(sq_tail_, sq_local_tail_);
+    const unsigned to_submit = sq_local_tail_ - loadAcquire(sq_head_);
+    if (!wait && to_submit == 0) {
+        return 0;
+    }
+
+    __kernel_timespec ts;
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+    }
+
+    const unsigned flags = wait ? (IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG) : IORING_ENTER_EXT_ARG;
+    int ret = ioUringEnter(ring_fd_, to_submit, wait ? 1 : 0, flags, &arg, sizeof(arg));
+    if (ret < 0) {
+        const int saved_errno = errno;
+        // ETIME为等待超时；EBUSY/EAGAIN为CQ积压，收割后下一轮会继续提交
+        if (saved_errno != ETIME && saved_errno != EINTR && saved_errno != EBUSY && saved_errno != EAGAIN) {
+            NETWORK_LOG_ERROR(ring_fd_, saved_errno, "io_uring_enter");
+        }
+    }
+    return ret;
+}
+
+int IoUringPoller::poll(int timeout_ms, ChannelList* active_channels) {
+    // 上一轮触发过的oneshot poll在回调处理完之后才重新挂上
+    for (int fd : rearm_fds_) {
+        auto it = registrations_.find(fd);
+        if (it == registrations_.end() || it->second.armed) continue;
+        Channel* channel = channels_[fd];
+        if (!channel->isNoneEvent()) {
+            arm(fd, &it->second, channel->events());
+        }
+    }
+    rearm_fds_.clear();
+
+    enter(true, timeout_ms);
+    return reapCompletions(active_channels);
+}
+
+int IoUringPoller::reapCompletions(ChannelList* active_channels) {
+    unsigned head = *cq_head_;
+    const unsigned tail = loadAcquire(cq_tail_);
+    int num_events = 0;
+
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        if (cqe.user_data == kRemoveTag) continue;
+
+        const int fd = static_cast<int>(cqe.user_data & 0xffffffffu);
+        auto it = registrations_.find(fd);
+        // 已注销或已重新挂载，属于旧poll的完成
+        if (it == registrations_.end() || it->second.user_data != cqe.user_data) continue;
+
+        Registration& reg = it->second;
+        reg.armed = false;
+        rearm_fds_.push_back(fd);
+        if (cqe.res == -ECANCELED) continue;
+
+        int revents = cqe.res;
+        if (cqe.res < 0) {
+            NETWORK_LOG_ERROR(fd, -cqe.res, "io_uring poll");
+            revents = EPOLLERR;
+        }
+        Channel* channel = channels_[fd];
+        channel->set_revents(revents);
+        active_channels->push_back(channel);
+        ++num_events;
+    }
+    storeRelease(cq_head_, head);
+    return num_events;
+}
+
+void IoUringPoller::arm(int fd, Registration* reg, int events) {
+    io_uring_sqe* sqe = getSqe();
+    if (sqe == nullptr) return;
+    reg->user_data = (static_cast<uint64_t>(next_generation_++) << 32) | static_cast<uint32_t>(fd);
+    reg->events = events;
+    reg->armed = true;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = toPollMask(events);
+    sqe->user_data = reg->user_data;
+}
+
+void IoUringPoller::disarm(Registration* reg) {
+    reg->armed = false;
+    io_uring_sqe* sqe = getSqe();
+    if (sqe == nullptr) return;
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = reg->user_data;
+    sqe->user_data = kRemoveTag;
+}
+
+void IoUringPoller::updateChannel(Channel* channel) {
+    assertInLoopThread();
+    const int fd = channel->fd();
+
+    if (channel->index() == kNew) {
+        channels_[fd] = channel;
+        registrations_[fd] = Registration{0, 0, false};
+        channel->set_index(kAdded);
+    }
+
+    Registration& reg = registrations_[fd];
+    if (reg.armed) {
+        if (reg.events == channel->events()) return;
+        disarm(&reg);
+    }
+    if (!channel->isNoneEvent()) {
+        arm(fd, &reg, channel->events());
+    }
+}
+
+void IoUringPoller::removeChannel(Channel* channel) {
+    assertInLoopThread();
+    const int fd = channel->fd();
+
+    auto it = registrations_.find(fd);
+    if (it != registrations_.end()) {
+        if (it->second.armed) {
+            disarm(&it->second);
+        }
+        registrations_.erase(it);
+    }
+    channels_.erase(fd);
+    channel->set_index(kNew);
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,80 @@
+#include "network/MetricsServer.h"
+#include "network/TcpConnection.h"
+#include "network/Buffer.h"
+#include "network/NetworkDebug.h"
+#include <cstring>
+
+namespace edge_infra {
+namespace network {
+
+const size_t MetricsServer::kMaxRequestSize;
+
+MetricsServer::MetricsServer(EventLoop* loop, const InetAddress& listen_addr, const std::string& path,
+                             const std::string& traces_path)
+    : server_(loop, listen_addr, "MetricsServer"),
+      path_(path),
+      traces_path_(traces_path) {
+    server_.setBufferMessageCallback(
+        [this](const TcpConnectionPtr& conn, Buffer* buf) { onMessage(conn, buf); });
+}
+
+void MetricsServer::onMessage(const TcpConnectionPtr& conn, Buffer* buf) {
+    // 等到请求头完整再处理
+    const std::string_view data = buf->toStringView();
+    if (data.find("\r\n\r\n") == std::string_view::npos) {
+        if (buf->readableBytes() > kMaxRequestSize) {
+            // 丢弃已读数据并关闭连接，否则对端持续发送时输入缓冲区会无限增长
+            buf->retrieveAll();
+            sendResponse(conn, "431 Request Header Fields Too Large", "text/plain", "request too large\n");
+            conn->forceClose();
+        }
+        return;
+    }
+
+    const char* eol = buf->findCRLF();
+    const std::string_view request_line(buf->peek(), eol - buf->peek());
+    buf->retrieveAll();
+
+    // METHOD SP TARGET SP VERSION
+    const size_t first_space = request_line.find(' ');
+    const size_t second_space = first_space == std::string_view::npos
+                                    ? std::string_view::npos : request_line.find(' ', first_space + 1);
+    if (second_space == std::string_view::npos) {
+        sendResponse(conn, "400 Bad Request", "text/plain", "bad request\n");
+        return;
+    }
+    const std::string_view method = request_line.substr(0, first_space);
+    std::string_view target = request_line.substr(first_space + 1, second_space - first_space - 1);
+    target = target.substr(0, target.find('?'));
+
+    if (target != path_ && target != traces_path_) {
+        sendResponse(conn, "404 Not Found", "text/plain", "not found\n");
+    } else if (method != "GET") {
+        sendResponse(conn, "405 Method Not Allowed", "text/plain", "method not allowed\n");
+    } else if (target == path_) {
+        sendResponse(conn, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                     metrics::MetricsRegistry::instance().exportPrometheus());
+    } else {
+        // collect会取走span，同一时间只应有一个采集者
+        sendResponse(conn, "200 OK", "application/json",
+                     trace::Tracer::exportChromeTrace(trace::Tracer::collect()));
+    }
+}
+
+void MetricsServer::sendResponse(const TcpConnectionPtr& conn, const char* status,
+                                 const char* content_type, const std::string& body) {
+    std::string response;
+    response.reserve(body.size() + 160);
+    response += "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += content_type;
+    response += "\r\nContent-Length: " + std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+    conn->send(std::move(response));
+    conn->shutdown();
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -1,4 +1,5 @@
 #include "network/NetworkDebug.h"
+#include "async_logger.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -11,7 +12,27 @@ std::atomic<bool> NetworkDebug::debug_enabled_{false};
 std::atomic<bool> NetworkDebug::performance_monitoring_{false};
 std::mutex NetworkDebug::log_mutex_;
 std::ofstream NetworkDebug::debug_log_;
-NetworkDebug::NetworkStats NetworkDebug::stats_;
+std::string NetworkDebug::log_file_;
+std::atomic<bool> NetworkDebug::async_enabled_{false};
+std::unique_ptr<AsyncLogBackend> NetworkDebug::async_backend_;
+
+NetworkDebug::NetworkStats::NetworkStats() {
+    metrics::MetricsRegistry& registry = metrics::MetricsRegistry::instance();
+    bytes_sent = registry.counter("edge_network_bytes_sent_total", "Bytes written to TCP connections");
+    bytes_received = registry.counter("edge_network_bytes_received_total", "Bytes read from TCP connections");
+    connections_created = registry.counter("edge_network_connections_created_total", "TCP connections accepted");
+    connections_closed = registry.counter("edge_network_connections_closed_total", "TCP connections closed");
+    events_processed = registry.counter("edge_network_events_processed_total", "Channel events handled by event loops");
+    errors_count = registry.counter("edge_network_errors_total", "Network errors");
+    loop_iteration_us = registry.histogram("edge_network_loop_iteration_us",
+                                           "Event loop busy time per iteration in microseconds");
+    metrics::Counter* created = connections_created;
+    metrics::Counter* closed = connections_closed;
+    registry.registerCallback("edge_network_connections_active", "Open TCP connections",
+                              metrics::MetricType::kGauge, "", [created, closed] {
+        return static_cast<double>(created->value()) - static_cast<double>(closed->value());
+    });
+}
 
 void NetworkDebug::enableDebug(bool enable) {
     debug_enabled_.store(enable);
@@ -28,55 +49,96 @@ void NetworkDebug::enablePerformanceMonitoring(bool enable) {
 }
 
 void NetworkDebug::setLogFile(const std::string& filename) {
+    bool opened = false;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        if (debug_log_.is_open()) {
+            debug_log_.close();
+        }
+        debug_log_.open(filename, std::ios::app);
+        opened = debug_log_.is_open();
+        log_file_ = filename;
+        if (async_backend_) {
+            async_backend_->setLogFile(filename);
+        }
+    }
+    if (opened) {
+        debugLog("NetworkDebug", "Log file set to: " + filename);
+    }
+}
+
+void NetworkDebug::enableAsyncLogging(bool enable) {
+    {
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        if (enable && !async_backend_) {
+            // 后端创建后不再销毁，避免与正在写日志的线程竞争
+            async_backend_.reset(new AsyncLogBackend());
+            if (!log_file_.empty()) {
+                async_backend_->setLogFile(log_file_);
+            }
+        }
+        async_enabled_.store(enable);
+    }
+    if (!enable) {
+        flushLog();
+    }
+}
+
+void NetworkDebug::flushLog() {
+    AsyncLogBackend* backend = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        backend = async_backend_.get();
+        if (debug_log_.is_open()) {
+            debug_log_.flush();
+        }
+    }
+    if (backend != nullptr) {
+        backend->flush();
+    }
+}
+
+uint64_t NetworkDebug::getDroppedLogLines() {
     std::lock_guard<std::mutex> lock(log_mutex_);
-    if (debug_log_.is_open()) {
-        debug_log_.close();
+    return async_backend_ ? async_backend_->droppedLines() : 0;
+}
+
+void NetworkDebug::writeLine(const std::string& line, bool is_error) {
+    // async_enabled_为true时async_backend_已创建且不会再变
+    if (async_enabled_.load(std::memory_order_acquire)) {
+        async_backend_->append(line, is_error);
+        return;
     }
-    debug_log_.open(filename, std::ios::app);
+
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    (is_error ? std::cerr : std::cout) << line << '\n';
     if (debug_log_.is_open()) {
-        debugLog("NetworkDebug", "Log file set to: " + filename);
+        debug_log_ << line << '\n';
+        debug_log_.flush();
     }
 }
 
 void NetworkDebug::debugLog(const std::string& component, const std::string& message) {
     if (!debug_enabled_.load()) return;
     
-    std::lock_guard<std::mutex> lock(log_mutex_);
     std::string log_line = "[" + getCurrentTime() + "] [DEBUG] [" + component + "] " + message;
-    
-    std::cout << log_line << std::endl;
-    if (debug_log_.is_open()) {
-        debug_log_ << log_line << std::endl;
-        debug_log_.flush();
-    }
+    writeLine(log_line, false);
 }
 
 void NetworkDebug::errorLog(const std::string& component, const std::string& error) {
     recordError();
     
-    std::lock_guard<std::mutex> lock(log_mutex_);
     std::string log_line = "[" + getCurrentTime() + "] [ERROR] [" + component + "] " + error;
-    
-    std::cerr << log_line << std::endl;
-    if (debug_log_.is_open()) {
-        debug_log_ << log_line << std::endl;
-        debug_log_.flush();
-    }
+    writeLine(log_line, true);
 }
 
 void NetworkDebug::performanceLog(const std::string& operation, double duration_ms) {
     if (!performance_monitoring_.load()) return;
     
-    std::lock_guard<std::mutex> lock(log_mutex_);
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(3) << duration_ms;
     std::string log_line = "[" + getCurrentTime() + "] [PERF] " + operation + " took " + oss.str() + "ms";
-    
-    std::cout << log_line << std::endl;
-    if (debug_log_.is_open()) {
-        debug_log_ << log_line << std::endl;
-        debug_log_.flush();
-    }
+    writeLine(log_line, false);
 }
 
 void NetworkDebug::printStatistics() {
@@ -97,12 +159,14 @@ std::string NetworkDebug::getStatisticsString() {
 }
 
 void NetworkDebug::resetStatistics() {
-    stats_.bytes_sent.store(0);
-    stats_.bytes_received.store(0);
-    stats_.connections_created.store(0);
-    stats_.connections_closed.store(0);
-    stats_.events_processed.store(0);
-    stats_.errors_count.store(0);
+    NetworkStats& s = stats();
+    s.bytes_sent->reset();
+    s.bytes_received->reset();
+    s.connections_created->reset();
+    s.connections_closed->reset();
+    s.events_processed->reset();
+    s.errors_count->reset();
+    s.loop_iteration_us->reset();
     debugLog("NetworkDebug", "Statistics reset");
 }
 
@@ -136,11 +200,7 @@ void NetworkDebug::logSocketError(int fd, int error_code, const std::string& ope
 }
 
 std::string NetworkDebug::getCurrentTime() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    return LogTimestamp::now();
 }
 
 std::string NetworkDebug::formatBytes(uint64_t bytes) {
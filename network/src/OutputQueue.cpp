@@ -0,0 +1,213 @@
+#include "network/OutputQueue.h"
+#include <cerrno>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+// 单次sendfile的上限，避免长时间占用loop线程
+const size_t kMaxSendfileChunk = 1 << 20;
+
+} // namespace
+
+const size_t OutputQueue::kCoalesceLimit;
+const int OutputQueue::kMaxIovecs;
+
+OutputQueue::Segment::Segment()
+    : kind(MEMORY), data(nullptr), size(0), fd(-1), file_offset(0), close_fd(false) {
+}
+
+OutputQueue::Segment::~Segment() {
+    if (close_fd && fd >= 0) {
+        ::close(fd);
+    }
+}
+
+OutputQueue::Segment::Segment(Segment&& other) noexcept
+    : kind(other.kind),
+      keeper(std::move(other.keeper)),
+      data(other.data),
+      size(other.size),
+      fd(other.fd),
+      file_offset(other.file_offset),
+      close_fd(other.close_fd) {
+    if (kind == MEMORY && !keeper) {
+        // data指向owned内部，移动后重新定位
+        const size_t consumed = other.owned.size() - other.size;
+        owned = std::move(other.owned);
+        data = owned.data() + consumed;
+    }
+    other.data = nullptr;
+    other.size = 0;
+    other.fd = -1;
+    other.close_fd = false;
+}
+
+OutputQueue::OutputQueue(OutputQueue&& other) noexcept
+    : segments_(std::move(other.segments_)), bytes_(other.bytes_) {
+    other.segments_.clear();
+    other.bytes_ = 0;
+}
+
+OutputQueue& OutputQueue::operator=(OutputQueue&& other) noexcept {
+    if (this != &other) {
+        segments_ = std::move(other.segments_);
+        bytes_ = other.bytes_;
+        other.segments_.clear();
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+OutputQueue::Segment& OutputQueue::pushMemory() {
+    segments_.emplace_back();
+    return segments_.back();
+}
+
+void OutputQueue::append(const char* data, size_t len) {
+    if (len == 0) return;
+    if (segments_.empty() || !segments_.back().coalescable()) {
+        pushMemory();
+    }
+    Segment& tail = segments_.back();
+    // owned可能重新分配，先记下已发送的前缀长度
+    const size_t consumed = tail.owned.size() - tail.size;
+    tail.owned.append(data, len);
+    tail.data = tail.owned.data() + consumed;
+    tail.size += len;
+    bytes_ += len;
+}
+
+void OutputQueue::append(std::string&& data) {
+    if (data.size() < kCoalesceLimit) {
+        append(data.data(), data.size());
+        return;
+    }
+    Segment& segment = pushMemory();
+    segment.owned = std::move(data);
+    segment.data = segment.owned.data();
+    segment.size = segment.owned.size();
+    bytes_ += segment.size;
+}
+
+void OutputQueue::append(std::shared_ptr<const void> keeper, const char* data, size_t len) {
+    if (len == 0) return;
+    if (!keeper || len < kCoalesceLimit) {
+        append(data, len);
+        return;
+    }
+    Segment& segment = pushMemory();
+    segment.keeper = std::move(keeper);
+    segment.data = data;
+    segment.size = len;
+    bytes_ += len;
+}
+
+void OutputQueue::append(std::shared_ptr<const std::string> block) {
+    if (!block) return;
+    const char* data = block->data();
+    const size_t len = block->size();
+    append(std::shared_ptr<const void>(std::move(block)), data, len);
+}
+
+void OutputQueue::appendFile(int fd, off_t offset, size_t len, bool close_when_done) {
+    if (len == 0) {
+        if (close_when_done && fd >= 0) ::close(fd);
+        return;
+    }
+    segments_.emplace_back();
+    Segment& segment = segments_.back();
+    segment.kind = Segment::FILE;
+    segment.fd = fd;
+    segment.file_offset = offset;
+    segment.size = len;
+    segment.close_fd = close_when_done;
+    bytes_ += len;
+}
+
+void OutputQueue::append(OutputQueue&& other) {
+    if (&other == this) return;
+    for (Segment& segment : other.segments_) {
+        segments_.push_back(std::move(segment));
+    }
+    bytes_ += other.bytes_;
+    other.segments_.clear();
+    other.bytes_ = 0;
+}
+
+void OutputQueue::clear() {
+    segments_.clear();
+    bytes_ = 0;
+}
+
+void OutputQueue::consume(size_t len) {
+    bytes_ -= len;
+    while (len > 0) {
+        Segment& front = segments_.front();
+        const size_t n = len < front.size ? len : front.size;
+        front.size -= n;
+        if (front.kind == Segment::FILE) {
+            front.file_offset += static_cast<off_t>(n);
+        } else {
+            front.data += n;
+        }
+        len -= n;
+        if (front.size == 0) {
+            segments_.pop_front();
+        }
+    }
+}
+
+ssize_t OutputQueue::writeTo(int fd, int* saved_errno) {
+    ssize_t total = 0;
+    while (!segments_.empty()) {
+        Segment& front = segments_.front();
+        size_t requested = 0;
+        ssize_t n;
+
+        if (front.kind == Segment::FILE) {
+            requested = front.size < kMaxSendfileChunk ? front.size : kMaxSendfileChunk;
+            off_t offset = front.file_offset;
+            n = ::sendfile(fd, front.fd, &offset, requested);
+        } else {
+            // 聚合连续的内存段
+            struct iovec vec[kMaxIovecs];
+            int count = 0;
+            for (auto it = segments_.begin(); it != segments_.end() && count < kMaxIovecs; ++it) {
+                if (it->kind != Segment::MEMORY) break;
+                vec[count].iov_base = const_cast<char*>(it->data);
+                vec[count].iov_len = it->size;
+                requested += it->size;
+                ++count;
+            }
+            n = ::writev(fd, vec, count);
+        }
+
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            *saved_errno = errno;
+            return -1;
+        }
+        if (n == 0 && front.kind == Segment::FILE) {
+            // 文件比声明的短，丢弃剩余部分避免空转
+            bytes_ -= front.size;
+            segments_.pop_front();
+            continue;
+        }
+        consume(static_cast<size_t>(n));
+        total += n;
+        if (static_cast<size_t>(n) < requested) {
+            break;   // 内核缓冲区已满
+        }
+    }
+    return total;
+}
+
+} // namespace network
+} // namespace edge_infra
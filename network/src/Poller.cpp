@@ -0,0 +1,140 @@
+#include "network/Poller.h"
+#include "network/Channel.h"
+#include "network/EventLoop.h"
+#include "network/IoUringPoller.h"
+#include "network/NetworkDebug.h"
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+// Channel::index() 在Poller中的含义
+const int kNew = -1;
+const int kAdded = 1;
+const int kDeleted = 2;
+
+} // namespace
+
+Poller::Poller(EventLoop* loop)
+    : owner_loop_(loop) {
+}
+
+Poller::~Poller() = default;
+
+bool Poller::hasChannel(Channel* channel) const {
+    assertInLoopThread();
+    auto it = channels_.find(channel->fd());
+    return it != channels_.end() && it->second == channel;
+}
+
+void Poller::assertInLoopThread() const {
+    owner_loop_->assertInLoopThread();
+}
+
+Poller* Poller::newDefaultPoller(EventLoop* loop) {
+    return newPoller(loop, EventLoop::kDefaultPoller);
+}
+
+Poller* Poller::newPoller(EventLoop* loop, EventLoop::PollerType type) {
+    if (type == EventLoop::kDefaultPoller) {
+        const char* env = ::getenv("EDGE_NETWORK_POLLER");
+        const bool io_uring = env != nullptr && (std::strcmp(env, "io_uring") == 0 || std::strcmp(env, "iouring") == 0);
+        type = io_uring ? EventLoop::kIoUringPoller : EventLoop::kEpollPoller;
+    }
+
+    if (type == EventLoop::kIoUringPoller) {
+        std::unique_ptr<IoUringPoller> poller(new IoUringPoller(loop));
+        if (poller->valid()) {
+            return poller.release();
+        }
+        NETWORK_ERROR_LOG("Poller", "io_uring unavailable, falling back to epoll");
+    }
+    return new EPollPoller(loop);
+}
+
+EPollPoller::EPollPoller(EventLoop* loop)
+    : Poller(loop),
+      epollfd_(::epoll_create1(EPOLL_CLOEXEC)),
+      events_(kInitEventListSize) {
+    if (epollfd_ < 0) {
+        NETWORK_LOG_ERROR(-1, errno, "epoll_create1");
+    }
+}
+
+EPollPoller::~EPollPoller() {
+    ::close(epollfd_);
+}
+
+int EPollPoller::poll(int timeout_ms, ChannelList* active_channels) {
+    int num_events = ::epoll_wait(epollfd_, events_.data(),
+                                  static_cast<int>(events_.size()), timeout_ms);
+    int saved_errno = errno;
+    if (num_events > 0) {
+        fillActiveChannels(num_events, active_channels);
+        if (static_cast<size_t>(num_events) == events_.size()) {
+            events_.resize(events_.size() * 2);
+        }
+    } else if (num_events < 0 && saved_errno != EINTR) {
+        NETWORK_LOG_ERROR(epollfd_, saved_errno, "epoll_wait");
+    }
+    return num_events > 0 ? num_events : 0;
+}
+
+void EPollPoller::fillActiveChannels(int num_events, ChannelList* active_channels) const {
+    for (int i = 0; i < num_events; ++i) {
+        Channel* channel = static_cast<Channel*>(events_[i].data.ptr);
+        channel->set_revents(events_[i].events);
+        active_channels->push_back(channel);
+    }
+}
+
+void EPollPoller::updateChannel(Channel* channel) {
+    assertInLoopThread();
+    const int index = channel->index();
+    const int fd = channel->fd();
+
+    if (index == kNew || index == kDeleted) {
+        if (index == kNew) {
+            channels_[fd] = channel;
+        }
+        channel->set_index(kAdded);
+        update(EPOLL_CTL_ADD, channel);
+    } else {
+        if (channel->isNoneEvent()) {
+            update(EPOLL_CTL_DEL, channel);
+            channel->set_index(kDeleted);
+        } else {
+            update(EPOLL_CTL_MOD, channel);
+        }
+    }
+}
+
+void EPollPoller::removeChannel(Channel* channel) {
+    assertInLoopThread();
+    const int index = channel->index();
+    channels_.erase(channel->fd());
+
+    if (index == kAdded) {
+        update(EPOLL_CTL_DEL, channel);
+    }
+    channel->set_index(kNew);
+}
+
+void EPollPoller::update(int operation, Channel* channel) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = channel->events();
+    event.data.ptr = channel;
+    if (::epoll_ctl(epollfd_, operation, channel->fd(), &event) < 0) {
+        NETWORK_LOG_ERROR(channel->fd(), errno, "epoll_ctl op=" + std::to_string(operation));
+    }
+}
+
+} // namespace network
+} // namespace edge_infra
@@ -0,0 +1,207 @@
+#include "network/Socket.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+bool fillAddress(const std::string& ip, int port, sockaddr_in* addr) {
+    std::memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(static_cast<uint16_t>(port));
+    if (ip.empty() || ip == "0.0.0.0") {
+        addr->sin_addr.s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+    return ::inet_pton(AF_INET, ip.c_str(), &addr->sin_addr) == 1;
+}
+
+std::string addressToString(const sockaddr_in& addr) {
+    char buf[INET_ADDRSTRLEN] = {0};
+    ::inet_ntop(AF_INET, &addr.sin_addr, buf, sizeof(buf));
+    return buf;
+}
+
+} // namespace
+
+Socket::Socket() : sockfd_(-1), is_connected_(false) {
+}
+
+Socket::Socket(int sockfd) : sockfd_(sockfd), is_connected_(sockfd >= 0) {
+}
+
+Socket::~Socket() {
+    close();
+}
+
+Socket::Socket(Socket&& other) noexcept
+    : sockfd_(other.sockfd_), is_connected_(other.is_connected_) {
+    other.reset();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+        close();
+        sockfd_ = other.sockfd_;
+        is_connected_ = other.is_connected_;
+        other.reset();
+    }
+    return *this;
+}
+
+bool Socket::create() {
+    close();
+    sockfd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    return sockfd_ >= 0;
+}
+
+bool Socket::bind(const std::string& ip, int port) {
+    sockaddr_in addr;
+    if (!fillAddress(ip, port, &addr)) {
+        errno = EINVAL;
+        return false;
+    }
+    return ::bind(sockfd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+}
+
+bool Socket::listen(int backlog) {
+    return ::listen(sockfd_, backlog) == 0;
+}
+
+Socket Socket::accept() {
+    sockaddr_in peer;
+    socklen_t len = sizeof(peer);
+    int connfd = ::accept4(sockfd_, reinterpret_cast<sockaddr*>(&peer), &len, SOCK_CLOEXEC);
+    return Socket(connfd);
+}
+
+bool Socket::connect(const std::string& ip, int port) {
+    sockaddr_in addr;
+    if (!fillAddress(ip, port, &addr)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (::connect(sockfd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        return false;
+    }
+    is_connected_ = true;
+    return true;
+}
+
+void Socket::close() {
+    if (sockfd_ >= 0) {
+        ::close(sockfd_);
+    }
+    reset();
+}
+
+ssize_t Socket::send(const void* data, size_t len) {
+    return ::send(sockfd_, data, len, MSG_NOSIGNAL);
+}
+
+ssize_t Socket::recv(void* buffer, size_t len) {
+    return ::recv(sockfd_, buffer, len, 0);
+}
+
+ssize_t Socket::sendTo(const void* data, size_t len, const sockaddr_in& addr) {
+    return ::sendto(sockfd_, data, len, MSG_NOSIGNAL, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+}
+
+ssize_t Socket::recvFrom(void* buffer, size_t len, sockaddr_in& addr) {
+    socklen_t addr_len = sizeof(addr);
+    return ::recvfrom(sockfd_, buffer, len, 0, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+}
+
+bool Socket::setReuseAddr(bool enable) {
+    int opt = enable ? 1 : 0;
+    return setSocketOption(SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+}
+
+bool Socket::setReusePort(bool enable) {
+    int opt = enable ? 1 : 0;
+    return setSocketOption(SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+}
+
+bool Socket::setNonBlocking(bool enable) {
+    int flags = ::fcntl(sockfd_, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return ::fcntl(sockfd_, F_SETFL, flags) == 0;
+}
+
+bool Socket::setKeepAlive(bool enable) {
+    int opt = enable ? 1 : 0;
+    return setSocketOption(SOL_SOCKET, SO_KEEPALIVE, &opt, sizeof(opt));
+}
+
+bool Socket::setNoDelay(bool enable) {
+    int opt = enable ? 1 : 0;
+    return setSocketOption(IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+}
+
+std::string Socket::getLocalAddress() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (::getsockname(sockfd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return "";
+    }
+    return addressToString(addr);
+}
+
+int Socket::getLocalPort() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (::getsockname(sockfd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return -1;
+    }
+    return ntohs(addr.sin_port);
+}
+
+std::string Socket::getPeerAddress() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (::getpeername(sockfd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return "";
+    }
+    return addressToString(addr);
+}
+
+int Socket::getPeerPort() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (::getpeername(sockfd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return -1;
+    }
+    return ntohs(addr.sin_port);
+}
+
+int Socket::getLastError() const {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (::getsockopt(sockfd_, SOL_SOCKET, SO_ERROR, &error, &len) != 0) {
+        return errno;
+    }
+    return error;
+}
+
+std::string Socket::getErrorString(int error_code) const {
+    return std::strerror(error_code);
+}
+
+void Socket::reset() {
+    sockfd_ = -1;
+    is_connected_ = false;
+}
+
+bool Socket::setSocketOption(int level, int optname, const void* optval, socklen_t optlen) {
+    return ::setsockopt(sockfd_, level, optname, optval, optlen) == 0;
+}
+
+} // namespace network
+} // namespace edge_infra
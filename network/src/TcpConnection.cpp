@@ -0,0 +1,429 @@
+#include "network/TcpConnection.h"
+#include "network/EventLoop.h"
+#include "network/Channel.h"
+#include "network/NetworkDebug.h"
+#include <cerrno>
+#include <unistd.h>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+const size_t kDefaultHighWaterMark = 64 * 1024 * 1024;
+
+} // namespace
+
+TcpConnection::TcpConnection(EventLoop* loop, const std::string& name, int sockfd,
+                             const InetAddress& local_addr, const InetAddress& peer_addr, ConnectionId id)
+    : loop_(loop),
+      name_(name),
+      id_(id),
+      state_(kConnecting),
+      socket_(new Socket(sockfd)),
+      channel_(new Channel(loop, sockfd)),
+      local_addr_(local_addr),
+      peer_addr_(peer_addr),
+      high_water_mark_(kDefaultHighWaterMark),
+      low_water_mark_(kDefaultHighWaterMark / 2),
+      pause_reading_on_high_water_(false),
+      reading_wanted_(true),
+      reading_paused_(false),
+      reading_(false),
+      above_high_water_(false),
+      output_bytes_(0),
+      bytes_sent_(0),
+      bytes_received_(0) {
+    channel_->setDebugName(name_);
+    channel_->setReadCallback(std::bind(&TcpConnection::handleRead, this));
+    channel_->setWriteCallback(std::bind(&TcpConnection::handleWrite, this));
+    channel_->setCloseCallback(std::bind(&TcpConnection::handleClose, this));
+    channel_->setErrorCallback(std::bind(&TcpConnection::handleError, this));
+    socket_->setKeepAlive(true);
+
+    NETWORK_DEBUG_LOG("TcpConnection", name_ + " created fd=" + std::to_string(sockfd));
+}
+
+TcpConnection::~TcpConnection() {
+    NETWORK_DEBUG_LOG("TcpConnection", name_ + " destroyed state=" + stateToString());
+}
+
+void TcpConnection::connectEstablished() {
+    loop_->assertInLoopThread();
+    setState(kConnected);
+    connect_time_ = std::chrono::steady_clock::now();
+    updateReading();
+
+    if (connection_callback_) {
+        connection_callback_(shared_from_this());
+    }
+}
+
+void TcpConnection::connectDestroyed() {
+    loop_->assertInLoopThread();
+    if (state_ == kConnected || state_ == kDisconnecting) {
+        setState(kDisconnected);
+        channel_->disableAll();
+        reading_.store(false, std::memory_order_release);
+        if (connection_callback_) {
+            connection_callback_(shared_from_this());
+        }
+    }
+    channel_->remove();
+}
+
+void TcpConnection::shutdown() {
+    if (state_ == kConnected) {
+        setState(kDisconnecting);
+        TcpConnectionPtr self(shared_from_this());
+        loop_->runInLoop([self] { self->shutdownInLoop(); });
+    }
+}
+
+void TcpConnection::forceClose() {
+    if (state_ == kConnected || state_ == kDisconnecting) {
+        setState(kDisconnecting);
+        TcpConnectionPtr self(shared_from_this());
+        loop_->queueInLoop([self] { self->forceCloseInLoop(); });
+    }
+}
+
+void TcpConnection::send(const std::string& message) {
+    if (state_ != kConnected) return;
+
+    if (loop_->isInLoopThread()) {
+        sendInLoop(message);
+    } else {
+        TcpConnectionPtr self(shared_from_this());
+        loop_->runInLoop([self, message] { self->sendInLoop(message); });
+    }
+}
+
+void TcpConnection::send(const void* data, size_t len) {
+    if (state_ != kConnected) return;
+
+    if (loop_->isInLoopThread()) {
+        sendInLoop(data, len);
+    } else {
+        send(std::string(static_cast<const char*>(data), len));
+    }
+}
+
+void TcpConnection::send(Buffer* buf) {
+    if (state_ != kConnected) return;
+
+    if (loop_->isInLoopThread()) {
+        sendInLoop(buf->peek(), buf->readableBytes());
+        buf->retrieveAll();
+    } else {
+        send(buf->retrieveAllAsString());
+    }
+}
+
+void TcpConnection::send(std::string&& message) {
+    if (state_ != kConnected) return;
+
+    OutputQueue segments;
+    segments.append(std::move(message));
+    send(std::move(segments));
+}
+
+void TcpConnection::send(std::shared_ptr<const std::string> block) {
+    if (state_ != kConnected) return;
+
+    OutputQueue segments;
+    segments.append(std::move(block));
+    send(std::move(segments));
+}
+
+void TcpConnection::send(OutputQueue&& segments) {
+    if (state_ != kConnected) return;
+
+    if (loop_->isInLoopThread()) {
+        sendInLoop(segments);
+    } else {
+        // std::function要求可拷贝，经shared_ptr中转
+        auto pending = std::make_shared<OutputQueue>(std::move(segments));
+        TcpConnectionPtr self(shared_from_this());
+        loop_->runInLoop([self, pending] { self->sendInLoop(*pending); });
+    }
+}
+
+void TcpConnection::sendFile(int fd, off_t offset, size_t len, bool close_when_done) {
+    OutputQueue segments;
+    segments.appendFile(fd, offset, len, close_when_done);
+    if (state_ != kConnected) return;   // segments析构时按需关闭fd
+    send(std::move(segments));
+}
+
+void TcpConnection::setWriteWatermarks(size_t high, size_t low) {
+    high_water_mark_ = high > 0 ? high : kDefaultHighWaterMark;
+    low_water_mark_ = (low > 0 && low < high_water_mark_) ? low : high_water_mark_ / 2;
+}
+
+void TcpConnection::startRead() {
+    TcpConnectionPtr self(shared_from_this());
+    loop_->runInLoop([self] {
+        self->reading_wanted_ = true;
+        self->updateReading();
+    });
+}
+
+void TcpConnection::stopRead() {
+    TcpConnectionPtr self(shared_from_this());
+    loop_->runInLoop([self] {
+        self->reading_wanted_ = false;
+        self->updateReading();
+    });
+}
+
+void TcpConnection::updateReading() {
+    loop_->assertInLoopThread();
+    if (state_ != kConnected && state_ != kDisconnecting) return;
+    const bool should_read = reading_wanted_ && !reading_paused_;
+    if (should_read && !channel_->isReading()) {
+        channel_->enableReading();
+    } else if (!should_read && channel_->isReading()) {
+        channel_->disableReading();
+    }
+    reading_.store(channel_->isReading(), std::memory_order_release);
+}
+
+void TcpConnection::updateBackpressure() {
+    const size_t buffered = output_queue_.readableBytes();
+    output_bytes_.store(buffered, std::memory_order_relaxed);
+
+    if (!above_high_water_.load(std::memory_order_relaxed)) {
+        if (buffered < high_water_mark_) return;
+        above_high_water_.store(true);
+        if (pause_reading_on_high_water_) {
+            reading_paused_ = true;
+            updateReading();
+        }
+        if (high_water_mark_callback_) {
+            TcpConnectionPtr self(shared_from_this());
+            loop_->queueInLoop([self, buffered] { self->high_water_mark_callback_(self, buffered); });
+        }
+    } else if (buffered <= low_water_mark_) {
+        above_high_water_.store(false);
+        if (reading_paused_) {
+            reading_paused_ = false;
+            updateReading();
+        }
+        if (low_water_mark_callback_) {
+            TcpConnectionPtr self(shared_from_this());
+            loop_->queueInLoop([self, buffered] { self->low_water_mark_callback_(self, buffered); });
+        }
+    }
+}
+
+std::chrono::steady_clock::duration TcpConnection::getConnectDuration() const {
+    return std::chrono::steady_clock::now() - connect_time_;
+}
+
+std::string TcpConnection::stateToString() const {
+    return stateToString(state_.load());
+}
+
+void TcpConnection::enableTcpNoDelay(bool on) {
+    socket_->setNoDelay(on);
+}
+
+void TcpConnection::enableKeepAlive(bool on) {
+    socket_->setKeepAlive(on);
+}
+
+void TcpConnection::handleRead() {
+    loop_->assertInLoopThread();
+
+    int saved_errno = 0;
+    ssize_t n = input_buffer_.readFd(channel_->fd(), &saved_errno);
+    if (n > 0) {
+        bytes_received_ += n;
+        NetworkDebug::recordBytesReceived(n);
+        NETWORK_LOG_PACKET(channel_->fd(), "recv", n, "");
+
+        if (buffer_message_callback_) {
+            buffer_message_callback_(shared_from_this(), &input_buffer_);
+        } else if (message_callback_) {
+            message_callback_(shared_from_this(), input_buffer_.retrieveAllAsString());
+        } else {
+            input_buffer_.retrieveAll();
+        }
+    } else if (n == 0) {
+        handleClose();
+    } else {
+        errno = saved_errno;
+        NETWORK_LOG_ERROR(channel_->fd(), saved_errno, "read");
+        handleError();
+    }
+}
+
+void TcpConnection::handleWrite() {
+    loop_->assertInLoopThread();
+    if (!channel_->isWriting()) {
+        NETWORK_DEBUG_LOG("TcpConnection", name_ + " is down, no more writing");
+        return;
+    }
+
+    if (!writeOutputQueue()) {
+        // 对端已断开(EPIPE/ECONNRESET)，剩余数据无法再发出，直接关闭连接
+        NETWORK_DEBUG_LOG("TcpConnection", name_ + " peer reset, dropping " +
+                          std::to_string(output_queue_.readableBytes()) + " pending bytes");
+        output_queue_.clear();
+        updateBackpressure();
+        handleError();
+        handleClose();
+        return;
+    }
+    updateBackpressure();
+    if (output_queue_.empty()) {
+        channel_->disableWriting();
+        if (write_complete_callback_) {
+            TcpConnectionPtr self(shared_from_this());
+            loop_->queueInLoop([self] { self->write_complete_callback_(self); });
+        }
+        if (state_ == kDisconnecting) {
+            shutdownInLoop();
+        }
+    }
+}
+
+bool TcpConnection::writeOutputQueue() {
+    int saved_errno = 0;
+    ssize_t n = output_queue_.writeTo(channel_->fd(), &saved_errno);
+    if (n > 0) {
+        bytes_sent_ += n;
+        NetworkDebug::recordBytesSent(n);
+        NETWORK_LOG_PACKET(channel_->fd(), "send", n, "");
+    } else if (n < 0) {
+        NETWORK_LOG_ERROR(channel_->fd(), saved_errno, "write");
+        return saved_errno != EPIPE && saved_errno != ECONNRESET;
+    }
+    return true;
+}
+
+void TcpConnection::handleClose() {
+    loop_->assertInLoopThread();
+    NETWORK_DEBUG_LOG("TcpConnection", name_ + " closing, state=" + stateToString());
+
+    setState(kDisconnected);
+    channel_->disableAll();
+    reading_.store(false, std::memory_order_release);
+
+    TcpConnectionPtr guard(shared_from_this());
+    if (connection_callback_) {
+        connection_callback_(guard);
+    }
+    if (close_callback_) {
+        close_callback_(guard);
+    }
+}
+
+void TcpConnection::handleError() {
+    int error = socket_->getLastError();
+    NETWORK_LOG_ERROR(channel_->fd(), error, name_ + " " + socket_->getErrorString(error));
+}
+
+void TcpConnection::sendInLoop(const std::string& message) {
+    sendInLoop(message.data(), message.size());
+}
+
+void TcpConnection::sendInLoop(const void* data, size_t len) {
+    loop_->assertInLoopThread();
+    if (state_ == kDisconnected) {
+        NETWORK_DEBUG_LOG("TcpConnection", name_ + " disconnected, give up writing");
+        return;
+    }
+
+    ssize_t nwrote = 0;
+    size_t remaining = len;
+    bool fault_error = false;
+
+    // 输出缓冲区为空时先尝试直接写，避免一次拷贝
+    if (!channel_->isWriting() && output_queue_.empty()) {
+        nwrote = ::write(channel_->fd(), data, len);
+        if (nwrote >= 0) {
+            remaining = len - nwrote;
+            bytes_sent_ += nwrote;
+            NetworkDebug::recordBytesSent(nwrote);
+            if (remaining == 0 && write_complete_callback_) {
+                TcpConnectionPtr self(shared_from_this());
+                loop_->queueInLoop([self] { self->write_complete_callback_(self); });
+            }
+        } else {
+            nwrote = 0;
+            if (errno != EWOULDBLOCK && errno != EAGAIN) {
+                NETWORK_LOG_ERROR(channel_->fd(), errno, "write");
+                if (errno == EPIPE || errno == ECONNRESET) {
+                    fault_error = true;
+                }
+            }
+        }
+    }
+
+    if (!fault_error && remaining > 0) {
+        output_queue_.append(static_cast<const char*>(data) + nwrote, remaining);
+        if (!channel_->isWriting()) {
+            channel_->enableWriting();
+        }
+        updateBackpressure();
+    }
+}
+
+void TcpConnection::sendInLoop(OutputQueue& segments) {
+    loop_->assertInLoopThread();
+    if (state_ == kDisconnected) {
+        NETWORK_DEBUG_LOG("TcpConnection", name_ + " disconnected, give up writing");
+        segments.clear();
+        return;
+    }
+    if (segments.empty()) return;
+
+    output_queue_.append(std::move(segments));
+    if (channel_->isWriting()) {
+        // 已有数据在等待可写，由handleWrite按顺序继续发送
+        updateBackpressure();
+        return;
+    }
+
+    // 此前输出队列为空，直接writev/sendfile一次
+    if (!writeOutputQueue()) {
+        output_queue_.clear();
+    } else if (output_queue_.empty()) {
+        if (write_complete_callback_) {
+            TcpConnectionPtr self(shared_from_this());
+            loop_->queueInLoop([self] { self->write_complete_callback_(self); });
+        }
+    } else {
+        channel_->enableWriting();
+    }
+    updateBackpressure();
+}
+
+void TcpConnection::shutdownInLoop() {
+    loop_->assertInLoopThread();
+    if (!channel_->isWriting()) {
+        ::shutdown(socket_->getFd(), SHUT_WR);
+    }
+}
+
+void TcpConnection::forceCloseInLoop() {
+    loop_->assertInLoopThread();
+    if (state_ == kConnected || state_ == kDisconnecting) {
+        handleClose();
+    }
+}
+
+std::string TcpConnection::stateToString(State state) const {
+    switch (state) {
+        case kDisconnected: return "kDisconnected";
+        case kConnecting: return "kConnecting";
+        case kConnected: return "kConnected";
+        case kDisconnecting: return "kDisconnecting";
+        default: return "unknown state";
+    }
+}
+
+} // namespace network
+} // namespace edge_infra
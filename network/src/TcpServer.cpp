@@ -0,0 +1,314 @@
+#include "network/TcpServer.h"
+#include "network/TcpConnection.h"
+#include "network/Acceptor.h"
+#include "network/NetworkDebug.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <future>
+
+namespace edge_infra {
+namespace network {
+
+namespace {
+
+InetAddress getLocalAddr(int sockfd) {
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    socklen_t len = sizeof(local);
+    if (::getsockname(sockfd, reinterpret_cast<sockaddr*>(&local), &len) < 0) {
+        NETWORK_LOG_ERROR(sockfd, errno, "getsockname");
+    }
+    return InetAddress(local);
+}
+
+} // namespace
+
+const int TcpServer::kShardIdBits;
+
+TcpServer::TcpServer(EventLoop* loop, const InetAddress& listen_addr, const std::string& name)
+    : loop_(loop),
+      name_(name),
+      ip_port_(listen_addr.toString()),
+      listen_addr_(listen_addr),
+      acceptor_(new Acceptor(loop, listen_addr)),
+      reuse_port_(false),
+      thread_pool_(std::make_shared<EventLoopThreadPool>(loop, name)),
+      high_water_mark_(0),
+      low_water_mark_(0),
+      pause_reading_on_high_water_(false),
+      next_conn_id_(1),
+      started_(false),
+      total_connections_(0),
+      active_connections_(0) {
+    acceptor_->setNewConnectionCallback(
+        [this](int sockfd, const InetAddress& peer_addr) { newConnection(sockfd, peer_addr); });
+}
+
+TcpServer::~TcpServer() {
+    loop_->assertInLoopThread();
+    NETWORK_DEBUG_LOG("TcpServer", name_ + " destructing");
+
+    // 监听socket必须在各自loop中注销；等待完成，避免析构后仍有accept回调
+    for (auto& acceptor : loop_acceptors_) {
+        Acceptor* raw = acceptor.release();
+        std::promise<void> done;
+        std::future<void> finished = done.get_future();
+        raw->getLoop()->runInLoop([raw, &done] {
+            delete raw;
+            done.set_value();
+        });
+        finished.wait();
+    }
+
+    for (auto& shard : shards_) {
+        std::unordered_map<ConnectionId, TcpConnectionPtr> connections;
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            connections.swap(shard->connections);
+        }
+        for (auto& item : connections) {
+            TcpConnectionPtr conn(item.second);
+            conn->getLoop()->runInLoop([conn] { conn->connectDestroyed(); });
+        }
+    }
+}
+
+void TcpServer::setThreadNum(int num_threads) {
+    if (num_threads < 0) num_threads = 0;
+    thread_pool_->setThreadNum(num_threads);
+}
+
+void TcpServer::setLoadBalanceStrategy(EventLoopThreadPool::LoadBalanceStrategy strategy) {
+    thread_pool_->setLoadBalanceStrategy(strategy);
+}
+
+void TcpServer::setCpuAffinity(bool enable, const std::vector<int>& cpus) {
+    thread_pool_->setCpuAffinity(enable, cpus);
+}
+
+void TcpServer::start() {
+    if (started_) return;
+    started_ = true;
+
+    loop_->runInLoop([this] {
+        thread_pool_->start(thread_init_callback_);
+        for (EventLoop* io_loop : thread_pool_->getAllLoops()) {
+            shards_.emplace_back(new ConnectionShard(io_loop));
+        }
+        if (reuse_port_ && thread_pool_->threadNum() > 0) {
+            startLoopAcceptors();
+        } else {
+            acceptor_->listen();
+        }
+        NETWORK_DEBUG_LOG("TcpServer", name_ + " listening on " + ip_port_);
+    });
+}
+
+void TcpServer::stop() {
+    loop_->runInLoop([this] {
+        started_ = false;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto& item : shard->connections) {
+                item.second->forceClose();
+            }
+        }
+        NETWORK_DEBUG_LOG("TcpServer", name_ + " stopped");
+    });
+}
+
+void TcpServer::startLoopAcceptors() {
+    loop_->assertInLoopThread();
+    // 构造时绑定的监听socket没有SO_REUSEPORT，先释放端口
+    acceptor_.reset();
+
+    for (EventLoop* io_loop : thread_pool_->getAllLoops()) {
+        std::unique_ptr<Acceptor> acceptor(new Acceptor(io_loop, listen_addr_, true));
+        acceptor->setNewConnectionCallback([this, io_loop](int sockfd, const InetAddress& peer_addr) {
+            newConnectionInLoop(sockfd, peer_addr, io_loop);
+        });
+        Acceptor* raw = acceptor.get();
+        loop_acceptors_.push_back(std::move(acceptor));
+        io_loop->runInLoop([raw] { raw->listen(); });
+    }
+}
+
+void TcpServer::newConnection(int sockfd, const InetAddress& peer_addr) {
+    loop_->assertInLoopThread();
+
+    EventLoop* io_loop = thread_pool_->getNextLoop();
+    TcpConnectionPtr conn = createConnection(sockfd, peer_addr, io_loop);
+
+    // 跨线程交给sub loop登记并完成连接建立
+    io_loop->runInLoop([this, conn] {
+        addConnectionInLoop(conn);
+        conn->connectEstablished();
+    });
+}
+
+void TcpServer::newConnectionInLoop(int sockfd, const InetAddress& peer_addr, EventLoop* io_loop) {
+    io_loop->assertInLoopThread();
+
+    TcpConnectionPtr conn = createConnection(sockfd, peer_addr, io_loop);
+    addConnectionInLoop(conn);
+    conn->connectEstablished();
+}
+
+TcpConnectionPtr TcpServer::createConnection(int sockfd, const InetAddress& peer_addr, EventLoop* io_loop) {
+    size_t shard_index = 0;
+    while (shard_index + 1 < shards_.size() && shards_[shard_index]->loop != io_loop) {
+        ++shard_index;
+    }
+    const ConnectionId id = (next_conn_id_++ << kShardIdBits) | shard_index;
+    std::string conn_name = generateConnectionName(id);
+    InetAddress local_addr = getLocalAddr(sockfd);
+
+    NETWORK_LOG_CONNECTION(sockfd, local_addr.toString(), peer_addr.toString(), "accepted as " + conn_name);
+
+    TcpConnectionPtr conn = std::make_shared<TcpConnection>(io_loop, conn_name, sockfd,
+                                                            local_addr, peer_addr, id);
+    thread_pool_->addLoad(io_loop, 1);
+    total_connections_++;
+    active_connections_++;
+    NetworkDebug::recordConnectionCreated();
+
+    conn->setConnectionCallback(connection_callback_);
+    conn->setMessageCallback(message_callback_);
+    conn->setBufferMessageCallback(buffer_message_callback_);
+    conn->setCloseCallback([this](const TcpConnectionPtr& c) { removeConnection(c); });
+    conn->setHighWaterMarkCallback(high_water_mark_callback_);
+    conn->setLowWaterMarkCallback(low_water_mark_callback_);
+    conn->setWriteCompleteCallback(write_complete_callback_);
+    if (high_water_mark_ > 0) {
+        conn->setWriteWatermarks(high_water_mark_, low_water_mark_);
+    }
+    conn->setPauseReadingOnHighWater(pause_reading_on_high_water_);
+    return conn;
+}
+
+void TcpServer::addConnectionInLoop(const TcpConnectionPtr& conn) {
+    conn->getLoop()->assertInLoopThread();
+    ConnectionShard* shard = shardOf(conn->getId());
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->connections[conn->getId()] = conn;
+}
+
+void TcpServer::removeConnection(const TcpConnectionPtr& conn) {
+    // 连接关闭回调本身就在所属IO线程，直接修改该loop的分片
+    conn->getLoop()->runInLoop([this, conn] { removeConnectionInLoop(conn); });
+}
+
+void TcpServer::removeConnectionInLoop(const TcpConnectionPtr& conn) {
+    conn->getLoop()->assertInLoopThread();
+
+    ConnectionShard* shard = shardOf(conn->getId());
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        if (shard->connections.erase(conn->getId()) == 0) {
+            return;
+        }
+    }
+    thread_pool_->addLoad(conn->getLoop(), -1);
+    active_connections_--;
+    NetworkDebug::recordConnectionClosed();
+    NETWORK_DEBUG_LOG("TcpServer", name_ + " remove connection " + conn->name());
+
+    if (close_callback_) {
+        close_callback_(conn);
+    }
+
+    conn->getLoop()->queueInLoop([conn] { conn->connectDestroyed(); });
+}
+
+TcpServer::ConnectionShard* TcpServer::shardOf(ConnectionId id) const {
+    const size_t index = id & ((1u << kShardIdBits) - 1);
+    return index < shards_.size() ? shards_[index].get() : nullptr;
+}
+
+TcpConnectionPtr TcpServer::getConnection(ConnectionId id) const {
+    ConnectionShard* shard = shardOf(id);
+    if (shard == nullptr) return TcpConnectionPtr();
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    auto it = shard->connections.find(id);
+    return it != shard->connections.end() ? it->second : TcpConnectionPtr();
+}
+
+void TcpServer::broadcastMessage(const std::string& message) {
+    broadcastMessage(std::make_shared<const std::string>(message));
+}
+
+void TcpServer::broadcastMessage(std::shared_ptr<const std::string> payload) {
+    for (const auto& item : shards_) {
+        ConnectionShard* shard = item.get();
+        shard->loop->queueInLoop([shard, payload] {
+            // 在本loop内发送不会同步触发连接移除，可以持锁遍历
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (const auto& entry : shard->connections) {
+                entry.second->send(payload);
+            }
+        });
+    }
+}
+
+void TcpServer::sendToConnection(ConnectionId id, const std::string& message) {
+    ConnectionShard* shard = shardOf(id);
+    if (shard == nullptr) {
+        NETWORK_DEBUG_LOG("TcpServer", "sendToConnection: unknown connection id " + std::to_string(id));
+        return;
+    }
+    shard->loop->runInLoop([this, id, message] {
+        TcpConnectionPtr conn = getConnection(id);
+        if (conn) {
+            conn->send(message);
+        } else {
+            NETWORK_DEBUG_LOG("TcpServer", "sendToConnection: unknown connection id " + std::to_string(id));
+        }
+    });
+}
+
+void TcpServer::sendToConnection(const std::string& conn_name, const std::string& message) {
+    const size_t pos = conn_name.rfind('#');
+    ConnectionId id = 0;
+    if (pos != std::string::npos && pos + 1 < conn_name.size()) {
+        id = std::strtoull(conn_name.c_str() + pos + 1, nullptr, 10);
+    }
+    sendToConnection(id, message);
+}
+
+void TcpServer::printConnections() const {
+    std::cout << "=== TcpServer [" << name_ << "] Connections ===" << std::endl;
+    std::cout << "Listen: " << ip_port_ << std::endl;
+    std::cout << "Active: " << active_connections_.load()
+              << " Total: " << total_connections_.load() << std::endl;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (const auto& item : shard->connections) {
+            std::cout << "  " << item.second->name() << " peer=" << item.second->peerAddressString()
+                      << " state=" << item.second->stateToString() << std::endl;
+        }
+    }
+    if (thread_pool_->started()) {
+        thread_pool_->printStatistics();
+    }
+}
+
+std::vector<std::string> TcpServer::getConnectionNames() const {
+    std::vector<std::string> names;
+    names.reserve(active_connections_.load());
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (const auto& item : shard->connections) {
+            names.push_back(item.second->name());
+        }
+    }
+    return names;
+}
+
+std::string TcpServer::generateConnectionName(ConnectionId id) const {
+    return name_ + "-" + ip_port_ + "#" + std::to_string(id);
+}
+
+} // namespace network
+} // namespace edge_infra
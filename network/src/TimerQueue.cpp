@@ -0,0 +1,291 @@
+#include "network/TimerQueue.h"
+#include "network/EventLoop.h"
+#include "network/Channel.h"
+#include "network/NetworkDebug.h"
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+namespace edge_infra {
+namespace network {
+
+std::atomic<int64_t> Timer::s_num_created_{0};
+
+const int64_t TimerQueue::kTickUs;
+
+namespace {
+
+int createTimerfd() {
+    int timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerfd < 0) {
+        NETWORK_LOG_ERROR(-1, errno, "timerfd_create");
+    }
+    return timerfd;
+}
+
+} // namespace
+
+TimerQueue::TimerQueue(EventLoop* loop)
+    : loop_(loop),
+      timerfd_(createTimerfd()),
+      timerfd_channel_(new Channel(loop, timerfd_)),
+      base_time_us_(nowMicros()),
+      current_tick_(0),
+      armed_tick_(-1) {
+    std::memset(tv1_, 0, sizeof(tv1_));
+    std::memset(tvn_, 0, sizeof(tvn_));
+
+    timerfd_channel_->setDebugName("TimerQueue");
+    timerfd_channel_->setReadCallback(std::bind(&TimerQueue::handleRead, this));
+    timerfd_channel_->enableReading();
+}
+
+TimerQueue::~TimerQueue() {
+    timerfd_channel_->disableAll();
+    timerfd_channel_->remove();
+    ::close(timerfd_);
+}
+
+int64_t TimerQueue::nowMicros() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+TimerId TimerQueue::addTimer(TimerCallback cb, int64_t when_us, int64_t interval_us) {
+    Timer* timer = new Timer(std::move(cb), when_us, interval_us);
+    TimerId timer_id(timer->sequence());
+    loop_->runInLoop([this, timer] { addTimerInLoop(timer); });
+    return timer_id;
+}
+
+void TimerQueue::cancel(TimerId timer_id) {
+    loop_->runInLoop([this, timer_id] { cancelInLoop(timer_id); });
+}
+
+void TimerQueue::addTimerInLoop(Timer* timer) {
+    loop_->assertInLoopThread();
+    if (timers_.size() == expired_.size()) {
+        // 时间轮为空，先把current_tick_推进到当前时刻，避免空闲后逐tick追赶
+        const int64_t now_tick = (nowMicros() - base_time_us_) / kTickUs;
+        if (now_tick > current_tick_) {
+            current_tick_ = now_tick;
+        }
+    }
+    timers_.emplace(timer->sequence(), std::unique_ptr<Timer>(timer));
+    internalAdd(timer);
+    resetTimerfd();
+}
+
+void TimerQueue::cancelInLoop(TimerId timer_id) {
+    loop_->assertInLoopThread();
+    auto it = timers_.find(timer_id.sequence());
+    if (it == timers_.end()) {
+        return;
+    }
+
+    Timer* timer = it->second.get();
+    if (timer->slot_ != nullptr) {
+        unlink(timer);
+        timers_.erase(it);
+        resetTimerfd();
+    } else {
+        // 已到期且正在执行回调，由handleRead统一回收，且不再重复调度
+        timer->cancelled_ = true;
+    }
+}
+
+void TimerQueue::handleRead() {
+    loop_->assertInLoopThread();
+
+    uint64_t howmany = 0;
+    ssize_t n = ::read(timerfd_, &howmany, sizeof(howmany));
+    if (n != sizeof(howmany) && errno != EAGAIN) {
+        NETWORK_LOG_ERROR(timerfd_, errno, "read timerfd");
+    }
+    armed_tick_ = -1;
+
+    const int64_t now_tick = (nowMicros() - base_time_us_) / kTickUs;
+    while (current_tick_ <= now_tick) {
+        if (timers_.size() == expired_.size()) {
+            // 时间轮已空，直接跳到当前时刻
+            current_tick_ = now_tick + 1;
+            break;
+        }
+        runTick(&expired_);
+    }
+
+    for (Timer* timer : expired_) {
+        if (!timer->cancelled_) {
+            timer->run();
+        }
+    }
+
+    const int64_t now = nowMicros();
+    for (Timer* timer : expired_) {
+        if (timer->repeat() && !timer->cancelled_) {
+            timer->expiration_ += timer->interval_;
+            if (timer->expiration_ <= now) {
+                // 回调耗时过长或loop被阻塞，不补发错过的周期
+                timer->expiration_ = now + timer->interval_;
+            }
+            internalAdd(timer);
+        } else {
+            timers_.erase(timer->sequence());
+        }
+    }
+    expired_.clear();
+
+    resetTimerfd();
+}
+
+int64_t TimerQueue::toTick(int64_t when_us) const {
+    if (when_us <= base_time_us_) {
+        return 0;
+    }
+    // 向上取整，保证定时器不会提前触发
+    return (when_us - base_time_us_ + kTickUs - 1) / kTickUs;
+}
+
+void TimerQueue::internalAdd(Timer* timer) {
+    int64_t expires = toTick(timer->expiration_);
+    int64_t idx = expires - current_tick_;
+
+    Timer** slot = nullptr;
+    if (idx < 0) {
+        // 已过期，放到下一个待处理的槽位
+        slot = &tv1_[current_tick_ & kTvrMask];
+    } else if (idx < kTvrSize) {
+        slot = &tv1_[expires & kTvrMask];
+    } else {
+        if (idx > kMaxTicks) {
+            // 超出时间轮范围，先放到最远处，级联时会按真实到期时间重新分配
+            expires = current_tick_ + kMaxTicks;
+            idx = kMaxTicks;
+        }
+        int level = 0;
+        while (level < kTvnLevels - 1 && idx >= (1LL << (kTvrBits + (level + 1) * kTvnBits))) {
+            ++level;
+        }
+        slot = &tvn_[level][(expires >> (kTvrBits + level * kTvnBits)) & kTvnMask];
+    }
+    link(slot, timer);
+}
+
+void TimerQueue::link(Timer** slot, Timer* timer) {
+    timer->prev_ = nullptr;
+    timer->next_ = *slot;
+    if (*slot != nullptr) {
+        (*slot)->prev_ = timer;
+    }
+    *slot = timer;
+    timer->slot_ = slot;
+}
+
+void TimerQueue::unlink(Timer* timer) {
+    if (timer->prev_ != nullptr) {
+        timer->prev_->next_ = timer->next_;
+    } else {
+        *timer->slot_ = timer->next_;
+    }
+    if (timer->next_ != nullptr) {
+        timer->next_->prev_ = timer->prev_;
+    }
+    timer->prev_ = nullptr;
+    timer->next_ = nullptr;
+    timer->slot_ = nullptr;
+}
+
+int64_t TimerQueue::cascade(Timer** level, int64_t index) {
+    Timer* list = level[index];
+    level[index] = nullptr;
+    while (list != nullptr) {
+        Timer* next = list->next_;
+        list->prev_ = nullptr;
+        list->next_ = nullptr;
+        list->slot_ = nullptr;
+        internalAdd(list);
+        list = next;
+    }
+    return index;
+}
+
+void TimerQueue::runTick(std::vector<Timer*>* expired) {
+    const int64_t index = current_tick_ & kTvrMask;
+    if (index == 0) {
+        // 第0层转完一圈，从上层依次级联
+        for (int level = 0; level < kTvnLevels; ++level) {
+            int64_t i = (current_tick_ >> (kTvrBits + level * kTvnBits)) & kTvnMask;
+            if (cascade(tvn_[level], i) != 0) {
+                break;
+            }
+        }
+    }
+    ++current_tick_;
+
+    Timer* list = tv1_[index];
+    tv1_[index] = nullptr;
+    while (list != nullptr) {
+        Timer* next = list->next_;
+        list->prev_ = nullptr;
+        list->next_ = nullptr;
+        list->slot_ = nullptr;
+        expired->push_back(list);
+        list = next;
+    }
+}
+
+int64_t TimerQueue::nextPendingTick() const {
+    if (timers_.empty()) {
+        return -1;
+    }
+
+    // 本轮第0层剩余的槽位
+    const int64_t boundary = (current_tick_ | kTvrMask) + 1;
+    for (int64_t tick = current_tick_; tick < boundary; ++tick) {
+        if (tv1_[tick & kTvrMask] != nullptr) {
+            return tick;
+        }
+    }
+
+    // 第0层下一轮的定时器在boundary之后，但boundary处可能有级联进来的更早定时器
+    for (int i = 0; i < kTvrSize; ++i) {
+        if (tv1_[i] != nullptr) {
+            return boundary;
+        }
+    }
+
+    // 第0层为空：找到下一个需要级联的第1层槽位；
+    // 第1层转完一圈时还需级联更高层，保守地在该处唤醒
+    for (int64_t tick = boundary;; tick += kTvrSize) {
+        int64_t idx = (tick >> kTvrBits) & kTvnMask;
+        if (tvn_[0][idx] != nullptr || idx == 0) {
+            return tick;
+        }
+    }
+}
+
+void TimerQueue::resetTimerfd() {
+    const int64_t tick = nextPendingTick();
+    if (tick == armed_tick_) {
+        return;
+    }
+    armed_tick_ = tick;
+
+    struct itimerspec new_value;
+    std::memset(&new_value, 0, sizeof(new_value));
+    if (tick >= 0) {
+        const int64_t when_us = base_time_us_ + tick * kTickUs;
+        new_value.it_value.tv_sec = static_cast<time_t>(when_us / 1000000);
+        new_value.it_value.tv_nsec = static_cast<long>((when_us % 1000000) * 1000);
+    }
+    // 使用绝对时间，到期点已过时timerfd会立即触发
+    if (::timerfd_settime(timerfd_, TFD_TIMER_ABSTIME, &new_value, nullptr) < 0) {
+        NETWORK_LOG_ERROR(timerfd_, errno, "timerfd_settime");
+    }
+}
+
+} // namespace network
+} // namespace edge_infra
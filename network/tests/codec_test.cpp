@@ -0,0 +1,71 @@
+#include "network/Codec.h"
+#include "test_check.h"
+#include <string>
+#include <vector>
+
+using namespace edge_infra::network;
+
+namespace {
+
+void feed(JsonLineCodec& codec, Buffer& buf, const std::string& data) {
+    buf.append(data.data(), data.size());
+    codec.onMessage(TcpConnectionPtr(), &buf);
+}
+
+// 只有空行时也要被丢弃，否则输入缓冲区无限增长
+void testBlankLinesAreConsumed() {
+    std::vector<std::string> received;
+    auto codec = std::make_shared<JsonLineCodec>([&](const TcpConnectionPtr&, std::vector<std::string_view>& frames) {
+        for (auto frame : frames) received.emplace_back(frame);
+    });
+    Buffer buf;
+
+    for (int i = 0; i < 1000; ++i) {
+        feed(*codec, buf, "\n\r\n\n");
+    }
+    EDGE_CHECK(received.empty());
+    EDGE_CHECK(buf.readableBytes() == 0);
+
+    // 空行之后的半行保留到下次读事件
+    feed(*codec, buf, "\n\n{\"a\":");
+    EDGE_CHECK(received.empty());
+    EDGE_CHECK(buf.readableBytes() == 5);
+
+    feed(*codec, buf, "1}\n\n{\"b\":2}\r\n\n");
+    EDGE_REQUIRE(received.size() == 2);
+    EDGE_CHECK(received[0] == "{\"a\":1}");
+    EDGE_CHECK(received[1] == "{\"b\":2}");
+    EDGE_CHECK(buf.readableBytes() == 0);
+}
+
+void testDecodeFrameReportsSkippedBytes() {
+    JsonLineCodec codec;
+    std::string_view frame;
+    size_t consumed = 99;
+    std::string error;
+
+    const std::string blank = "\n\r\n";
+    JsonLineCodec::DecodeResult result = codec.decodeFrame(blank.data(), blank.size(), &frame, &consumed, &error);
+    EDGE_CHECK(result == JsonLineCodec::kNeedMore);
+    EDGE_CHECK(consumed == blank.size());
+
+    const std::string partial = "\n\n{\"x\"";
+    consumed = 99;
+    result = codec.decodeFrame(partial.data(), partial.size(), &frame, &consumed, &error);
+    EDGE_CHECK(result == JsonLineCodec::kNeedMore);
+    EDGE_CHECK(consumed == 2);
+
+    const std::string line = "\n{}\nrest";
+    result = codec.decodeFrame(line.data(), line.size(), &frame, &consumed, &error);
+    EDGE_CHECK(result == JsonLineCodec::kFrame);
+    EDGE_CHECK(frame == "{}");
+    EDGE_CHECK(consumed == 4);
+}
+
+} // namespace
+
+int main() {
+    testBlankLinesAreConsumed();
+    testDecodeFrameReportsSkippedBytes();
+    return edge_infra::testing::report("codec_test");
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace edge_infra {
+
+// 日志时间戳缓存：同一秒内复用已格式化的字符串，只在秒数变化时调用localtime_r
+class LogTimestamp {
+public:
+    // "YYYY-mm-dd HH:MM:SS"
+    static const char* now() {
+        thread_local Cache cache;
+        time_t seconds = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        if (seconds != cache.seconds) {
+            struct tm tm_time;
+            ::localtime_r(&seconds, &tm_time);
+            std::strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &tm_time);
+            cache.seconds = seconds;
+        }
+        return cache.text;
+    }
+
+private:
+    struct Cache {
+        time_t seconds = -1;
+        char text[32] = {0};
+    };
+};
+
+// 单生产者单消费者的字节环形缓冲区，每条记录为 [长度4字节][标志1字节][内容]。
+// 每个写日志的线程持有独立的LogRing，写入路径无锁；后台线程定期收集所有环形缓冲区，合并成一次write输出
+class LogRing {
+public:
+    static const size_t kRecordHeader = 5;
+
+    explicit LogRing(size_t capacity)
+        : capacity_(roundUpPow2(capacity)),
+          mask_(capacity_ - 1),
+          buffer_(new char[capacity_]) {
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t maxRecord() const { return capacity_ / 4; }
+
+    // 生产者线程调用，空间不足时返回false
+    bool tryPush(const char* data, size_t len, uint8_t flags) {
+        const size_t need = kRecordHeader + len;
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        if (capacity_ - (head - tail) < need) {
+            return false;
+        }
+
+        char header[kRecordHeader];
+        uint32_t len32 = static_cast<uint32_t>(len);
+        std::memcpy(header, &len32, sizeof(len32));
+        header[4] = static_cast<char>(flags);
+        copyIn(head, header, kRecordHeader);
+        copyIn(head + kRecordHeader, data, len);
+        head_.store(head + need, std::memory_order_release);
+        return true;
+    }
+
+    size_t usedBytes() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // 消费者线程调用，把所有记录追加到out/err，返回取出的记录数
+    size_t drain(std::string* out, std::string* err) {
+        const size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (tail != head) {
+            char header[kRecordHeader];
+            copyOut(tail, header, kRecordHeader);
+            uint32_t len = 0;
+            std::memcpy(&len, header, sizeof(len));
+            std::string* target = (header[4] & kToStderr) ? err : out;
+
+            size_t old_size = target->size();
+            target->resize(old_size + len);
+            copyOut(tail + kRecordHeader, &(*target)[old_size], len);
+            tail += kRecordHeader + len;
+            ++count;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    // 所属线程退出后置位，消费者取空后回收
+    void retire() { retired_.store(true, std::memory_order_release); }
+    bool retired() const { return retired_.load(std::memory_order_acquire); }
+
+    static const uint8_t kToStderr = 1;
+
+private:
+    static size_t roundUpPow2(size_t n) {
+        size_t cap = 1024;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    void copyIn(size_t pos, const char* src, size_t len) {
+        size_t offset = pos & mask_;
+        size_t first = std::min(len, capacity_ - offset);
+        std::memcpy(buffer_.get() + offset, src, first);
+        std::memcpy(buffer_.get(), src + first, len - first);
+    }
+
+    void copyOut(size_t pos, char* dst, size_t len) const {
+        size_t offset = pos & mask_;
+        size_t first = std::min(len, capacity_ - offset);
+        std::memcpy(dst, buffer_.get() + offset, first);
+        std::memcpy(dst + first, buffer_.get(), len - first);
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<char[]> buffer_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<bool> retired_{false};
+};
+
+// LogRing写满时的处理策略
+enum class LogOverflowPolicy {
+    kDrop,   // 直接丢弃并计数
+    kBlock   // 唤醒后台线程并等待，超过max_block_us仍无空间则丢弃
+};
+
+struct AsyncLogOptions {
+    size_t ring_bytes = 64 * 1024;      // 每个线程的缓冲区大小
+    LogOverflowPolicy policy = LogOverflowPolicy::kDrop;
+    int64_t max_block_us = 1000;
+    int flush_interval_ms = 100;
+    bool console = true;
+};
+
+// 异步日志后端
+class AsyncLogBackend {
+public:
+    using OverflowPolicy = LogOverflowPolicy;
+    using Options = AsyncLogOptions;
+
+    explicit AsyncLogBackend(const Options& options = Options())
+        : options_(options),
+          id_(nextId()),
+          file_fd_(-1),
+          running_(true),
+          flush_requested_(0),
+          flush_completed_(0),
+          dropped_lines_(0) {
+        thread_ = std::thread(&AsyncLogBackend::flusherLoop, this);
+    }
+
+    ~AsyncLogBackend() {
+        stop();
+        if (file_fd_ >= 0) {
+            ::close(file_fd_);
+        }
+    }
+
+    AsyncLogBackend(const AsyncLogBackend&) = delete;
+    AsyncLogBackend& operator=(const AsyncLogBackend&) = delete;
+
+    bool setLogFile(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        std::lock_guard<std::mutex> lock(output_mutex_);
+        if (file_fd_ >= 0) {
+            ::close(file_fd_);
+        }
+        file_fd_ = fd;
+        return fd >= 0;
+    }
+
+    void setConsoleOutput(bool enable) {
+        std::lock_guard<std::mutex> lock(output_mutex_);
+        options_.console = enable;
+    }
+
+    // 追加一行（不含换行符），返回false表示被丢弃
+    bool append(const char* data, size_t len, bool to_stderr = false) {
+        LogRing* ring = localRing();
+        if (len + 1 > ring->maxRecord()) {
+            len = ring->maxRecord() - 1;
+        }
+
+        // 换行符与内容放在同一条记录中，保证行的完整性
+        char stack_line[512];
+        std::unique_ptr<char[]> heap_line;
+        char* line = stack_line;
+        if (len + 1 > sizeof(stack_line)) {
+            heap_line.reset(new char[len + 1]);
+            line = heap_line.get();
+        }
+        std::memcpy(line, data, len);
+        line[len] = '\n';
+
+        const uint8_t flags = to_stderr ? LogRing::kToStderr : 0;
+        if (ring->tryPush(line, len + 1, flags)) {
+            if (ring->usedBytes() > ring->capacity() / 2) {
+                wakeFlusher();
+            }
+            return true;
+        }
+
+        if (options_.policy == OverflowPolicy::kBlock) {
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::microseconds(options_.max_block_us);
+            do {
+                wakeFlusher();
+                std::this_thread::yield();
+                if (ring->tryPush(line, len + 1, flags)) {
+                    return true;
+                }
+            } while (std::chrono::steady_clock::now() < deadline);
+        }
+
+        dropped_lines_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool append(const std::string& line, bool to_stderr = false) {
+        return append(line.data(), line.size(), to_stderr);
+    }
+
+    // 阻塞直到调用前写入的日志全部落盘
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_) return;
+        const uint64_t target = ++flush_requested_;
+        cond_.notify_one();
+        flushed_cond_.wait(lock, [this, target] { return flush_completed_ >= target || !running_; });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) return;
+            running_ = false;
+        }
+        cond_.notify_one();
+        flushed_cond_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    uint64_t droppedLines() const { return dropped_lines_.load(std::memory_order_relaxed); }
+
+private:
+    struct LocalEntry {
+        uint64_t backend_id;
+        std::shared_ptr<LogRing> ring;
+    };
+
+    struct LocalRings {
+        std::vector<LocalEntry> entries;
+        ~LocalRings() {
+            for (auto& entry : entries) {
+                entry.ring->retire();
+            }
+        }
+    };
+
+    // 不加锁通知，丢失的唤醒由flush_interval_ms兜底
+    void wakeFlusher() {
+        if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+            cond_.notify_one();
+        }
+    }
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1);
+    }
+
+    LogRing* localRing() {
+        thread_local LocalRings local;
+        for (auto& entry : local.entries) {
+            if (entry.backend_id == id_) {
+                return entry.ring.get();
+            }
+        }
+
+        auto ring = std::make_shared<LogRing>(options_.ring_bytes);
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.push_back(ring);
+        }
+        local.entries.push_back(LocalEntry{id_, ring});
+        return ring.get();
+    }
+
+    // 收集所有线程的日志，返回取出的记录数
+    size_t drainAll(std::string* out, std::string* err) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        size_t count = 0;
+        for (size_t i = 0; i < rings_.size();) {
+            // 先读retired再取数据，保证回收前所属线程的最后写入已被取出
+            bool retired = rings_[i]->retired();
+            count += rings_[i]->drain(out, err);
+            if (retired) {
+                rings_[i] = rings_.back();
+                rings_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        return count;
+    }
+
+    void writeBatch(const std::string& out, const std::string& err) {
+        std::lock_guard<std::mutex> lock(output_mutex_);
+        if (options_.console) {
+            writeAll(STDOUT_FILENO, out);
+            writeAll(STDERR_FILENO, err);
+        }
+        if (file_fd_ >= 0) {
+            writeAll(file_fd_, out);
+            writeAll(file_fd_, err);
+        }
+    }
+
+    static void writeAll(int fd, const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    void flusherLoop() {
+        std::string out;
+        std::string err;
+        bool running = true;
+        while (running) {
+            uint64_t requested = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait_for(lock, std::chrono::milliseconds(options_.flush_interval_ms),
+                               [this] {
+                                   return !running_ || flush_requested_ > flush_completed_ ||
+                                          wake_pending_.load(std::memory_order_acquire);
+                               });
+                wake_pending_.store(false, std::memory_order_release);
+                running = running_;
+                requested = flush_requested_;
+            }
+
+            // 取空后再检查一次，尽量把突发日志合并到同一批
+            while (drainAll(&out, &err) > 0 && out.size() + err.size() < options_.ring_bytes) {
+            }
+            if (!out.empty() || !err.empty()) {
+                writeBatch(out, err);
+                out.clear();
+                err.clear();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                flush_completed_ = requested;
+            }
+            flushed_cond_.notify_all();
+        }
+
+        // 退出前输出剩余日志
+        drainAll(&out, &err);
+        writeBatch(out, err);
+    }
+
+    Options options_;
+    const uint64_t id_;
+    int file_fd_;
+    std::mutex output_mutex_;
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<LogRing>> rings_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::condition_variable flushed_cond_;
+    bool running_;
+    uint64_t flush_requested_;
+    uint64_t flush_completed_;
+    std::atomic<bool> wake_pending_{false};
+
+    std::atomic<uint64_t> dropped_lines_;
+    std::thread thread_;
+};
+
+} // namespace edge_infra
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <cassert>
+#include "trace.h"
 
 namespace edge_infra {
 
@@ -49,9 +50,11 @@ class Timer {
 private:
     std::chrono::high_resolution_clock::time_point start_time_;
     std::string name_;
+    // 处于被采样的请求中时同时记录为子span
+    trace::Span span_;
     
 public:
-    Timer(const std::string& name) : name_(name) {
+    Timer(const std::string& name) : name_(name), span_(name_) {
         start_time_ = std::chrono::high_resolution_clock::now();
     }
     
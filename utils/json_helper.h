@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <sstream>
+#include "json_writer.h"
 
 namespace edge_infra {
 
@@ -93,47 +94,53 @@ public:
     
     // 序列化为JSON字符串
     std::string toString() const {
-        std::ostringstream oss;
-        serialize(oss);
-        return oss.str();
+        std::string out;
+        JsonWriter<std::string> writer(out);
+        writeTo(writer);
+        return out;
     }
     
-private:
-    void serialize(std::ostringstream& oss) const {
+    // 直接序列化到writer的输出（如network::Buffer），字符串按JSON规则转义
+    template<typename Sink>
+    void writeTo(JsonWriter<Sink>& writer) const {
         switch (type_) {
             case NULL_TYPE:
-                oss << "null";
+                writer.null();
                 break;
             case BOOL_TYPE:
-                oss << (bool_val_ ? "true" : "false");
+                writer.value(bool_val_);
                 break;
             case INT_TYPE:
-                oss << int_val_;
+                writer.value(int_val_);
                 break;
             case DOUBLE_TYPE:
-                oss << double_val_;
+                writer.value(double_val_);
                 break;
             case STRING_TYPE:
-                oss << "\"" << string_val_ << "\"";
+                writer.value(string_val_);
                 break;
             case ARRAY_TYPE:
-                oss << "[";
-                for (size_t i = 0; i < array_val_.size(); ++i) {
-                    if (i > 0) oss << ",";
-                    array_val_[i]->serialize(oss);
+                writer.startArray();
+                for (const auto& item : array_val_) {
+                    if (item) {
+                        item->writeTo(writer);
+                    } else {
+                        writer.null();
+                    }
                 }
-                oss << "]";
+                writer.endArray();
                 break;
             case OBJECT_TYPE:
-                oss << "{";
-                bool first = true;
+                writer.startObject();
                 for (const auto& pair : object_val_) {
-                    if (!first) oss << ",";
-                    oss << "\"" << pair.first << "\":";
-                    pair.second->serialize(oss);
-                    first = false;
+                    writer.key(pair.first);
+                    if (pair.second) {
+                        pair.second->writeTo(writer);
+                    } else {
+                        writer.null();
+                    }
                 }
-                oss << "}";
+                writer.endObject();
                 break;
         }
     }
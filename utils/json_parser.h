@@ -0,0 +1,762 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace edge_infra {
+
+// ==================== 内存池 ====================
+
+// 按块分配、整体释放的内存池，只用于平凡析构的对象（JsonNode等）
+class JsonArena {
+private:
+    // 头部按max_align_t对齐，数据区起始地址满足默认对齐
+    struct alignas(std::max_align_t) Block {
+        Block* next;
+        size_t size;
+        size_t used;
+        // 数据紧跟在头部之后
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static const size_t kMinBlockSize = 4096;
+    static const size_t kMaxBlockSize = 64 * 1024;
+
+    Block* head_;
+    size_t next_block_size_;
+    size_t allocated_bytes_;
+
+public:
+    JsonArena() : head_(nullptr), next_block_size_(kMinBlockSize), allocated_bytes_(0) {}
+
+    ~JsonArena() {
+        freeBlocks(head_);
+    }
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        if (head_ != nullptr) {
+            if (void* p = tryAllocate(head_, size, align)) return p;
+        }
+        newBlock(size + align);
+        return tryAllocate(head_, size, align);
+    }
+
+    template<typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // 释放全部节点，只保留最近的一块供下次复用
+    void reset() {
+        if (head_ == nullptr) return;
+        freeBlocks(head_->next);
+        head_->next = nullptr;
+        head_->used = 0;
+        allocated_bytes_ = head_->size;
+    }
+
+    size_t allocatedBytes() const { return allocated_bytes_; }
+
+private:
+    // 按绝对地址对齐，align大于头部对齐时同样正确
+    static void* tryAllocate(Block* block, size_t size, size_t align) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block->data());
+        const uintptr_t aligned = (base + block->used + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        const size_t offset = static_cast<size_t>(aligned - base);
+        if (offset + size > block->size) return nullptr;
+        block->used = offset + size;
+        return block->data() + offset;
+    }
+
+    void newBlock(size_t min_size) {
+        size_t size = next_block_size_;
+        while (size < min_size) size *= 2;
+        if (next_block_size_ < kMaxBlockSize) next_block_size_ *= 2;
+
+        Block* block = static_cast<Block*>(std::malloc(sizeof(Block) + size));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        block->next = head_;
+        block->size = size;
+        block->used = 0;
+        head_ = block;
+        allocated_bytes_ += size;
+    }
+
+    static void freeBlocks(Block* block) {
+        while (block != nullptr) {
+            Block* next = block->next;
+            std::free(block);
+            block = next;
+        }
+    }
+};
+
+// ==================== 增量扫描 ====================
+
+// 在不完整的输入上增量查找一个完整JSON文档的边界，已扫描的字节不会重复扫描。
+// 适用于TCP按任意边界分片到达的请求，例如在BufferMessageCallback中：
+//     auto status = scanner.scan(buf->peek(), buf->readableBytes());
+//     if (status == JsonStreamScanner::kComplete) {
+//         doc.parse(buf->peek(), scanner.documentSize());
+//         buf->retrieve(scanner.documentSize());
+//         scanner.reset();
+//     }
+// 每次调用传入的data必须从文档起点开始，且包含上次传入的全部内容
+class JsonStreamScanner {
+public:
+    enum Status {
+        kNeedMore,
+        kComplete,
+        kError
+    };
+
+private:
+    size_t pos_;
+    size_t max_document_size_;
+    int depth_;
+    bool started_;
+    bool in_string_;
+    bool escape_;
+    bool in_scalar_;
+    size_t document_size_;
+
+public:
+    explicit JsonStreamScanner(size_t max_document_size = 16 * 1024 * 1024)
+        : max_document_size_(max_document_size) {
+        reset();
+    }
+
+    void reset() {
+        pos_ = 0;
+        depth_ = 0;
+        started_ = false;
+        in_string_ = false;
+        escape_ = false;
+        in_scalar_ = false;
+        document_size_ = 0;
+    }
+
+    // 返回kComplete时documentSize()为文档（含前导空白）的字节数
+    Status scan(const char* data, size_t len) {
+        while (pos_ < len) {
+            const char c = data[pos_];
+            if (in_string_) {
+                if (escape_) {
+                    escape_ = false;
+                } else if (c == '\\') {
+                    escape_ = true;
+                } else if (c == '"') {
+                    in_string_ = false;
+                    if (depth_ == 0) return complete(pos_ + 1);
+                }
+                ++pos_;
+                continue;
+            }
+
+            switch (c) {
+                case ' ': case '\t': case '\n': case '\r':
+                    if (in_scalar_ && depth_ == 0) return complete(pos_);
+                    break;
+                case '{': case '[':
+                    if (in_scalar_ && depth_ == 0) return complete(pos_);
+                    ++depth_;
+                    started_ = true;
+                    break;
+                case '}': case ']':
+                    if (--depth_ < 0) return kError;
+                    if (depth_ == 0) return complete(pos_ + 1);
+                    break;
+                case '"':
+                    if (in_scalar_ && depth_ == 0) return complete(pos_);
+                    in_string_ = true;
+                    started_ = true;
+                    break;
+                default:
+                    if (depth_ == 0) {
+                        in_scalar_ = true;
+                        started_ = true;
+                    }
+                    break;
+            }
+            ++pos_;
+        }
+
+        if (pos_ > max_document_size_) {
+            return kError;
+        }
+        return kNeedMore;
+    }
+
+    size_t documentSize() const { return document_size_; }
+    size_t scannedBytes() const { return pos_; }
+    bool started() const { return started_; }
+
+private:
+    Status complete(size_t size) {
+        document_size_ = size;
+        pos_ = size;
+        return kComplete;
+    }
+};
+
+// ==================== SAX 解析 ====================
+
+// SAX事件接口，返回false中止解析。
+// onString/onKey中transient为true表示内容经过转义解码，只在回调期间有效；
+// 否则指向输入缓冲区
+struct JsonSaxHandler {
+    bool onNull() { return true; }
+    bool onBool(bool) { return true; }
+    bool onInt(int64_t) { return true; }
+    bool onDouble(double) { return true; }
+    bool onString(std::string_view, bool) { return true; }
+    bool onKey(std::string_view, bool) { return true; }
+    bool onStartObject() { return true; }
+    bool onEndObject(size_t) { return true; }
+    bool onStartArray() { return true; }
+    bool onEndArray(size_t) { return true; }
+};
+
+// 对一段完整、连续的输入做一次递归下降解析，不分配节点内存
+template<typename Handler>
+class JsonSaxParser {
+private:
+    Handler& handler_;
+    int max_depth_;
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    std::string scratch_;
+    const char* error_;
+    size_t error_offset_;
+
+public:
+    explicit JsonSaxParser(Handler& handler, int max_depth = 128)
+        : handler_(handler), max_depth_(max_depth),
+          begin_(nullptr), p_(nullptr), end_(nullptr),
+          error_(nullptr), error_offset_(0) {}
+
+    bool parse(const char* data, size_t len) {
+        begin_ = data;
+        p_ = data;
+        end_ = data + len;
+        error_ = nullptr;
+        error_offset_ = 0;
+
+        skipWhitespace();
+        if (!parseValue(0)) return false;
+        skipWhitespace();
+        if (p_ != end_) return fail("trailing characters");
+        return true;
+    }
+
+    const char* errorMessage() const { return error_ != nullptr ? error_ : ""; }
+    size_t errorOffset() const { return error_offset_; }
+
+private:
+    bool fail(const char* message) {
+        if (error_ == nullptr) {
+            error_ = message;
+            error_offset_ = static_cast<size_t>(p_ - begin_);
+        }
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    bool parseValue(int depth) {
+        if (p_ >= end_) return fail("unexpected end of input");
+        switch (*p_) {
+            case '{': return parseObject(depth);
+            case '[': return parseArray(depth);
+            case '"': {
+                std::string_view str;
+                bool transient = false;
+                if (!parseString(&str, &transient)) return false;
+                return handler_.onString(str, transient) || fail("aborted by handler");
+            }
+            case 't': return parseLiteral("true", 4) && (handler_.onBool(true) || fail("aborted by handler"));
+            case 'f': return parseLiteral("false", 5) && (handler_.onBool(false) || fail("aborted by handler"));
+            case 'n': return parseLiteral("null", 4) && (handler_.onNull() || fail("aborted by handler"));
+            default: return parseNumber();
+        }
+    }
+
+    bool parseLiteral(const char* literal, size_t len) {
+        if (static_cast<size_t>(end_ - p_) < len || std::memcmp(p_, literal, len) != 0) {
+            return fail("invalid literal");
+        }
+        p_ += len;
+        return true;
+    }
+
+    bool parseObject(int depth) {
+        if (depth >= max_depth_) return fail("nesting too deep");
+        ++p_;
+        if (!handler_.onStartObject()) return fail("aborted by handler");
+
+        size_t count = 0;
+        skipWhitespace();
+        if (p_ < end_ && *p_ == '}') {
+            ++p_;
+            return handler_.onEndObject(0) || fail("aborted by handler");
+        }
+
+        while (true) {
+            if (p_ >= end_ || *p_ != '"') return fail("expected object key");
+            std::string_view key;
+            bool transient = false;
+            if (!parseString(&key, &transient)) return false;
+            if (!handler_.onKey(key, transient)) return fail("aborted by handler");
+
+            skipWhitespace();
+            if (p_ >= end_ || *p_ != ':') return fail("expected ':'");
+            ++p_;
+            skipWhitespace();
+            if (!parseValue(depth + 1)) return false;
+            ++count;
+
+            skipWhitespace();
+            if (p_ >= end_) return fail("unexpected end of input");
+            if (*p_ == ',') {
+                ++p_;
+                skipWhitespace();
+                continue;
+            }
+            if (*p_ == '}') {
+                ++p_;
+                return handler_.onEndObject(count) || fail("aborted by handler");
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool parseArray(int depth) {
+        if (depth >= max_depth_) return fail("nesting too deep");
+        ++p_;
+        if (!handler_.onStartArray()) return fail("aborted by handler");
+
+        size_t count = 0;
+        skipWhitespace();
+        if (p_ < end_ && *p_ == ']') {
+            ++p_;
+            return handler_.onEndArray(0) || fail("aborted by handler");
+        }
+
+        while (true) {
+            if (!parseValue(depth + 1)) return false;
+            ++count;
+
+            skipWhitespace();
+            if (p_ >= end_) return fail("unexpected end of input");
+            if (*p_ == ',') {
+                ++p_;
+                skipWhitespace();
+                continue;
+            }
+            if (*p_ == ']') {
+                ++p_;
+                return handler_.onEndArray(count) || fail("aborted by handler");
+            }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool parseString(std::string_view* out, bool* transient) {
+        ++p_;  // 跳过起始引号
+        const char* start = p_;
+
+        // 快速路径：无转义的字符串直接引用输入
+        while (p_ < end_ && *p_ != '"' && *p_ != '\\') {
+            if (static_cast<unsigned char>(*p_) < 0x20) return fail("control character in string");
+            ++p_;
+        }
+        if (p_ >= end_) return fail("unterminated string");
+        if (*p_ == '"') {
+            *out = std::string_view(start, static_cast<size_t>(p_ - start));
+            *transient = false;
+            ++p_;
+            return true;
+        }
+
+        scratch_.assign(start, static_cast<size_t>(p_ - start));
+        while (p_ < end_) {
+            const char c = *p_;
+            if (c == '"') {
+                ++p_;
+                *out = std::string_view(scratch_);
+                *transient = true;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) return fail("control character in string");
+            if (c != '\\') {
+                scratch_.push_back(c);
+                ++p_;
+                continue;
+            }
+
+            if (++p_ >= end_) break;
+            switch (*p_) {
+                case '"': scratch_.push_back('"'); break;
+                case '\\': scratch_.push_back('\\'); break;
+                case '/': scratch_.push_back('/'); break;
+                case 'b': scratch_.push_back('\b'); break;
+                case 'f': scratch_.push_back('\f'); break;
+                case 'n': scratch_.push_back('\n'); break;
+                case 'r': scratch_.push_back('\r'); break;
+                case 't': scratch_.push_back('\t'); break;
+                case 'u':
+                    if (!parseUnicodeEscape()) return false;
+                    continue;
+                default:
+                    return fail("invalid escape");
+            }
+            ++p_;
+        }
+        return fail("unterminated string");
+    }
+
+    // p_指向'u'，结束时指向转义序列之后
+    bool parseUnicodeEscape() {
+        uint32_t code = 0;
+        if (!readHex4(&code)) return false;
+
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low = 0;
+            if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') return fail("invalid surrogate pair");
+            ++p_;
+            if (!readHex4(&low)) return false;
+            if (low < 0xDC00 || low > 0xDFFF) return fail("invalid surrogate pair");
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return fail("invalid surrogate pair");
+        }
+
+        // 编码为UTF-8
+        if (code < 0x80) {
+            scratch_.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            scratch_.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            scratch_.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            scratch_.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+
+    // p_指向'u'
+    bool readHex4(uint32_t* code) {
+        ++p_;
+        if (end_ - p_ < 4) return fail("invalid unicode escape");
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = p_[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+            else return fail("invalid unicode escape");
+        }
+        p_ += 4;
+        *code = value;
+        return true;
+    }
+
+    bool parseNumber() {
+        const char* start = p_;
+        bool negative = false;
+        bool is_integer = true;
+        bool overflow = false;
+        uint64_t magnitude = 0;
+
+        if (*p_ == '-') {
+            negative = true;
+            ++p_;
+        }
+        if (p_ >= end_ || *p_ < '0' || *p_ > '9') return fail("invalid number");
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+                uint64_t digit = static_cast<uint64_t>(*p_ - '0');
+                if (magnitude > (UINT64_MAX - digit) / 10) overflow = true;
+                magnitude = magnitude * 10 + digit;
+                ++p_;
+            }
+        }
+        if (p_ < end_ && *p_ == '.') {
+            is_integer = false;
+            ++p_;
+            if (p_ >= end_ || *p_ < '0' || *p_ > '9') return fail("invalid number");
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            is_integer = false;
+            ++p_;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+            if (p_ >= end_ || *p_ < '0' || *p_ > '9') return fail("invalid number");
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+
+        const uint64_t limit = negative ? static_cast<uint64_t>(INT64_MAX) + 1 : static_cast<uint64_t>(INT64_MAX);
+        if (is_integer && !overflow && magnitude <= limit) {
+            int64_t value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+            return handler_.onInt(value) || fail("aborted by handler");
+        }
+
+        // 输入不以'\0'结尾，复制到本地缓冲区后再交给strtod
+        const size_t len = static_cast<size_t>(p_ - start);
+        char local[64];
+        double value = 0;
+        if (len < sizeof(local)) {
+            std::memcpy(local, start, len);
+            local[len] = '\0';
+            value = std::strtod(local, nullptr);
+        } else {
+            value = std::strtod(std::string(start, len).c_str(), nullptr);
+        }
+        return handler_.onDouble(value) || fail("aborted by handler");
+    }
+};
+
+// ==================== DOM ====================
+
+struct JsonMember;
+
+// 内存池中的只读节点，字符串指向输入缓冲区或内存池
+struct JsonNode {
+    enum Type : uint8_t {
+        NULL_TYPE,
+        BOOL_TYPE,
+        INT_TYPE,
+        DOUBLE_TYPE,
+        STRING_TYPE,
+        ARRAY_TYPE,
+        OBJECT_TYPE
+    };
+
+    Type type;
+    uint32_t size;   // 字符串长度 / 数组元素数 / 对象成员数
+    union {
+        bool bool_val;
+        int64_t int_val;
+        double double_val;
+        const char* str;
+        const JsonNode* items;
+        const JsonMember* members;
+    };
+
+    Type getType() const { return type; }
+    bool isNull() const { return type == NULL_TYPE; }
+    bool isObject() const { return type == OBJECT_TYPE; }
+    bool isArray() const { return type == ARRAY_TYPE; }
+
+    bool asBool() const { return type == BOOL_TYPE ? bool_val : false; }
+    int64_t asInt() const {
+        if (type == INT_TYPE) return int_val;
+        if (type == DOUBLE_TYPE) return static_cast<int64_t>(double_val);
+        return 0;
+    }
+    double asDouble() const {
+        if (type == DOUBLE_TYPE) return double_val;
+        if (type == INT_TYPE) return static_cast<double>(int_val);
+        return 0.0;
+    }
+    std::string_view asString() const {
+        return type == STRING_TYPE ? std::string_view(str, size) : std::string_view();
+    }
+
+    size_t length() const {
+        return (type == ARRAY_TYPE || type == OBJECT_TYPE) ? size : 0;
+    }
+
+    const JsonNode* at(size_t index) const {
+        return (type == ARRAY_TYPE && index < size) ? &items[index] : nullptr;
+    }
+
+    // 线性查找，请求对象的字段数通常很少
+    inline const JsonNode* get(std::string_view key) const;
+    bool hasKey(std::string_view key) const { return get(key) != nullptr; }
+};
+
+struct JsonMember {
+    const char* key;
+    uint32_t key_size;
+    JsonNode value;
+
+    std::string_view name() const { return std::string_view(key, key_size); }
+};
+
+inline const JsonNode* JsonNode::get(std::string_view key) const {
+    if (type != OBJECT_TYPE) return nullptr;
+    for (uint32_t i = 0; i < size; ++i) {
+        if (members[i].name() == key) {
+            return &members[i].value;
+        }
+    }
+    return nullptr;
+}
+
+// 一次请求对应一个文档：所有节点分配在内部内存池中，clear()/重新parse时整体释放。
+// 未转义的字符串直接引用输入，因此输入缓冲区必须在使用节点期间保持有效
+class JsonDocument {
+private:
+    JsonArena arena_;
+    const JsonNode* root_;
+    std::vector<JsonNode> values_;
+    std::vector<std::string_view> keys_;
+    std::string error_;
+    size_t error_offset_;
+
+    struct Builder : JsonSaxHandler {
+        JsonDocument& doc;
+        explicit Builder(JsonDocument& d) : doc(d) {}
+
+        bool push(JsonNode node) {
+            doc.values_.push_back(node);
+            return true;
+        }
+
+        bool onNull() {
+            JsonNode node{};
+            node.type = JsonNode::NULL_TYPE;
+            return push(node);
+        }
+        bool onBool(bool value) {
+            JsonNode node{};
+            node.type = JsonNode::BOOL_TYPE;
+            node.bool_val = value;
+            return push(node);
+        }
+        bool onInt(int64_t value) {
+            JsonNode node{};
+            node.type = JsonNode::INT_TYPE;
+            node.int_val = value;
+            return push(node);
+        }
+        bool onDouble(double value) {
+            JsonNode node{};
+            node.type = JsonNode::DOUBLE_TYPE;
+            node.double_val = value;
+            return push(node);
+        }
+        bool onString(std::string_view value, bool transient) {
+            value = doc.keep(value, transient);
+            JsonNode node{};
+            node.type = JsonNode::STRING_TYPE;
+            node.str = value.data();
+            node.size = static_cast<uint32_t>(value.size());
+            return push(node);
+        }
+        bool onKey(std::string_view key, bool transient) {
+            doc.keys_.push_back(doc.keep(key, transient));
+            return true;
+        }
+        bool onEndObject(size_t count) {
+            JsonMember* members = doc.arena_.allocateArray<JsonMember>(count);
+            const size_t value_base = doc.values_.size() - count;
+            const size_t key_base = doc.keys_.size() - count;
+            for (size_t i = 0; i < count; ++i) {
+                members[i].key = doc.keys_[key_base + i].data();
+                members[i].key_size = static_cast<uint32_t>(doc.keys_[key_base + i].size());
+                members[i].value = doc.values_[value_base + i];
+            }
+            doc.values_.resize(value_base);
+            doc.keys_.resize(key_base);
+
+            JsonNode node{};
+            node.type = JsonNode::OBJECT_TYPE;
+            node.members = members;
+            node.size = static_cast<uint32_t>(count);
+            return push(node);
+        }
+        bool onEndArray(size_t count) {
+            JsonNode* items = doc.arena_.allocateArray<JsonNode>(count);
+            const size_t base = doc.values_.size() - count;
+            for (size_t i = 0; i < count; ++i) {
+                items[i] = doc.values_[base + i];
+            }
+            doc.values_.resize(base);
+
+            JsonNode node{};
+            node.type = JsonNode::ARRAY_TYPE;
+            node.items = items;
+            node.size = static_cast<uint32_t>(count);
+            return push(node);
+        }
+    };
+
+public:
+    JsonDocument() : root_(nullptr), error_offset_(0) {}
+
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    bool parse(const char* data, size_t len) {
+        clear();
+        Builder builder(*this);
+        JsonSaxParser<Builder> parser(builder);
+        if (!parser.parse(data, len)) {
+            error_ = parser.errorMessage();
+            error_offset_ = parser.errorOffset();
+            values_.clear();
+            keys_.clear();
+            return false;
+        }
+
+        JsonNode* root = arena_.allocateArray<JsonNode>(1);
+        *root = values_.back();
+        values_.clear();
+        root_ = root;
+        return true;
+    }
+
+    bool parse(std::string_view json) {
+        return parse(json.data(), json.size());
+    }
+
+    void clear() {
+        arena_.reset();
+        root_ = nullptr;
+        error_.clear();
+        error_offset_ = 0;
+    }
+
+    const JsonNode* root() const { return root_; }
+    const std::string& errorMessage() const { return error_; }
+    size_t errorOffset() const { return error_offset_; }
+    size_t arenaBytes() const { return arena_.allocatedBytes(); }
+
+private:
+    // 解码后的临时字符串复制到内存池
+    std::string_view keep(std::string_view value, bool transient) {
+        if (!transient || value.empty()) return value;
+        char* copy = arena_.allocateArray<char>(value.size());
+        std::memcpy(copy, value.data(), value.size());
+        return std::string_view(copy, value.size());
+    }
+};
+
+} // namespace edge_infra
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace edge_infra {
+
+namespace json_detail {
+
+// 返回第一个需要转义的字节（'"'、'\\'、控制字符）的位置，没有则返回len
+inline size_t findEscape(const char* s, size_t len) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        // max(v, 0x1F) == 0x1F 即 v <= 0x1F（无符号比较）
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                   _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)), vcltq_u8(v, control));
+        if (vmaxvq_u8(hit) != 0) {
+            break;  // 块内逐字节定位
+        }
+    }
+#endif
+    for (; i < len; ++i) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return i;
+        }
+    }
+    return len;
+}
+
+} // namespace json_detail
+
+// 流式JSON序列化，直接写入调用方提供的输出对象。
+// Sink只需提供 append(const char*, size_t)，例如 std::string 或 network::Buffer：
+//     network::Buffer buf;
+//     JsonWriter<network::Buffer> writer(buf);
+//     writer.startObject().key("token").value(text).endObject().endLine();
+//     conn->send(&buf);
+// 逗号与冒号由writer按嵌套状态自动插入，不做结构合法性检查
+template<typename Sink>
+class JsonWriter {
+public:
+    // 逐层记录是否已有元素的深度；更深的层共用最后一个槽位，输出仍然合法
+    static const int kMaxDepth = 64;
+
+private:
+    Sink& sink_;
+    int depth_;
+    bool after_key_;
+    bool has_items_[kMaxDepth + 1];
+
+public:
+    explicit JsonWriter(Sink& sink) : sink_(sink) {
+        reset();
+    }
+
+    Sink& sink() { return sink_; }
+
+    // 开始一个新文档（NDJSON的下一行）
+    void reset() {
+        depth_ = 0;
+        after_key_ = false;
+        has_items_[0] = false;
+    }
+
+    JsonWriter& startObject() {
+        beforeValue();
+        put('{');
+        push();
+        return *this;
+    }
+
+    JsonWriter& endObject() {
+        pop();
+        put('}');
+        return *this;
+    }
+
+    JsonWriter& startArray() {
+        beforeValue();
+        put('[');
+        push();
+        return *this;
+    }
+
+    JsonWriter& endArray() {
+        pop();
+        put(']');
+        return *this;
+    }
+
+    JsonWriter& key(std::string_view name) {
+        bool& has_items = hasItems();
+        if (has_items) put(',');
+        has_items = true;
+        writeString(name);
+        put(':');
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(std::string_view str) {
+        beforeValue();
+        writeString(str);
+        return *this;
+    }
+
+    JsonWriter& value(const char* str) {
+        return str != nullptr ? value(std::string_view(str)) : null();
+    }
+
+    JsonWriter& value(const std::string& str) {
+        return value(std::string_view(str));
+    }
+
+    JsonWriter& value(bool b) {
+        beforeValue();
+        if (b) {
+            sink_.append("true", 4);
+        } else {
+            sink_.append("false", 5);
+        }
+        return *this;
+    }
+
+    template<typename T,
+             typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    JsonWriter& value(T v) {
+        beforeValue();
+        writeInteger(v);
+        return *this;
+    }
+
+    JsonWriter& value(double v) {
+        beforeValue();
+        if (!std::isfinite(v)) {
+            // JSON不支持NaN/Inf
+            sink_.append("null", 4);
+            return *this;
+        }
+        char buf[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto result = std::to_chars(buf, buf + sizeof(buf), v);
+        sink_.append(buf, static_cast<size_t>(result.ptr - buf));
+#else
+        int n = std::snprintf(buf, sizeof(buf), "%.17g", v);
+        sink_.append(buf, static_cast<size_t>(n));
+#endif
+        return *this;
+    }
+
+    JsonWriter& null() {
+        beforeValue();
+        sink_.append("null", 4);
+        return *this;
+    }
+
+    // 写入已经序列化好的JSON片段
+    JsonWriter& raw(std::string_view json) {
+        beforeValue();
+        sink_.append(json.data(), json.size());
+        return *this;
+    }
+
+    template<typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+    // NDJSON：结束当前行并开始下一个文档
+    JsonWriter& endLine() {
+        put('\n');
+        reset();
+        return *this;
+    }
+
+    void writeString(std::string_view str) {
+        static const char kHex[] = "0123456789abcdef";
+        put('"');
+        const char* p = str.data();
+        size_t remaining = str.size();
+        while (remaining > 0) {
+            size_t run = json_detail::findEscape(p, remaining);
+            if (run > 0) {
+                sink_.append(p, run);
+            }
+            if (run == remaining) break;
+
+            const unsigned char c = static_cast<unsigned char>(p[run]);
+            switch (c) {
+                case '"': sink_.append("\\\"", 2); break;
+                case '\\': sink_.append("\\\\", 2); break;
+                case '\n': sink_.append("\\n", 2); break;
+                case '\r': sink_.append("\\r", 2); break;
+                case '\t': sink_.append("\\t", 2); break;
+                case '\b': sink_.append("\\b", 2); break;
+                case '\f': sink_.append("\\f", 2); break;
+                default: {
+                    char esc[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                    sink_.append(esc, sizeof(esc));
+                    break;
+                }
+            }
+            p += run + 1;
+            remaining -= run + 1;
+        }
+        put('"');
+    }
+
+private:
+    void put(char c) {
+        sink_.append(&c, 1);
+    }
+
+    void beforeValue() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        bool& has_items = hasItems();
+        if (has_items) put(',');
+        has_items = true;
+    }
+
+    bool& hasItems() {
+        return has_items_[depth_ < kMaxDepth ? depth_ : kMaxDepth];
+    }
+
+    // depth_始终记录真实深度，push/pop严格对称
+    void push() {
+        ++depth_;
+        hasItems() = false;
+    }
+
+    void pop() {
+        if (depth_ > 0) --depth_;
+        // 刚结束的容器本身就是上一层的元素；超过kMaxDepth的层共用槽位，需在此恢复
+        hasItems() = true;
+        after_key_ = false;
+    }
+
+    template<typename T>
+    void writeInteger(T v) {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), v);
+        sink_.append(buf, static_cast<size_t>(result.ptr - buf));
+    }
+};
+
+// HTTP chunked编码的增量输出：每个分块先序列化到内部复用的缓冲区，再带长度头写入sink
+//     JsonChunkedStream<network::Buffer> stream;
+//     stream.writer().startObject().field("token", text).endObject();
+//     stream.commit(buf);      // "<十六进制长度>\r\n<json>\r\n"
+//     ...
+//     stream.finish(buf);      // "0\r\n\r\n"
+template<typename Sink>
+class JsonChunkedStream {
+private:
+    std::string chunk_;
+    JsonWriter<std::string> writer_;
+    bool ndjson_;
+
+public:
+    // ndjson为true时每个分块以换行结束，便于客户端按行解析
+    explicit JsonChunkedStream(bool ndjson = true) : writer_(chunk_), ndjson_(ndjson) {}
+
+    JsonWriter<std::string>& writer() { return writer_; }
+
+    void commit(Sink& out) {
+        if (ndjson_) {
+            writer_.endLine();
+        } else {
+            writer_.reset();
+        }
+        if (chunk_.empty()) return;
+
+        char header[20];
+        int n = std::snprintf(header, sizeof(header), "%zx\r\n", chunk_.size());
+        out.append(header, static_cast<size_t>(n));
+        out.append(chunk_.data(), chunk_.size());
+        out.append("\r\n", 2);
+        chunk_.clear();
+    }
+
+    void finish(Sink& out) {
+        out.append("0\r\n\r\n", 5);
+    }
+};
+
+} // namespace edge_infra
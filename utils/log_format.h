@@ -0,0 +1,178 @@
+#pragma once
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace edge_infra {
+namespace log_detail {
+
+// ==================== 编译期格式串解析 ====================
+
+constexpr size_t constStrlen(const char* s) {
+    size_t n = 0;
+    while (s[n] != '\0') ++n;
+    return n;
+}
+
+constexpr size_t countPlaceholders(const char* s) {
+    size_t count = 0;
+    for (size_t i = 0; s[i] != '\0'; ++i) {
+        if (s[i] == '{' && s[i + 1] == '}') {
+            ++count;
+            ++i;
+        }
+    }
+    return count;
+}
+
+// N个占位符把格式串切成N+1段字面文本
+template<size_t N>
+struct ParsedFormat {
+    size_t begin[N + 1];
+    size_t length[N + 1];
+    size_t total;
+};
+
+template<size_t N>
+constexpr ParsedFormat<N> parseFormat(const char* s) {
+    ParsedFormat<N> parsed{};
+    size_t segment = 0;
+    size_t start = 0;
+    size_t i = 0;
+    for (; s[i] != '\0'; ++i) {
+        if (s[i] == '{' && s[i + 1] == '}') {
+            parsed.begin[segment] = start;
+            parsed.length[segment] = i - start;
+            ++segment;
+            start = i + 2;
+            ++i;
+        }
+    }
+    parsed.begin[segment] = start;
+    parsed.length[segment] = i - start;
+    parsed.total = i;
+    return parsed;
+}
+
+// ==================== 线程本地行缓冲 ====================
+
+// 每个线程一块固定大小的缓冲区，超长的行被截断，格式化过程不分配内存
+class LogLineBuffer {
+public:
+    static const size_t kCapacity = 4096;
+
+    static LogLineBuffer& local() {
+        thread_local LogLineBuffer buffer;
+        return buffer;
+    }
+
+    void reset() { length_ = 0; }
+    const char* data() const { return data_; }
+    size_t size() const { return length_; }
+
+    void append(const char* s, size_t n) {
+        size_t avail = kCapacity - length_;
+        if (n > avail) n = avail;
+        std::memcpy(data_ + length_, s, n);
+        length_ += n;
+    }
+
+    void append(const char* s) { append(s, std::strlen(s)); }
+
+    template<typename T>
+    void appendValue(const T& value) {
+        using U = typename std::decay<T>::type;
+        if constexpr (std::is_same<U, bool>::value) {
+            // 与ostream默认行为一致
+            append(value ? "1" : "0", 1);
+        } else if constexpr (std::is_same<U, char>::value || std::is_same<U, signed char>::value ||
+                             std::is_same<U, unsigned char>::value) {
+            char ch = static_cast<char>(value);
+            append(&ch, 1);
+        } else if constexpr (std::is_integral<U>::value) {
+            auto result = std::to_chars(data_ + length_, data_ + kCapacity, value);
+            if (result.ec == std::errc()) {
+                length_ = static_cast<size_t>(result.ptr - data_);
+            }
+        } else if constexpr (std::is_floating_point<U>::value) {
+            char tmp[32];
+            int n = std::snprintf(tmp, sizeof(tmp), "%g", static_cast<double>(value));
+            if (n > 0) append(tmp, static_cast<size_t>(n));
+        } else if constexpr (std::is_array<T>::value &&
+                             std::is_same<typename std::remove_cv<typename std::remove_extent<T>::type>::type,
+                                          char>::value) {
+            // 字符数组（含字符串字面量）不可能为空指针，按数组长度截断以防缺少结尾'\0'
+            append(value, ::strnlen(value, std::extent<T>::value));
+        } else if constexpr (std::is_same<U, const char*>::value || std::is_same<U, char*>::value) {
+            appendCString(value);
+        } else if constexpr (std::is_convertible<const U&, std::string_view>::value) {
+            std::string_view view(value);
+            append(view.data(), view.size());
+        } else if constexpr (std::is_pointer<U>::value) {
+            char tmp[32];
+            int n = std::snprintf(tmp, sizeof(tmp), "%p", static_cast<const void*>(value));
+            if (n > 0) append(tmp, static_cast<size_t>(n));
+        } else {
+            // 其余类型走operator<<
+            std::ostringstream oss;
+            oss << value;
+            const std::string str = oss.str();
+            append(str.data(), str.size());
+        }
+    }
+
+private:
+    LogLineBuffer() : length_(0) {}
+
+    // 经void*比较，避免编译器对数组实参推断nonnull后报-Wnonnull-compare
+    void appendCString(const char* s) {
+        if (static_cast<const void*>(s) != nullptr) append(s);
+    }
+
+    char data_[kCapacity];
+    size_t length_;
+};
+
+// 按编译期解析结果输出；参数少于占位符时原样输出剩余部分，多余参数忽略
+template<size_t I, size_t N>
+void writeFormatted(LogLineBuffer& buf, const char* fmt, const ParsedFormat<N>& parsed) {
+    buf.append(fmt + parsed.begin[I], parsed.total - parsed.begin[I]);
+}
+
+template<size_t I, size_t N, typename T, typename... Rest>
+void writeFormatted(LogLineBuffer& buf, const char* fmt, const ParsedFormat<N>& parsed,
+                    T&& value, Rest&&... rest) {
+    buf.append(fmt + parsed.begin[I], parsed.length[I]);
+    if constexpr (I < N) {
+        buf.appendValue(value);
+        writeFormatted<I + 1, N>(buf, fmt, parsed, std::forward<Rest>(rest)...);
+    }
+}
+
+// 运行期格式串的等价实现，用于非字面量格式串
+inline void writeRuntime(LogLineBuffer& buf, const char* fmt, size_t len) {
+    buf.append(fmt, len);
+}
+
+template<typename T, typename... Rest>
+void writeRuntime(LogLineBuffer& buf, const char* fmt, size_t len, T&& value, Rest&&... rest) {
+    const char* end = fmt + len;
+    for (const char* p = fmt; p + 1 < end; ++p) {
+        if (p[0] == '{' && p[1] == '}') {
+            buf.append(fmt, static_cast<size_t>(p - fmt));
+            buf.appendValue(value);
+            writeRuntime(buf, p + 2, static_cast<size_t>(end - p - 2), std::forward<Rest>(rest)...);
+            return;
+        }
+    }
+    buf.append(fmt, len);
+}
+
+} // namespace log_detail
+} // namespace edge_infra
@@ -6,6 +6,9 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <memory>
+#include "async_logger.h"
+#include "log_format.h"
 
 namespace edge_infra {
 
@@ -20,17 +23,15 @@ class Logger {
 private:
     LogLevel min_level_;
     std::ofstream file_stream_;
+    std::string log_file_;
     bool console_output_;
+    std::unique_ptr<AsyncLogBackend> async_backend_;
     
-    std::string getCurrentTime() {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        return ss.str();
+    const char* getCurrentTime() {
+        return LogTimestamp::now();
     }
     
-    std::string levelToString(LogLevel level) {
+    const char* levelToString(LogLevel level) {
         switch (level) {
             case LogLevel::DEBUG: return "DEBUG";
             case LogLevel::INFO:  return "INFO ";
@@ -45,6 +46,7 @@ public:
         : min_level_(min_level), console_output_(console) {}
     
     ~Logger() {
+        async_backend_.reset();
         if (file_stream_.is_open()) {
             file_stream_.close();
         }
@@ -55,6 +57,10 @@ public:
             file_stream_.close();
         }
         file_stream_.open(filename, std::ios::app);
+        log_file_ = filename;
+        if (async_backend_) {
+            async_backend_->setLogFile(filename);
+        }
     }
     
     void setMinLevel(LogLevel level) {
@@ -63,67 +69,109 @@ public:
     
     void setConsoleOutput(bool enable) {
         console_output_ = enable;
+        if (async_backend_) {
+            async_backend_->setConsoleOutput(enable);
+        }
     }
     
-    template<typename... Args>
-    void log(LogLevel level, const std::string& format, Args... args) {
-        if (level < min_level_) return;
-        
-        std::string message = formatString(format, args...);
-        std::string log_line = "[" + getCurrentTime() + "] [" + 
-                              levelToString(level) + "] " + message;
-        
-        if (console_output_) {
-            std::cout << log_line << std::endl;
+    // 切换到异步模式：写日志只追加到线程本地环形缓冲区，由后台线程批量落盘
+    // 需在其他线程开始写日志之前调用
+    void enableAsync(AsyncLogBackend::Options options = AsyncLogBackend::Options()) {
+        options.console = console_output_;
+        async_backend_.reset(new AsyncLogBackend(options));
+        if (!log_file_.empty()) {
+            async_backend_->setLogFile(log_file_);
         }
-        
-        if (file_stream_.is_open()) {
-            file_stream_ << log_line << std::endl;
+    }
+    
+    bool isAsync() const { return async_backend_ != nullptr; }
+    
+    // 等待已写入的异步日志全部输出
+    void flush() {
+        if (async_backend_) {
+            async_backend_->flush();
+        } else if (file_stream_.is_open()) {
             file_stream_.flush();
         }
     }
     
+    // 异步模式下因缓冲区满被丢弃的行数
+    uint64_t getDroppedLines() const {
+        return async_backend_ ? async_backend_->droppedLines() : 0;
+    }
+    
+    bool shouldLog(LogLevel level) const {
+        return level >= min_level_;
+    }
+    
     template<typename... Args>
-    void debug(const std::string& format, Args... args) {
-        log(LogLevel::DEBUG, format, args...);
+    void log(LogLevel level, const std::string& format, Args&&... args) {
+        if (!shouldLog(level)) return;
+        
+        log_detail::LogLineBuffer& buf = beginLine(level);
+        log_detail::writeRuntime(buf, format.data(), format.size(), std::forward<Args>(args)...);
+        emitLine(buf);
+    }
+    
+    // 格式串在编译期切分，由LOG_*宏调用；Fmt::value()返回格式串字面量
+    template<typename Fmt, typename... Args>
+    void logFormat(LogLevel level, Args&&... args) {
+        constexpr size_t kPlaceholders = log_detail::countPlaceholders(Fmt::value());
+        static constexpr log_detail::ParsedFormat<kPlaceholders> kParsed =
+            log_detail::parseFormat<kPlaceholders>(Fmt::value());
+        
+        log_detail::LogLineBuffer& buf = beginLine(level);
+        log_detail::writeFormatted<0>(buf, Fmt::value(), kParsed, std::forward<Args>(args)...);
+        emitLine(buf);
     }
     
     template<typename... Args>
-    void info(const std::string& format, Args... args) {
-        log(LogLevel::INFO, format, args...);
+    void debug(const std::string& format, Args&&... args) {
+        log(LogLevel::DEBUG, format, std::forward<Args>(args)...);
     }
     
     template<typename... Args>
-    void warn(const std::string& format, Args... args) {
-        log(LogLevel::WARN, format, args...);
+    void info(const std::string& format, Args&&... args) {
+        log(LogLevel::INFO, format, std::forward<Args>(args)...);
     }
     
     template<typename... Args>
-    void error(const std::string& format, Args... args) {
-        log(LogLevel::ERROR, format, args...);
+    void warn(const std::string& format, Args&&... args) {
+        log(LogLevel::WARN, format, std::forward<Args>(args)...);
     }
     
-private:
     template<typename... Args>
-    std::string formatString(const std::string& format, Args... args) {
-        // 简单的字符串格式化实现
-        std::ostringstream oss;
-        formatImpl(oss, format, args...);
-        return oss.str();
+    void error(const std::string& format, Args&&... args) {
+        log(LogLevel::ERROR, format, std::forward<Args>(args)...);
     }
     
-    void formatImpl(std::ostringstream& oss, const std::string& format) {
-        oss << format;
+private:
+    log_detail::LogLineBuffer& beginLine(LogLevel level) {
+        log_detail::LogLineBuffer& buf = log_detail::LogLineBuffer::local();
+        buf.reset();
+        buf.append("[", 1);
+        buf.append(getCurrentTime());
+        buf.append("] [", 3);
+        buf.append(levelToString(level));
+        buf.append("] ", 2);
+        return buf;
     }
     
-    template<typename T, typename... Args>
-    void formatImpl(std::ostringstream& oss, const std::string& format, T&& t, Args... args) {
-        size_t pos = format.find("{}");
-        if (pos != std::string::npos) {
-            oss << format.substr(0, pos) << t;
-            formatImpl(oss, format.substr(pos + 2), args...);
-        } else {
-            oss << format;
+    void emitLine(const log_detail::LogLineBuffer& buf) {
+        if (async_backend_) {
+            async_backend_->append(buf.data(), buf.size());
+            return;
+        }
+        
+        if (console_output_) {
+            std::cout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            std::cout << '\n';
+        }
+        
+        if (file_stream_.is_open()) {
+            file_stream_.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            file_stream_ << '\n';
+            file_stream_.flush();
         }
     }
 };
@@ -131,10 +179,27 @@ private:
 // 全局日志实例
 extern Logger g_logger;
 
-// 便捷宏定义
-#define LOG_DEBUG(...) edge_infra::g_logger.debug(__VA_ARGS__)
-#define LOG_INFO(...) edge_infra::g_logger.info(__VA_ARGS__)
-#define LOG_WARN(...) edge_infra::g_logger.warn(__VA_ARGS__)
-#define LOG_ERROR(...) edge_infra::g_logger.error(__VA_ARGS__)
+// 编译期日志级别下限，低于该级别的LOG_*语句被整体编译掉
+// 例如release构建中 -DEDGE_LOG_MIN_LEVEL=1 去掉所有LOG_DEBUG
+#ifndef EDGE_LOG_MIN_LEVEL
+#define EDGE_LOG_MIN_LEVEL 0
+#endif
+
+// 便捷宏定义：format必须是字符串字面量；级别未开启时不会对参数求值
+#define EDGE_LOG_IMPL(level, format, ...) \
+    do { \
+        if (static_cast<int>(level) >= EDGE_LOG_MIN_LEVEL && \
+            edge_infra::g_logger.shouldLog(level)) { \
+            struct EdgeLogFormat { \
+                static constexpr const char* value() { return format; } \
+            }; \
+            edge_infra::g_logger.logFormat<EdgeLogFormat>(level, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(format, ...) EDGE_LOG_IMPL(edge_infra::LogLevel::DEBUG, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) EDGE_LOG_IMPL(edge_infra::LogLevel::INFO, format, ##__VA_ARGS__)
+#define LOG_WARN(format, ...) EDGE_LOG_IMPL(edge_infra::LogLevel::WARN, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) EDGE_LOG_IMPL(edge_infra::LogLevel::ERROR, format, ##__VA_ARGS__)
 
 } // namespace edge_infra
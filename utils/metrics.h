@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace edge_infra {
+namespace metrics {
+
+constexpr size_t kCacheLineSize = 64;
+constexpr size_t kMetricShards = 16;
+
+// 当前线程使用的分片：线程首次使用时轮转分配，线程数不超过分片数时各线程独占一条缓存行
+inline size_t threadShard() {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+inline uint64_t steadyMicros() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 计数器：各线程累加到自己的分片，读取时汇总。写路径没有跨线程的缓存行争用
+class Counter {
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, kMetricShards> shards_;
+
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    void add(uint64_t n) { shards_[threadShard()].value.fetch_add(n, std::memory_order_relaxed); }
+    void increment() { add(1); }
+
+    uint64_t value() const {
+        uint64_t total = 0;
+        for (const Shard& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void reset() {
+        for (Shard& shard : shards_) shard.value.store(0, std::memory_order_relaxed);
+    }
+};
+
+// 瞬时值（队列深度、连接数等），写入频率低，不分片
+class Gauge {
+private:
+    std::atomic<int64_t> value_{0};
+
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    std::vector<uint64_t> buckets;
+
+    double mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+    // 返回第q分位所在桶的上界（相对误差不超过1/8），无数据时为0
+    uint64_t percentile(double q) const;
+    uint64_t max() const;
+};
+
+// HDR风格的对数-线性直方图：每个2的幂区间再等分8个子桶，覆盖[0, 2^36)，超出的值计入最后一个桶。
+// 单位由使用方约定（本项目统一用微秒）。记录路径只有三次分片内的relaxed加法
+class Histogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr size_t kSubBuckets = 1u << kSubBucketBits;
+    static constexpr int kMaxExponent = 35;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::array<std::atomic<uint64_t>, kBucketCount> buckets;
+    };
+    std::array<Shard, kMetricShards> shards_;
+
+public:
+    Histogram() { reset(); }
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < kSubBuckets) return static_cast<size_t>(value);
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent > kMaxExponent) return kBucketCount - 1;
+        const size_t sub = static_cast<size_t>(value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+        return static_cast<size_t>(exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < kSubBuckets) return index;
+        const int shift = static_cast<int>(index / kSubBuckets) - 1;
+        const uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+        return lower + (1ULL << shift) - 1;
+    }
+
+    void record(uint64_t value) {
+        Shard& shard = shards_[threadShard()];
+        shard.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot snap;
+        snap.buckets.assign(kBucketCount, 0);
+        for (const Shard& shard : shards_) {
+            snap.count += shard.count.load(std::memory_order_relaxed);
+            snap.sum += shard.sum.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                snap.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        return snap;
+    }
+
+    void reset() {
+        for (Shard& shard : shards_) {
+            shard.count.store(0, std::memory_order_relaxed);
+            shard.sum.store(0, std::memory_order_relaxed);
+            for (auto& bucket : shard.buckets) bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+inline uint64_t HistogramSnapshot::percentile(double q) const {
+    uint64_t total = 0;
+    for (uint64_t n : buckets) total += n;
+    if (total == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return Histogram::bucketUpperBound(i);
+    }
+    return Histogram::bucketUpperBound(buckets.size() - 1);
+}
+
+inline uint64_t HistogramSnapshot::max() const {
+    for (size_t i = buckets.size(); i-- > 0;) {
+        if (buckets[i] > 0) return Histogram::bucketUpperBound(i);
+    }
+    return 0;
+}
+
+// 作用域计时，析构时把耗时（微秒）记入直方图；histogram为nullptr时不计时
+class ScopedLatency {
+private:
+    Histogram* histogram_;
+    uint64_t start_us_;
+
+public:
+    explicit ScopedLatency(Histogram* histogram)
+        : histogram_(histogram), start_us_(histogram != nullptr ? steadyMicros() : 0) {}
+    ~ScopedLatency() {
+        if (histogram_ != nullptr) histogram_->record(steadyMicros() - start_us_);
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+};
+
+enum class MetricType {
+    kCounter,
+    kGauge,
+    kHistogram   // 导出为Prometheus summary（分位数 + _sum + _count）
+};
+
+// 生成一个已转义的标签，多个标签用逗号拼接：label("type", "PUB") + "," + label("endpoint", ep)
+inline std::string label(const std::string& key, const std::string& value) {
+    std::string out = key + "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+// 全局指标注册表。counter/gauge/histogram按(名字, 标签)取得或创建，返回的指针永久有效，
+// 调用方应在初始化时取一次并缓存，热路径上不再查表。
+// 对象自带的统计通过registerCallback在导出时取值，对象析构前注销
+class MetricsRegistry {
+private:
+    struct Series {
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> callback;
+        uint64_t handle = 0;
+    };
+
+    struct Family {
+        std::string help;
+        MetricType type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+    uint64_t next_handle_ = 1;
+
+public:
+    static constexpr double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+    // 故意不析构：线程退出较晚时仍可能访问指标
+    static MetricsRegistry& instance() {
+        static MetricsRegistry* registry = new MetricsRegistry();
+        return *registry;
+    }
+
+    Counter* counter(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series& series = findOrAdd(family(name, help, MetricType::kCounter), labels, name);
+        if (!series.counter) series.counter.reset(new Counter());
+        return series.counter.get();
+    }
+
+    Gauge* gauge(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series& series = findOrAdd(family(name, help, MetricType::kGauge), labels, name);
+        if (!series.gauge) series.gauge.reset(new Gauge());
+        return series.gauge.get();
+    }
+
+    Histogram* histogram(const std::string& name, const std::string& help, const std::string& labels = "") {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series& series = findOrAdd(family(name, help, MetricType::kHistogram), labels, name);
+        if (!series.histogram) series.histogram.reset(new Histogram());
+        return series.histogram.get();
+    }
+
+    // type只能是kCounter或kGauge；回调在导出时持锁调用，不能再访问注册表。
+    // 多个同名对象注册相同标签时，后注册的追加instance="<handle>"标签，避免导出重复的序列
+    uint64_t registerCallback(const std::string& name, const std::string& help, MetricType type,
+                              const std::string& labels, std::function<double()> callback) {
+        if (type == MetricType::kHistogram) {
+            throw std::invalid_argument("metrics: callback metric " + name + " cannot be a histogram");
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        Family& fam = family(name, help, type);
+        std::unique_ptr<Series> series(new Series());
+        series->handle = next_handle_++;
+        series->labels = labels;
+        for (const auto& existing : fam.series) {
+            if (existing->labels == labels) {
+                series->labels = joinLabels(labels, label("instance", std::to_string(series->handle)));
+                break;
+            }
+        }
+        series->callback = std::move(callback);
+        fam.series.push_back(std::move(series));
+        return fam.series.back()->handle;
+    }
+
+    void unregisterCallback(uint64_t handle) {
+        if (handle == 0) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = families_.begin(); it != families_.end(); ++it) {
+            auto& series = it->second.series;
+            for (auto s = series.begin(); s != series.end(); ++s) {
+                if ((*s)->handle == handle) {
+                    series.erase(s);
+                    if (series.empty()) families_.erase(it);
+                    return;
+                }
+            }
+        }
+    }
+
+    // Prometheus文本格式（version 0.0.4）
+    std::string exportPrometheus() const {
+        std::string out;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : families_) {
+            const std::string& name = entry.first;
+            const Family& fam = entry.second;
+            out += "# HELP " + name + " " + escapeHelp(fam.help) + "\n";
+            out += "# TYPE " + name + " " + typeName(fam.type) + "\n";
+            for (const auto& series : fam.series) {
+                if (series->histogram) {
+                    const HistogramSnapshot snap = series->histogram->snapshot();
+                    for (double q : kQuantiles) {
+                        char quantile[32];
+                        std::snprintf(quantile, sizeof(quantile), "quantile=\"%g\"", q);
+                        appendSample(&out, name, joinLabels(series->labels, quantile),
+                                     static_cast<double>(snap.percentile(q)));
+                    }
+                    appendSample(&out, name + "_sum", series->labels, static_cast<double>(snap.sum));
+                    appendSample(&out, name + "_count", series->labels, static_cast<double>(snap.count));
+                } else if (series->counter) {
+                    appendSample(&out, name, series->labels, static_cast<double>(series->counter->value()));
+                } else if (series->gauge) {
+                    appendSample(&out, name, series->labels, static_cast<double>(series->gauge->value()));
+                } else if (series->callback) {
+                    appendSample(&out, name, series->labels, series->callback());
+                }
+            }
+        }
+        return out;
+    }
+
+private:
+    MetricsRegistry() = default;
+
+    Family& family(const std::string& name, const std::string& help, MetricType type) {
+        auto it = families_.find(name);
+        if (it == families_.end()) {
+            Family fam;
+            fam.help = help;
+            fam.type = type;
+            it = families_.emplace(name, std::move(fam)).first;
+        } else if (it->second.type != type) {
+            throw std::invalid_argument("metrics: " + name + " already registered with another type");
+        }
+        return it->second;
+    }
+
+    static Series& findOrAdd(Family& fam, const std::string& labels, const std::string& name) {
+        for (auto& series : fam.series) {
+            if (series->labels == labels) {
+                if (series->callback) {
+                    throw std::invalid_argument("metrics: " + name + "{" + labels + "} is a callback metric");
+                }
+                return *series;
+            }
+        }
+        fam.series.emplace_back(new Series());
+        fam.series.back()->labels = labels;
+        return *fam.series.back();
+    }
+
+    static const char* typeName(MetricType type) {
+        switch (type) {
+            case MetricType::kCounter: return "counter";
+            case MetricType::kGauge: return "gauge";
+            case MetricType::kHistogram: return "summary";
+        }
+        return "untyped";
+    }
+
+    static std::string escapeHelp(const std::string& help) {
+        std::string out;
+        for (char c : help) {
+            if (c == '\\') out += "\\\\";
+            else if (c == '\n') out += "\\n";
+            else out += c;
+        }
+        return out;
+    }
+
+    static std::string joinLabels(const std::string& labels, const std::string& extra) {
+        return labels.empty() ? extra : labels + "," + extra;
+    }
+
+    static void appendSample(std::string* out, const std::string& name, const std::string& labels, double value) {
+        *out += name;
+        if (!labels.empty()) {
+            *out += "{" + labels + "}";
+        }
+        char text[32];
+        if (value == std::floor(value) && std::fabs(value) < 9.007199254740992e15) {
+            std::snprintf(text, sizeof(text), " %.0f\n", value);
+        } else {
+            std::snprintf(text, sizeof(text), " %.9g\n", value);
+        }
+        *out += text;
+    }
+};
+
+} // namespace metrics
+} // namespace edge_infra
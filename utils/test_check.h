@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdio>
+
+// 单元测试用的检查宏：与assert不同，不受NDEBUG影响，Release构建下同样执行并报告失败。
+// 失败时打印位置并计数，由main末尾的edge_infra::testing::report()转换为退出码
+namespace edge_infra {
+namespace testing {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline void reportFailure(const char* file, int line, const char* expr) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    ++failureCount();
+}
+
+inline int report(const char* name) {
+    if (failureCount() != 0) {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, failureCount());
+        return 1;
+    }
+    std::printf("%s passed\n", name);
+    return 0;
+}
+
+} // namespace testing
+} // namespace edge_infra
+
+#define EDGE_CHECK(cond) \
+    do { \
+        if (!(cond)) edge_infra::testing::reportFailure(__FILE__, __LINE__, #cond); \
+    } while (0)
+
+// 后续检查依赖该条件成立（如指针非空）时使用，失败后从当前函数返回
+#define EDGE_REQUIRE(cond) \
+    do { \
+        if (!(cond)) { \
+            edge_infra::testing::reportFailure(__FILE__, __LINE__, #cond); \
+            return; \
+        } \
+    } while (0)
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "json_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace edge_infra {
+namespace trace {
+
+// 追踪上下文：只有被采样的追踪才会生成并传播，trace_id为0表示不追踪。
+// span_id只有32位，以便与trace_id一起放进MessageHeader::reserved（12字节）
+struct TraceContext {
+    uint64_t trace_id = 0;
+    uint32_t span_id = 0;
+
+    bool sampled() const { return trace_id != 0; }
+
+    // W3C traceparent格式 "00-<32位十六进制trace>-<16位十六进制span>-01"，高位补零
+    std::string toTraceparent() const {
+        static const char kHex[] = "0123456789abcdef";
+        std::string out = "00-0000000000000000";
+        for (int shift = 60; shift >= 0; shift -= 4) out += kHex[(trace_id >> shift) & 0xF];
+        out += "-00000000";
+        for (int shift = 28; shift >= 0; shift -= 4) out += kHex[(span_id >> shift) & 0xF];
+        out += "-01";
+        return out;
+    }
+
+    // 接受任意合法traceparent，取trace的低64位和span的低32位；未采样或格式错误时返回空上下文
+    static TraceContext fromTraceparent(std::string_view text) {
+        TraceContext ctx;
+        if (text.size() != 55 || text[2] != '-' || text[35] != '-' || text[52] != '-') return ctx;
+        uint64_t trace_id = 0;
+        uint32_t span_id = 0;
+        uint32_t flags = 0;
+        if (!parseHex(text.substr(19, 16), &trace_id) || !parseHex(text.substr(44, 8), &span_id) ||
+            !parseHex(text.substr(53, 2), &flags) || (flags & 1) == 0) {
+            return ctx;
+        }
+        ctx.trace_id = trace_id;
+        ctx.span_id = span_id;
+        return ctx;
+    }
+
+private:
+    template<typename T>
+    static bool parseHex(std::string_view text, T* out) {
+        T value = 0;
+        for (char c : text) {
+            int digit;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else return false;
+            value = static_cast<T>((value << 4) | static_cast<T>(digit));
+        }
+        *out = value;
+        return true;
+    }
+};
+
+struct SpanRecord {
+    static constexpr size_t kMaxName = 47;
+
+    uint64_t trace_id;
+    uint32_t span_id;
+    uint32_t parent_span_id;   // 0表示根span
+    uint64_t start_us;         // system_clock，Unix纪元微秒
+    uint64_t duration_us;
+    uint32_t thread_id;
+    const char* category;      // 必须是静态字符串
+    char name[kMaxName + 1];
+};
+
+// 单线程写入、采集线程读取的span环形缓冲区；满时丢弃新记录
+class SpanBuffer {
+public:
+    static constexpr size_t kCapacity = 1024;
+
+private:
+    std::unique_ptr<SpanRecord[]> records_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> orphaned_{false};   // 所属线程已退出
+
+public:
+    SpanBuffer() : records_(new SpanRecord[kCapacity]) {}
+
+    bool push(const SpanRecord& record) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= kCapacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        records_[head & (kCapacity - 1)] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由一个采集者调用
+    size_t drain(std::vector<SpanRecord>* out) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        for (size_t i = tail; i != head; ++i) {
+            out->push_back(records_[i & (kCapacity - 1)]);
+        }
+        tail_.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    void markOrphaned() { orphaned_.store(true, std::memory_order_release); }
+    bool orphaned() const { return orphaned_.load(std::memory_order_acquire); }
+};
+
+// 追踪入口：采样决策、线程当前上下文、span采集与导出。
+// 默认不采样，未采样路径上的Span只有一次线程本地读取和一次分支
+class Span;
+
+class Tracer {
+private:
+    friend class Span;
+
+    struct Registry {
+        std::mutex mutex;   // 只在线程首次记录span和采集时加锁
+        std::vector<std::shared_ptr<SpanBuffer>> buffers;
+        uint64_t orphan_dropped = 0;
+    };
+
+    struct ThreadState {
+        TraceContext current;
+        std::shared_ptr<SpanBuffer> buffer;
+        std::mt19937_64 rng;
+        uint64_t sample_counter = 0;
+        uint32_t thread_id;
+
+        ThreadState() : thread_id(static_cast<uint32_t>(::syscall(SYS_gettid))) {
+            std::random_device rd;
+            rng.seed((static_cast<uint64_t>(rd()) << 32) ^ rd() ^ thread_id);
+        }
+        ~ThreadState() {
+            if (buffer) buffer->markOrphaned();
+        }
+    };
+
+    static std::atomic<uint32_t>& sampleEvery() {
+        static std::atomic<uint32_t> every{0};
+        return every;
+    }
+
+    // 故意不析构，线程退出较晚时仍可能访问
+    static Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    static ThreadState& threadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+public:
+    // 每n个根请求采样一个（各线程独立计数）；0关闭追踪，1全部采样
+    static void setSampleEvery(uint32_t n) { sampleEvery().store(n, std::memory_order_relaxed); }
+    static uint32_t getSampleEvery() { return sampleEvery().load(std::memory_order_relaxed); }
+
+    // 为新请求做采样决策：采中时返回新的根上下文（span_id为0），否则返回空上下文
+    static TraceContext startTrace() {
+        TraceContext ctx;
+        const uint32_t every = sampleEvery().load(std::memory_order_relaxed);
+        if (every == 0) return ctx;
+        ThreadState& state = threadState();
+        if (state.sample_counter++ % every != 0) return ctx;
+        do {
+            ctx.trace_id = state.rng();
+        } while (ctx.trace_id == 0);
+        return ctx;
+    }
+
+    // 上游已携带上下文时沿用，否则按采样率开始新追踪
+    static TraceContext continueOrStart(const TraceContext& incoming) {
+        return incoming.sampled() ? incoming : startTrace();
+    }
+
+    static TraceContext current() { return threadState().current; }
+
+    static uint32_t newSpanId() {
+        ThreadState& state = threadState();
+        uint32_t id;
+        do {
+            id = static_cast<uint32_t>(state.rng());
+        } while (id == 0);
+        return id;
+    }
+
+    static void record(const SpanRecord& record) {
+        ThreadState& state = threadState();
+        if (!state.buffer) {
+            state.buffer = std::make_shared<SpanBuffer>();
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.buffers.push_back(state.buffer);
+        }
+        state.buffer->push(record);
+    }
+
+    // 取走所有线程已结束的span；已退出线程的缓冲区取空后释放
+    static std::vector<SpanRecord> collect() {
+        std::vector<SpanRecord> out;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto it = reg.buffers.begin(); it != reg.buffers.end();) {
+            // 先确认线程已退出再取，保证取完后不会再有写入
+            const bool orphaned = (*it)->orphaned();
+            (*it)->drain(&out);
+            if (orphaned) {
+                reg.orphan_dropped += (*it)->dropped();
+                it = reg.buffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        std::sort(out.begin(), out.end(), [](const SpanRecord& a, const SpanRecord& b) {
+            return a.start_us < b.start_us;
+        });
+        return out;
+    }
+
+    // 缓冲区满而丢弃的span数
+    static uint64_t droppedSpans() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        uint64_t total = reg.orphan_dropped;
+        for (const auto& buffer : reg.buffers) total += buffer->dropped();
+        return total;
+    }
+
+    // Chrome trace event格式（chrome://tracing、Perfetto可直接打开）
+    static std::string exportChromeTrace(const std::vector<SpanRecord>& spans) {
+        std::string out;
+        JsonWriter<std::string> writer(out);
+        const int pid = static_cast<int>(::getpid());
+        writer.startObject().key("traceEvents").startArray();
+        for (const SpanRecord& span : spans) {
+            writer.startObject()
+                .field("name", span.name)
+                .field("cat", span.category)
+                .field("ph", "X")
+                .field("ts", span.start_us)
+                .field("dur", span.duration_us)
+                .field("pid", pid)
+                .field("tid", span.thread_id);
+            writer.key("args").startObject()
+                .field("trace_id", hex(span.trace_id, 16))
+                .field("span_id", hex(span.span_id, 8))
+                .field("parent_span_id", hex(span.parent_span_id, 8))
+                .endObject();
+            writer.endObject();
+        }
+        writer.endArray().field("displayTimeUnit", "ms").endObject();
+        return out;
+    }
+
+    // OTLP/JSON（ExportTraceServiceRequest），可直接POST到collector的/v1/traces
+    static std::string exportOtlpJson(const std::vector<SpanRecord>& spans, const std::string& service_name) {
+        std::string out;
+        JsonWriter<std::string> writer(out);
+        writer.startObject().key("resourceSpans").startArray().startObject();
+        writer.key("resource").startObject().key("attributes").startArray();
+        writeStringAttribute(writer, "service.name", service_name);
+        writer.endArray().endObject();
+        writer.key("scopeSpans").startArray().startObject();
+        writer.key("scope").startObject().field("name", "edge_infra.trace").endObject();
+        writer.key("spans").startArray();
+        for (const SpanRecord& span : spans) {
+            writer.startObject()
+                .field("traceId", hex(0, 16) + hex(span.trace_id, 16))
+                .field("spanId", hex(0, 8) + hex(span.span_id, 8));
+            if (span.parent_span_id != 0) {
+                writer.field("parentSpanId", hex(0, 8) + hex(span.parent_span_id, 8));
+            }
+            writer.field("name", span.name)
+                .field("kind", 1)
+                .field("startTimeUnixNano", std::to_string(span.start_us * 1000))
+                .field("endTimeUnixNano", std::to_string((span.start_us + span.duration_us) * 1000));
+            writer.key("attributes").startArray();
+            writeStringAttribute(writer, "category", span.category);
+            writer.startObject().field("key", "thread.id")
+                .key("value").startObject().field("intValue", std::to_string(span.thread_id)).endObject()
+                .endObject();
+            writer.endArray();
+            writer.endObject();
+        }
+        writer.endArray().endObject().endArray().endObject().endArray().endObject();
+        return out;
+    }
+
+private:
+    static std::string hex(uint64_t value, int digits) {
+        static const char kHex[] = "0123456789abcdef";
+        std::string out(static_cast<size_t>(digits), '0');
+        for (int i = digits - 1; i >= 0 && value != 0; --i) {
+            out[static_cast<size_t>(i)] = kHex[value & 0xF];
+            value >>= 4;
+        }
+        return out;
+    }
+
+    static void writeStringAttribute(JsonWriter<std::string>& writer, const char* key, const std::string& value) {
+        writer.startObject().field("key", key)
+            .key("value").startObject().field("stringValue", value).endObject()
+            .endObject();
+    }
+};
+
+// 作用域span：构造时成为本线程的当前span，析构时记录并恢复之前的上下文。
+// 未采样（没有父上下文）时什么都不做。name仅在析构时拷贝，需在span结束前保持有效
+class Span {
+private:
+    TraceContext context_;
+    TraceContext previous_;
+    uint32_t parent_span_id_;
+    std::string_view name_;
+    const char* category_;
+    uint64_t start_us_;
+
+public:
+    // 作为当前线程活动span的子span
+    explicit Span(std::string_view name, const char* category = "edge")
+        : Span(name, Tracer::current(), category) {}
+
+    // 以显式（通常来自其他进程/线程的）上下文为父；根上下文由Tracer::startTrace()得到
+    Span(std::string_view name, const TraceContext& parent, const char* category = "edge")
+        : parent_span_id_(0), name_(name), category_(category), start_us_(0) {
+        if (!parent.sampled()) return;
+        Tracer::ThreadState& state = Tracer::threadState();
+        previous_ = state.current;
+        parent_span_id_ = parent.span_id;
+        context_.trace_id = parent.trace_id;
+        context_.span_id = Tracer::newSpanId();
+        state.current = context_;
+        start_us_ = nowMicros();
+    }
+
+    ~Span() {
+        if (!context_.sampled()) return;
+        SpanRecord record;
+        record.trace_id = context_.trace_id;
+        record.span_id = context_.span_id;
+        record.parent_span_id = parent_span_id_;
+        record.start_us = start_us_;
+        record.duration_us = nowMicros() - start_us_;
+        record.category = category_;
+        const size_t len = std::min(name_.size(), SpanRecord::kMaxName);
+        std::memcpy(record.name, name_.data(), len);
+        record.name[len] = '\0';
+        Tracer::ThreadState& state = Tracer::threadState();
+        record.thread_id = state.thread_id;
+        state.current = previous_;
+        Tracer::record(record);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    bool active() const { return context_.sampled(); }
+    // 向下游传播时使用（写入MessageHeader或消息元数据）
+    const TraceContext& context() const { return context_; }
+
+private:
+    static uint64_t nowMicros() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+};
+
+} // namespace trace
+} // namespace edge_infra